@@ -3,7 +3,10 @@
 
 // core-math-lib (cml)
 #include <cml_AABB.h>
+#include <cml_AABBArray.h>
+#include <cml_AABBTree.h>
 #include <cml_AABR.h>
+#include <cml_BVH.h>
 #include <cml_Cone.h>
 #include <cml_ConvexHull.h>
 #include <cml_CoordinateSystem.h>
@@ -12,10 +15,23 @@
 #include <cml_EulerAngles.h>
 #include <cml_Funnel.h>
 #include <cml_HV.h>
+#include <cml_LooseOctree.h>
+#include <cml_MappedFile.h>
+#include <cml_MeshBVH.h>
+#include <cml_MeshCodec.h>
+#include <cml_MeshFile.h>
+#include <cml_MeshSimplifier.h>
 #include <cml_OBB.h>
+#include <cml_parallel.h>
 #include <cml_Plane.h>
+#include <cml_QuantizedBVH.h>
 #include <cml_Ray.h>
+#include <cml_RayPacket.h>
 #include <cml_Rectangle.h>
+#include <cml_RTree.h>
+#include <cml_SpatialHash.h>
 #include <cml_Sphere.h>
+#include <cml_SweepAndPrune.h>
 #include <cml_TriangleMesh.h>
+#include <cml_WideBVH.h>
 #include <poly2tri/poly2tri.h>
\ No newline at end of file
@@ -201,6 +201,14 @@ namespace cml
 
 		bool				intersects(			const Ray&			ray) const;
 
+		/*
+			Branchless slab test that also returns distances along the ray at which it enters and leaves the box.
+			Entry distance is clamped to 0 when the ray starts inside the box.
+		*/
+		bool				intersects(			const Ray&			ray,
+												float&				entryDistance,
+												float&				exitDistance) const;
+
 		bool				intersects(			const Vec3&			point) const;
 
 		bool				intersects(			const AABB&			other) const;
@@ -0,0 +1,175 @@
+#pragma once
+
+
+#include <vector>
+#include <string>
+#include "cml_AABB.h"
+
+
+namespace cml
+{
+	class Ray;
+	class ConvexHull;
+
+
+
+	/*
+		Structure-of-arrays storage of axis aligned boxes(center/half-extent streams).
+
+		Boxes are processed in blocks of LANE_WIDTH, so that batch tests can evaluate
+		the same plane against the whole block at once. Streams are always padded to
+		the multiple of LANE_WIDTH with empty boxes placed at the origin.
+	*/
+	class	AABBArray
+	{
+	public: // constants
+		static constexpr uint32_t LANE_WIDTH = 8;
+
+	public: // subtypes
+		using	Stream	= std::vector<float>;
+		using	Mask	= std::vector<uint8_t>;
+		using	Indices	= std::vector<uint32_t>;
+
+	private: // data
+		Stream		m_centerX;
+		Stream		m_centerY;
+		Stream		m_centerZ;
+		Stream		m_extentX;
+		Stream		m_extentY;
+		Stream		m_extentZ;
+		uint32_t	m_size;
+
+	public: // lifecycle
+		CLASS_CTOR				AABBArray()
+			: m_size(0)
+		{
+
+		}
+
+		CLASS_CTOR				AABBArray(			const AABB*			BOXES,
+													const uint32_t		NUM_BOXES);
+
+	public: // functions
+		inline uint32_t			size() const
+		{
+			return m_size;
+		}
+
+		inline bool				empty() const
+		{
+			return m_size == 0;
+		}
+
+		inline uint32_t			get_numBlocks() const
+		{
+			return static_cast<uint32_t>(m_centerX.size()) / LANE_WIDTH;
+		}
+
+		inline const float*		centers_x() const
+		{
+			return m_centerX.data();
+		}
+
+		inline const float*		centers_y() const
+		{
+			return m_centerY.data();
+		}
+
+		inline const float*		centers_z() const
+		{
+			return m_centerZ.data();
+		}
+
+		inline const float*		extents_x() const
+		{
+			return m_extentX.data();
+		}
+
+		inline const float*		extents_y() const
+		{
+			return m_extentY.data();
+		}
+
+		inline const float*		extents_z() const
+		{
+			return m_extentZ.data();
+		}
+
+		void					reserve(			const uint32_t		NUM_BOXES);
+
+		void					clear();
+
+		void					reset(				const AABB*			BOXES,
+													const uint32_t		NUM_BOXES);
+
+		/*
+			Adds box and returns its index.
+		*/
+		uint32_t				add(				const AABB&			BOX);
+
+		void					set(				const uint32_t		INDEX,
+													const AABB&			BOX);
+
+		AABB					get(				const uint32_t		INDEX) const;
+
+		/*
+			Removes box by moving the last box into its place.
+		*/
+		void					remove_swap(		const uint32_t		INDEX);
+
+	public: // culling
+		/*
+			Writes 1 for each box that intersects the convex hull and 0 otherwise.
+			Output must have room for size() elements. Returns number of intersecting boxes.
+		*/
+		uint32_t				cull(				const ConvexHull&	CONVEX_HULL,
+													uint8_t*			outputMask) const;
+
+		inline uint32_t			cull(				const ConvexHull&	CONVEX_HULL,
+													Mask&				outputMask) const
+		{
+			outputMask.resize(size());
+			return cull(CONVEX_HULL, outputMask.data());
+		}
+
+		/*
+			Appends indices of the boxes that intersect the convex hull.
+			Returns number of appended indices.
+		*/
+		uint32_t				cull(				const ConvexHull&	CONVEX_HULL,
+													Indices&			outputIndices) const;
+
+	public: // ray tests
+		/*
+			Branchless slab test of a single ray against every box.
+			Writes 1 to the output mask for each box hit within [MIN_DISTANCE, MAX_DISTANCE] and 0 otherwise,
+			entry and exit distances are written only if output arrays are given.
+			All output arrays must have room for size() elements. Returns number of boxes hit.
+		*/
+		uint32_t				intersects(			const Ray&			RAY,
+													uint8_t*			outputMask,
+													float*				entryDistances	= nullptr,
+													float*				exitDistances	= nullptr,
+													const float			MIN_DISTANCE	= 0.f,
+													const float			MAX_DISTANCE	= FLOAT_INFINITY) const;
+
+	private: // functions
+		void					resize_streams(		const uint32_t		NUM_BOXES);
+
+		inline void				validate_index(		[[maybe_unused]] const uint32_t INDEX) const
+		{
+#ifdef _DEBUG
+			if(INDEX >= m_size)
+				throw dpl::GeneralException(this, __LINE__, "Invalid box index: " + std::to_string(INDEX));
+#endif // _DEBUG
+		}
+
+		/*
+			Tests one block of boxes against all faces of the convex hull.
+			Lane is set to 1 if box is not completely above any face.
+		*/
+		void					cull_block(			const ConvexHull&	CONVEX_HULL,
+													const uint32_t		BLOCK_ID,
+													uint8_t*			laneMask) const;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,299 @@
+#pragma once
+
+
+#include <vector>
+#include <string>
+#include <type_traits>
+#include "cml_Ray.h"
+#include "cml_AABB.h"
+#include "cml_Sphere.h"
+#include "cml_ConvexHull.h"
+
+
+namespace cml
+{
+	/*
+		Dynamic bounding volume hierarchy of moving objects(incremental BVH).
+
+		Each object is stored in a leaf as a fat AABB, enlarged by the margin and predicted displacement,
+		so that small movements do not require any changes in the tree. Leaves are inserted next to the sibling
+		with the lowest surface area cost and tree is kept balanced with rotations.
+		Queries report objects whose fat AABB overlaps the tested volume.
+
+		https://box2d.org/files/ErinCatto_DynamicBVH_Full.pdf
+	*/
+	class	AABBTree
+	{
+	public: // constants
+		static constexpr uint32_t	NULL_NODE				= 0xFFFFFFFF;
+		static constexpr float		DISPLACEMENT_MULTIPLIER	= 4.f;
+
+	private: // subtypes
+		struct	Node
+		{
+			AABB		box;
+			uint32_t	parent; // Next free node when node is not used.
+			uint32_t	left;
+			uint32_t	right;
+			uint32_t	objectID;
+			int32_t		height; // Leaf = 0, free node = -1.
+
+			inline bool is_leaf() const
+			{
+				return left == NULL_NODE;
+			}
+		};
+
+		static constexpr uint32_t	LOCAL_STACK_SIZE = 64;
+
+	private: // data
+		std::vector<Node>	m_nodes;
+		uint32_t			m_root;
+		uint32_t			m_freeList;
+		uint32_t			m_numLeaves;
+		float				m_margin;
+
+	public: // lifecycle
+		CLASS_CTOR				AABBTree(			const float			FAT_MARGIN = 0.1f);
+
+	public: // functions
+		inline uint32_t			size() const
+		{
+			return m_numLeaves;
+		}
+
+		inline bool				empty() const
+		{
+			return m_numLeaves == 0;
+		}
+
+		inline float			get_margin() const
+		{
+			return m_margin;
+		}
+
+		/*
+			Returns height of the tree(0 when tree has single leaf).
+		*/
+		inline uint32_t			get_height() const
+		{
+			return (m_root != NULL_NODE) ? static_cast<uint32_t>(m_nodes[m_root].height) : 0;
+		}
+
+		inline const AABB&		get_fatAABB(		const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_nodes[PROXY_ID].box;
+		}
+
+		inline uint32_t			get_objectID(		const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_nodes[PROXY_ID].objectID;
+		}
+
+		void					clear();
+
+		/*
+			Adds object to the tree and returns proxy used to move and remove it.
+		*/
+		uint32_t				insert(				const AABB&			BOX,
+													const uint32_t		OBJECT_ID);
+
+		void					remove(				const uint32_t		PROXY_ID);
+
+		/*
+			Updates bounds of the object. Leaf is reinserted only when the box leaves its fat AABB,
+			new fat AABB is then extended in the direction of the displacement.
+			Returns true if leaf was reinserted.
+		*/
+		bool					move(				const uint32_t		PROXY_ID,
+													const AABB&			BOX,
+													const Vec3&			DISPLACEMENT = Vec3(0.f, 0.f, 0.f));
+
+		/*
+			Sum of surface areas of all internal nodes divided by the surface area of the root.
+		*/
+		float					calculate_area_ratio() const;
+
+		/*
+			Checks structure of the tree and throws if it is corrupted.
+		*/
+		void					validate() const;
+
+	public: // queries
+		/*
+			Callback receives object ID and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		inline void				query(				const AABB&			BOX,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const AABB& NODE_BOX){ return NODE_BOX.intersects(BOX); }, callback);
+		}
+
+		template<typename CallbackT>
+		inline void				query(				const Sphere&		SPHERE,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const AABB& NODE_BOX){ return SPHERE.intersects(NODE_BOX); }, callback);
+		}
+
+		template<typename CallbackT>
+		inline void				query(				const ConvexHull&	CONVEX_HULL,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const AABB& NODE_BOX){ return NODE_BOX.intersects(CONVEX_HULL); }, callback);
+		}
+
+		/*
+			Callback receives object ID and distance at which the ray enters its fat AABB.
+			It returns new maximal distance of the ray(e.g. distance to the exact hit),
+			returning 0 stops the query and returning the current maximum continues it unchanged.
+		*/
+		template<typename CallbackT>
+		void					query(				const Ray&			RAY,
+													CallbackT&&			callback,
+													float				maxDistance = FLOAT_INFINITY) const
+		{
+			const Vec3 ORIGIN				= RAY.origin();
+			const Vec3 INVERSE_DIRECTION	= RAY.calculate_inverse_direction();
+
+			// Entry distance of the last tested node, leaf callback is always invoked right after its test.
+			float entryDistance = 0.f;
+
+			traverse([&](const AABB& NODE_BOX)
+			{
+				const Vec3 TO_MIN	= (NODE_BOX.min() - ORIGIN) * INVERSE_DIRECTION;
+				const Vec3 TO_MAX	= (NODE_BOX.max() - ORIGIN) * INVERSE_DIRECTION;
+				const Vec3 NEAR		= glm::min(TO_MIN, TO_MAX);
+				const Vec3 FAR		= glm::max(TO_MIN, TO_MAX);
+
+				entryDistance = glm::max(glm::max(NEAR.x, NEAR.y), glm::max(NEAR.z, 0.f));
+				return entryDistance <= glm::min(glm::min(FAR.x, FAR.y), glm::min(FAR.z, maxDistance));
+			},
+			[&](const uint32_t OBJECT_ID)
+			{
+				maxDistance = callback(OBJECT_ID, entryDistance);
+				return maxDistance > 0.f;
+			});
+		}
+
+		/*
+			Reports every pair of objects with overlapping fat AABBs exactly once.
+			Callback receives both object IDs and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		void					query_pairs(		CallbackT&&			callback) const
+		{
+			bool bContinue = true;
+
+			for(uint32_t proxyID = 0; proxyID < m_nodes.size() && bContinue; ++proxyID)
+			{
+				const Node& LEAF = m_nodes[proxyID];
+				if(LEAF.height != 0)
+					continue;
+
+				traverse([&](const AABB& NODE_BOX){ return NODE_BOX.intersects(LEAF.box); },
+				[&](const uint32_t OBJECT_ID, const AABB&, const uint32_t OTHER_PROXY_ID)
+				{
+					if(OTHER_PROXY_ID <= proxyID) // Each pair is reported by the leaf with the lower proxy ID.
+						return true;
+
+					return bContinue = callback(LEAF.objectID, OBJECT_ID);
+				});
+			}
+		}
+
+	private: // functions
+		inline void				validate_proxy(		[[maybe_unused]] const uint32_t PROXY_ID) const
+		{
+#ifdef _DEBUG
+			if(PROXY_ID >= m_nodes.size() || m_nodes[PROXY_ID].height != 0)
+				throw dpl::GeneralException(this, __LINE__, "Invalid proxy: " + std::to_string(PROXY_ID));
+#endif // _DEBUG
+		}
+
+		uint32_t				allocate_node();
+
+		void					free_node(			const uint32_t		NODE_ID);
+
+		void					insert_leaf(		const uint32_t		LEAF_ID);
+
+		void					remove_leaf(		const uint32_t		LEAF_ID);
+
+		/*
+			Performs left or right rotation if node is imbalanced and returns new root of its subtree.
+		*/
+		uint32_t				balance(			const uint32_t		NODE_ID);
+
+		void					refit_ancestors(	uint32_t			nodeID);
+
+		uint32_t				validate_subtree(	const uint32_t		NODE_ID) const;
+
+		/*
+			Depth first traversal. Subtrees are skipped when their box fails the overlap test.
+			Callback is invoked for every overlapping leaf and returns false to stop the traversal.
+		*/
+		template<typename OverlapTestT, typename CallbackT>
+		void					traverse(			OverlapTestT&&		overlaps,
+													CallbackT&&			callback) const
+		{
+			if(m_root == NULL_NODE)
+				return;
+
+			// Balanced tree never needs more than height + 1 entries.
+			uint32_t				localStack[LOCAL_STACK_SIZE];
+			std::vector<uint32_t>	heapStack;
+			uint32_t*				stack = localStack;
+
+			if(get_height() + 1 > LOCAL_STACK_SIZE)
+			{
+				heapStack.resize(get_height() + 1);
+				stack = heapStack.data();
+			}
+
+			uint32_t stackSize = 0;
+			stack[stackSize++] = m_root;
+
+			while(stackSize > 0)
+			{
+				const uint32_t	NODE_ID = stack[--stackSize];
+				const Node&		NODE	= m_nodes[NODE_ID];
+
+				if(!overlaps(NODE.box))
+					continue;
+
+				if(NODE.is_leaf())
+				{
+					if(!invoke_callback(callback, NODE, NODE_ID))
+						return;
+				}
+				else
+				{
+					stack[stackSize++] = NODE.left;
+					stack[stackSize++] = NODE.right;
+				}
+			}
+		}
+
+		template<typename CallbackT>
+		static inline bool		invoke_callback(	CallbackT&&			callback,
+													const Node&			LEAF,
+													const uint32_t		LEAF_ID)
+		{
+			if constexpr (std::is_invocable_v<CallbackT, uint32_t, const AABB&, uint32_t>)
+			{
+				return callback(LEAF.objectID, LEAF.box, LEAF_ID);
+			}
+			else if constexpr (std::is_invocable_v<CallbackT, uint32_t, const AABB&>)
+			{
+				return callback(LEAF.objectID, LEAF.box);
+			}
+			else
+			{
+				return callback(LEAF.objectID);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,284 @@
+#pragma once
+
+
+#include <vector>
+#include <string>
+#include "cml_Ray.h"
+#include "cml_AABB.h"
+#include "cml_OBB.h"
+#include "cml_Sphere.h"
+#include "cml_ConvexHull.h"
+
+
+namespace cml
+{
+	/*
+		Static bounding volume hierarchy over an array of AABBs.
+
+		Nodes are stored flat in a single array, 32 bytes each(two nodes per cache line).
+		Children of a node are always stored next to each other, so node keeps only the index of the left child.
+		Leaves reference contiguous range of primitive indices.
+
+		https://www.sci.utah.edu/~wald/Publications/2007/ParallelBVHBuild/fastbuild.pdf
+	*/
+	class	BVH
+	{
+	public: // constants
+		static constexpr uint32_t	NUM_BINS				= 16;
+		static constexpr uint32_t	DEFAULT_MAX_LEAF_SIZE	= 4;
+
+	public: // subtypes
+		/*
+			Number of bits of the Morton codes used by the linear builder.
+			63-bit codes separate primitives of large scenes better, but double the cost of sorting.
+		*/
+		enum class MortonPrecision : uint8_t
+		{
+			BITS_30,
+			BITS_63
+		};
+
+		struct alignas(32) Node
+		{
+			Vec3		min;
+			uint32_t	leftFirst;	// Index of the left child or the first primitive index of the leaf.
+			Vec3		max;
+			uint32_t	count;		// Number of primitives in the leaf, 0 for internal nodes.
+
+			inline bool is_leaf() const
+			{
+				return count > 0;
+			}
+
+			inline AABB	get_box() const
+			{
+				return AABB(min, max);
+			}
+		};
+
+		static_assert(sizeof(Node) == 32, "BVH node must fit in 32 bytes.");
+
+	private: // data
+		std::vector<Node>		m_nodes;
+		std::vector<uint32_t>	m_indices;
+
+	public: // lifecycle
+		CLASS_CTOR				BVH() = default;
+
+		CLASS_CTOR				BVH(				const AABB*			BOXES,
+													const uint32_t		NUM_BOXES,
+													const uint32_t		MAX_LEAF_SIZE = DEFAULT_MAX_LEAF_SIZE);
+
+	public: // functions
+		inline bool				empty() const
+		{
+			return m_nodes.empty();
+		}
+
+		inline uint32_t			get_numNodes() const
+		{
+			return static_cast<uint32_t>(m_nodes.size());
+		}
+
+		inline uint32_t			get_numPrimitives() const
+		{
+			return static_cast<uint32_t>(m_indices.size());
+		}
+
+		/*
+			Root is always the first node.
+		*/
+		inline const Node*		nodes() const
+		{
+			return m_nodes.data();
+		}
+
+		/*
+			Primitive indices referenced by the leaves.
+		*/
+		inline const uint32_t*	indices() const
+		{
+			return m_indices.data();
+		}
+
+		void					clear();
+
+		/*
+			Builds hierarchy with binned surface area heuristic.
+			Subtrees are built in parallel.
+		*/
+		void					build(				const AABB*			BOXES,
+													const uint32_t		NUM_BOXES,
+													const uint32_t		MAX_LEAF_SIZE = DEFAULT_MAX_LEAF_SIZE);
+
+		/*
+			Builds linear BVH(LBVH) from primitives sorted along the Morton curve of their centers.
+			Build is much faster than SAH and fully parallel(codes, radix sort and subtrees),
+			but hierarchy is of lower quality, so it is meant for geometry rebuilt every frame.
+		*/
+		void					build_linear(		const AABB*			BOXES,
+													const uint32_t		NUM_BOXES,
+													const MortonPrecision	PRECISION		= MortonPrecision::BITS_30,
+													const uint32_t			MAX_LEAF_SIZE	= 1);
+
+		/*
+			Expected cost of the ray traversal(sum of node areas weighted by the number of primitives in leaves).
+		*/
+		float					calculate_sah_cost() const;
+
+		/*
+			Checks structure of the hierarchy and throws if it is corrupted.
+		*/
+		void					validate() const;
+
+	public: // queries
+		/*
+			Reports every primitive of the leaves that overlap the volume, so callback should test the primitive itself.
+			Callback receives primitive index and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		inline void				query(				const Sphere&		SPHERE,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const Node& NODE){ return SPHERE.intersects(NODE.get_box()); }, callback);
+		}
+
+		template<typename CallbackT>
+		inline void				query(				const OBB&			BOX,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const Node& NODE){ return BOX.intersects(NODE.get_box()); }, callback);
+		}
+
+		template<typename CallbackT>
+		inline void				query(				const ConvexHull&	CONVEX_HULL,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const Node& NODE){ return NODE.get_box().intersects(CONVEX_HULL); }, callback);
+		}
+
+		/*
+			Visits nodes in near to far order.
+			Callback receives primitive index and distance at which the ray enters its leaf.
+			It returns new maximal distance of the ray(e.g. distance to the exact hit),
+			returning 0 stops the query and returning the current maximum continues it unchanged.
+		*/
+		template<typename CallbackT>
+		void					query(				const Ray&			RAY,
+													CallbackT&&			callback,
+													float				maxDistance = FLOAT_INFINITY) const
+		{
+			if(m_nodes.empty())
+				return;
+
+			const Vec3 ORIGIN				= RAY.origin();
+			const Vec3 INVERSE_DIRECTION	= RAY.calculate_inverse_direction();
+
+			// Same slab test as AABB::intersects(ray, entry, exit), limited to the current maximal distance.
+			auto calculate_entry = [&](const Node& NODE)
+			{
+				const Vec3 TO_MIN	= (NODE.min - ORIGIN) * INVERSE_DIRECTION;
+				const Vec3 TO_MAX	= (NODE.max - ORIGIN) * INVERSE_DIRECTION;
+				const Vec3 NEAR		= glm::min(TO_MIN, TO_MAX);
+				const Vec3 FAR		= glm::max(TO_MIN, TO_MAX);
+				const float ENTRY	= glm::max(glm::max(NEAR.x, NEAR.y), glm::max(NEAR.z, 0.f));
+				const float EXIT	= glm::min(glm::min(FAR.x, FAR.y), glm::min(FAR.z, maxDistance));
+
+				return (ENTRY <= EXIT) ? ENTRY : FLOAT_INFINITY;
+			};
+
+			struct Entry
+			{
+				uint32_t	nodeID;
+				float		distance;
+			};
+
+			std::vector<Entry> stack;
+			stack.reserve(64);
+
+			const float ROOT_ENTRY = calculate_entry(m_nodes[0]);
+			if(ROOT_ENTRY == FLOAT_INFINITY)
+				return;
+
+			stack.push_back({0, ROOT_ENTRY});
+
+			while(!stack.empty())
+			{
+				const Entry CURRENT = stack.back();
+				stack.pop_back();
+
+				if(CURRENT.distance > maxDistance)
+					continue; // Closer hit was found after the node was pushed.
+
+				const Node& NODE = m_nodes[CURRENT.nodeID];
+
+				if(NODE.is_leaf())
+				{
+					for(uint32_t i = NODE.leftFirst; i < NODE.leftFirst + NODE.count; ++i)
+					{
+						maxDistance = callback(m_indices[i], CURRENT.distance);
+						if(maxDistance <= 0.f)
+							return;
+					}
+				}
+				else
+				{
+					Entry nearChild	= {NODE.leftFirst,		calculate_entry(m_nodes[NODE.leftFirst])};
+					Entry farChild	= {NODE.leftFirst + 1,	calculate_entry(m_nodes[NODE.leftFirst + 1])};
+
+					if(farChild.distance < nearChild.distance)
+						std::swap(nearChild, farChild);
+
+					if(farChild.distance != FLOAT_INFINITY)
+						stack.push_back(farChild);
+
+					if(nearChild.distance != FLOAT_INFINITY)
+						stack.push_back(nearChild);
+				}
+			}
+		}
+
+	private: // functions
+		/*
+			Depth first traversal. Subtrees are skipped when their node fails the overlap test.
+			Callback is invoked for every primitive of overlapping leaves and returns false to stop the traversal.
+		*/
+		template<typename OverlapTestT, typename CallbackT>
+		void					traverse(			OverlapTestT&&		overlaps,
+													CallbackT&&			callback) const
+		{
+			if(m_nodes.empty())
+				return;
+
+			std::vector<uint32_t> stack;
+			stack.reserve(64);
+			stack.push_back(0);
+
+			while(!stack.empty())
+			{
+				const Node& NODE = m_nodes[stack.back()];
+				stack.pop_back();
+
+				if(!overlaps(NODE))
+					continue;
+
+				if(NODE.is_leaf())
+				{
+					for(uint32_t i = NODE.leftFirst; i < NODE.leftFirst + NODE.count; ++i)
+					{
+						if(!callback(m_indices[i]))
+							return;
+					}
+				}
+				else
+				{
+					stack.push_back(NODE.leftFirst + 1);
+					stack.push_back(NODE.leftFirst);
+				}
+			}
+		}
+
+		uint32_t				validate_subtree(	const uint32_t		NODE_ID,
+													const uint32_t		DEPTH) const;
+	};
+}
\ No newline at end of file
@@ -96,6 +96,8 @@ namespace cml
 		TriangleMesh		to_TriangleMesh(	const uint32_t		SLICES) const;
 
 	public: //  collision tests
+		bool				contains(			const AABB&			aabb) const;
+
 		bool				above(				const Plane&		plane) const;
 
 		bool				below(				const Plane&		plane) const;
@@ -78,6 +78,8 @@ namespace cml
 		}
 
 	public: // intersection functions
+		bool				contains(		const AABB&				aabb) const;
+
 		bool				intersects(		const Vec3&				point) const;
 
 		bool				intersects(		const AABB&				aabb) const;
@@ -0,0 +1,277 @@
+#pragma once
+
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include "cml_AABB.h"
+#include "cml_Sphere.h"
+#include "cml_Cone.h"
+#include "cml_ConvexHull.h"
+
+
+namespace cml
+{
+	/*
+		Sparse loose octree of objects with different sizes.
+
+		Bounds of each node are twice as large as its cell, so object can be stored by the largest of its half-extents
+		at the deepest level whose cells are not smaller than the object and in the cell that contains its center.
+		Both are calculated directly and nodes are found in the hash map by their level and cell,
+		so inserting and moving objects does not descend the tree. Nodes are created on demand and released when empty.
+		Objects with centers outside of the world bounds are stored in the root, which is never culled.
+
+		Queries skip subtrees outside of the volume and report whole subtrees fully inside of it without further tests.
+	*/
+	class	LooseOctree
+	{
+	public: // constants
+		static constexpr uint32_t	NULL_INDEX		= 0xFFFFFFFF;
+		static constexpr uint32_t	MAX_DEPTH_LIMIT = 16;
+		static constexpr float		LOOSENESS		= 2.f;
+
+	private: // subtypes
+		struct	Node
+		{
+			Vec3		center;
+			float		halfSize; // Half size of the cell, loose bounds are LOOSENESS times larger.
+			uint64_t	key;
+			uint32_t	parent; // Next free node when node is not used.
+			uint32_t	children[8];
+			uint32_t	numChildren;
+			uint32_t	head;
+		};
+
+		struct	Object
+		{
+			AABB		box;
+			uint32_t	objectID;
+			uint32_t	node; // NULL_INDEX if object is not used.
+			uint32_t	previous;
+			uint32_t	next; // Next free object when object is not used.
+		};
+
+		struct	StackEntry
+		{
+			uint32_t	node;
+			bool		bInside;
+		};
+
+	private: // data
+		std::vector<Node>						m_nodes;
+		std::vector<Object>						m_objects;
+		std::unordered_map<uint64_t, uint32_t>	m_nodeMap; // Location key -> node.
+		uint32_t								m_freeNodes;
+		uint32_t								m_freeObjects;
+		uint32_t								m_numNodes;
+		uint32_t								m_numObjects;
+		uint32_t								m_maxDepth;
+		Vec3									m_worldMin;
+		float									m_worldHalfSize;
+
+	public: // lifecycle
+		/*
+			World bounds are extended to a cube.
+		*/
+		CLASS_CTOR				LooseOctree(		const AABB&			WORLD,
+													const uint32_t		MAX_DEPTH = 8);
+
+	public: // functions
+		inline uint32_t			size() const
+		{
+			return m_numObjects;
+		}
+
+		inline bool				empty() const
+		{
+			return m_numObjects == 0;
+		}
+
+		inline uint32_t			get_maxDepth() const
+		{
+			return m_maxDepth;
+		}
+
+		inline uint32_t			get_numNodes() const
+		{
+			return m_numNodes;
+		}
+
+		inline const AABB&		get_AABB(			const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_objects[PROXY_ID].box;
+		}
+
+		inline uint32_t			get_objectID(		const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_objects[PROXY_ID].objectID;
+		}
+
+		/*
+			Returns depth of the node that stores given object.
+		*/
+		inline uint32_t			get_depth(			const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return get_depth_from_key(m_nodes[m_objects[PROXY_ID].node].key);
+		}
+
+		void					clear();
+
+		/*
+			Adds object and returns proxy used to move and remove it.
+		*/
+		uint32_t				insert(				const AABB&			BOX,
+													const uint32_t		OBJECT_ID);
+
+		void					remove(				const uint32_t		PROXY_ID);
+
+		/*
+			Updates bounds of the object. Lists are modified only when object changes its node.
+			Returns true if object was moved to another node.
+		*/
+		bool					move(				const uint32_t		PROXY_ID,
+													const AABB&			BOX);
+
+	public: // queries
+		/*
+			Callback receives object ID and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		inline void				query(				const AABB&			BOX,
+													CallbackT&&			callback) const
+		{
+			auto intersects = [&](const AABB& OTHER){ return BOX.intersects(OTHER); };
+			traverse(intersects, [&](const AABB& OTHER){ return BOX.contains(OTHER); }, intersects, callback);
+		}
+
+		template<typename CallbackT>
+		inline void				query(				const Sphere&		SPHERE,
+													CallbackT&&			callback) const
+		{
+			auto intersects = [&](const AABB& OTHER){ return SPHERE.intersects(OTHER); };
+			traverse(intersects, [&](const AABB& OTHER){ return SPHERE.contains(OTHER); }, intersects, callback);
+		}
+
+		/*
+			Frustum query, planes of the convex hull must point outwards.
+		*/
+		template<typename CallbackT>
+		inline void				query(				const ConvexHull&	CONVEX_HULL,
+													CallbackT&&			callback) const
+		{
+			auto intersects = [&](const AABB& OTHER){ return OTHER.intersects(CONVEX_HULL); };
+			traverse(intersects, [&](const AABB& OTHER){ return CONVEX_HULL.contains(OTHER); }, intersects, callback);
+		}
+
+		/*
+			Boxes are tested by their bounding spheres, so objects close to the cone can be reported as well.
+			Bounding sphere of a box inside the node does not have to be inside of the bounding sphere of the node,
+			but it is always inside of that sphere enlarged by sqrt(2).
+		*/
+		template<typename CallbackT>
+		inline void				query(				const Cone&			CONE,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const AABB& NODE_BOX){ return CONE.intersects(Sphere(NODE_BOX.center(), NODE_BOX.range() * 1.4143f)); },
+					 [&](const AABB& NODE_BOX){ return CONE.contains(NODE_BOX); },
+					 [&](const AABB& OBJECT_BOX){ return CONE.intersects(Sphere(OBJECT_BOX)); }, callback);
+		}
+
+	private: // functions
+		inline void				validate_proxy(		[[maybe_unused]] const uint32_t PROXY_ID) const
+		{
+#ifdef _DEBUG
+			if(PROXY_ID >= m_objects.size() || m_objects[PROXY_ID].node == NULL_INDEX)
+				throw dpl::GeneralException(this, __LINE__, "Invalid proxy: " + std::to_string(PROXY_ID));
+#endif // _DEBUG
+		}
+
+		static inline uint64_t	make_key(			const uint32_t		DEPTH,
+													const UVec3&		CELL)
+		{
+			return (static_cast<uint64_t>(DEPTH) << 48) | (static_cast<uint64_t>(CELL.x) << 32) | (static_cast<uint64_t>(CELL.y) << 16) | CELL.z;
+		}
+
+		static inline uint32_t	get_depth_from_key(	const uint64_t		KEY)
+		{
+			return static_cast<uint32_t>(KEY >> 48);
+		}
+
+		inline AABB				calculate_loose_bounds(const Node&		NODE) const
+		{
+			const Vec3 HALF_SIZE(NODE.halfSize * LOOSENESS);
+			return AABB(NODE.center - HALF_SIZE, NODE.center + HALF_SIZE);
+		}
+
+		/*
+			Calls callback for objects that pass the intersection test, subtrees of nodes contained by the volume are reported without tests.
+			Node test must pass for every node whose loose bounds contain an object that passes the object test.
+		*/
+		template<typename IntersectsNodeT, typename ContainsNodeT, typename IntersectsObjectT, typename CallbackT>
+		void					traverse(			IntersectsNodeT&&	intersects_node,
+													ContainsNodeT&&		contains_node,
+													IntersectsObjectT&&	intersects_object,
+													CallbackT&&			callback) const
+		{
+			std::vector<StackEntry> stack;
+			stack.reserve(64);
+			stack.push_back({0, false}); // Root can contain objects outside of the world, so its bounds are not tested.
+
+			while(!stack.empty())
+			{
+				const StackEntry	CURRENT = stack.back();
+				const Node&			NODE	= m_nodes[CURRENT.node];
+				stack.pop_back();
+
+				for(uint32_t objectID = NODE.head; objectID != NULL_INDEX; objectID = m_objects[objectID].next)
+				{
+					const Object& OBJECT = m_objects[objectID];
+
+					if((CURRENT.bInside || intersects_object(OBJECT.box)) && !callback(OBJECT.objectID))
+						return;
+				}
+
+				if(NODE.numChildren == 0)
+					continue;
+
+				for(uint32_t child = 8; child-- > 0;)
+				{
+					const uint32_t CHILD_ID = NODE.children[child];
+					if(CHILD_ID == NULL_INDEX)
+						continue;
+
+					if(CURRENT.bInside)
+					{
+						stack.push_back({CHILD_ID, true});
+						continue;
+					}
+
+					const AABB LOOSE_BOUNDS = calculate_loose_bounds(m_nodes[CHILD_ID]);
+
+					if(intersects_node(LOOSE_BOUNDS))
+						stack.push_back({CHILD_ID, contains_node(LOOSE_BOUNDS)});
+				}
+			}
+		}
+
+		/*
+			Returns key of the node in which object with given bounds should be stored.
+		*/
+		uint64_t				calculate_key(		const AABB&			BOX) const;
+
+		uint32_t				find_or_add_node(	const uint64_t		KEY);
+
+		/*
+			Releases node and its ancestors that have no objects and no children.
+		*/
+		void					release_nodes(		uint32_t			nodeID);
+
+		void					link(				const uint32_t		PROXY_ID,
+													const uint32_t		NODE_ID);
+
+		void					unlink(				const uint32_t		PROXY_ID);
+	};
+}
\ No newline at end of file
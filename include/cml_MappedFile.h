@@ -0,0 +1,69 @@
+#pragma once
+
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <dpl_ClassInfo.h>
+
+
+namespace cml
+{
+	/*
+		Read-only view of the whole file mapped into memory.
+
+		Pages are loaded by the operating system on first access and shared with its file cache,
+		so opening large file costs neither reading nor copying. Mapping is released with the object.
+	*/
+	class	MappedFile
+	{
+	private: // data
+		const uint8_t*	m_data;
+		size_t			m_size;
+#ifdef _WIN32
+		void*			m_file;
+		void*			m_mapping;
+#endif // _WIN32
+
+	public: // lifecycle
+		CLASS_CTOR		MappedFile();
+
+		CLASS_CTOR		MappedFile(			const std::string&	PATH);
+
+		CLASS_CTOR		MappedFile(			MappedFile&&		other) noexcept;
+
+		MappedFile&		operator=(			MappedFile&&		other) noexcept;
+
+		CLASS_CTOR		MappedFile(			const MappedFile&	OTHER) = delete;
+
+		MappedFile&		operator=(			const MappedFile&	OTHER) = delete;
+
+						~MappedFile();
+
+	public: // functions
+		inline bool		is_open() const
+		{
+			return m_data != nullptr;
+		}
+
+		inline const uint8_t* data() const
+		{
+			return m_data;
+		}
+
+		inline size_t	size() const
+		{
+			return m_size;
+		}
+
+		/*
+			Maps the file, previously mapped file is closed. Throws if the file can not be opened or is empty.
+		*/
+		void			open(				const std::string&	PATH);
+
+		void			close();
+
+	private: // functions
+		void			swap(				MappedFile&			other);
+	};
+}
\ No newline at end of file
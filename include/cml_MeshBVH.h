@@ -0,0 +1,101 @@
+#pragma once
+
+
+#include <vector>
+#include <optional>
+#include "cml_BVH.h"
+#include "cml_TriangleMesh.h"
+
+
+namespace cml
+{
+	/*
+		Ray casting acceleration structure of the triangle mesh.
+
+		Triangles are indexed with the SAH BVH and their vertices are copied in the order of its leaves,
+		so that each leaf reads one contiguous block of memory. Node bounds are refitted directly from the vertices,
+		because bounds converted from AABB(center and extents) can be rounded inwards.
+		Rays are tested with watertight ray/triangle intersection, which never misses a hit on the shared edge or vertex
+		of neighbouring triangles.
+		Structure does not track changes of the mesh, it has to be built again when the mesh is modified.
+
+		http://jcgt.org/published/0002/01/05/paper.pdf
+	*/
+	class	MeshBVH
+	{
+	public: // subtypes
+		struct	Hit
+		{
+			uint32_t	triangleID;
+			float		distance;
+			Vec3		barycentric; // Weights of the second, third and first vertex(same order as calculate_barycentric_coordinates).
+		};
+
+	private: // subtypes
+		struct	Triangle
+		{
+			Vec3	a;
+			Vec3	b;
+			Vec3	c;
+		};
+
+		static constexpr uint32_t	LOCAL_STACK_SIZE = 64;
+
+	private: // data
+		std::vector<BVH::Node>	m_nodes;
+		std::vector<uint32_t>	m_triangleIDs;
+		std::vector<Triangle>	m_triangles; // In the order of BVH leaves.
+		uint32_t				m_depth;
+
+	public: // lifecycle
+		CLASS_CTOR				MeshBVH()
+			: m_depth(0)
+		{
+
+		}
+
+		CLASS_CTOR				MeshBVH(			const TriangleMesh&	MESH,
+													const uint32_t		MAX_LEAF_SIZE = BVH::DEFAULT_MAX_LEAF_SIZE);
+
+	public: // functions
+		inline bool				empty() const
+		{
+			return m_triangles.empty();
+		}
+
+		inline uint32_t			get_numTriangles() const
+		{
+			return static_cast<uint32_t>(m_triangles.size());
+		}
+
+		inline uint32_t			get_numNodes() const
+		{
+			return static_cast<uint32_t>(m_nodes.size());
+		}
+
+		void					clear();
+
+		void					build(				const TriangleMesh&	MESH,
+													const uint32_t		MAX_LEAF_SIZE = BVH::DEFAULT_MAX_LEAF_SIZE);
+
+	public: // queries
+		/*
+			Returns the nearest hit closer than maximal distance. Both sides of triangles are hit.
+		*/
+		std::optional<Hit>		find_closest_hit(	const Ray&			RAY,
+													const float			MAX_DISTANCE = FLOAT_INFINITY) const;
+
+		/*
+			Returns true if ray hits any triangle closer than maximal distance(e.g. shadow or visibility test).
+			Traversal stops at the first hit found.
+		*/
+		bool					intersects(			const Ray&			RAY,
+													const float			MAX_DISTANCE = FLOAT_INFINITY) const;
+
+	private: // functions
+		bool					traverse(			const Ray&			RAY,
+													const float			MAX_DISTANCE,
+													const bool			bANY_HIT,
+													Hit&				hit) const;
+	};
+}
\ No newline at end of file
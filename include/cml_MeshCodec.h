@@ -0,0 +1,128 @@
+#pragma once
+
+
+#include <vector>
+#include "cml_AABB.h"
+#include "cml_TriangleMesh.h"
+
+
+namespace cml
+{
+	/*
+		Compressed encoding of the triangle mesh.
+
+		Positions are quantized relative to the bounds of the mesh into 16-bit integers(6 bytes per vertex instead of 12)
+		and stored as structure-of-arrays in chunks of VERTEX_CHUNK_SIZE vertices, so that decoding is a branchless loop over lanes.
+		Indices are stored as zigzag encoded differences to the previous index in variable length bytes(LEB128),
+		which takes 1 byte for most indices of meshes optimized for vertex cache and fetch.
+		Data is stored in the native(little-endian) layout.
+	*/
+	class	MeshCodec
+	{
+	public: // constants
+		static constexpr uint32_t	MAGIC				= 0x434C4D43; // "CMLC"
+		static constexpr uint32_t	VERSION				= 1;
+		static constexpr uint32_t	VERTEX_CHUNK_SIZE	= 256;
+		static constexpr uint32_t	MAX_POSITION_BITS	= 16;
+
+	public: // subtypes
+		struct	Header
+		{
+			uint32_t	magic;
+			uint32_t	version;
+			uint32_t	numVertices;
+			uint32_t	numIndices;
+			uint32_t	positionBits;
+			uint32_t	reserved;
+			float		boundsMin[3];
+			float		step[3];		// Size of the quantization step along each axis.
+			uint64_t	indexOffset;	// Start of the index stream.
+			uint64_t	size;			// Size of the whole encoding.
+		};
+
+		static_assert(sizeof(Header) == 64, "Layout of the mesh encoding header must not change.");
+
+	public: // functions
+		/*
+			Positions are rounded to the grid of 2^POSITION_BITS-1 steps along each axis of the bounds,
+			so that error along the axis is at most half of the step. Fewer bits leave upper bits empty for general purpose compression.
+		*/
+		static std::vector<uint8_t> encode(		const TriangleMesh&		MESH,
+												const uint32_t			POSITION_BITS = MAX_POSITION_BITS);
+
+		/*
+			Replaces content of the mesh with the decoded mesh, mesh is not changed when data is invalid.
+		*/
+		static void				decode(			const uint8_t*			DATA,
+												const size_t			SIZE,
+												TriangleMesh&			output);
+	};
+
+
+	/*
+		Streaming decoder of the mesh encoding, vertices and indices are decoded independently in batches of any size
+		into buffers provided by the caller. Decoder does not own the data, so it must outlive the decoder.
+	*/
+	class	MeshDecoder
+	{
+	private: // data
+		const uint8_t*				m_data;
+		const MeshCodec::Header*	m_header;
+		uint64_t					m_indexPosition;
+		uint32_t					m_numDecodedVertices;
+		uint32_t					m_numDecodedIndices;
+		uint32_t					m_previousIndex;
+
+	public: // lifecycle
+		CLASS_CTOR				MeshDecoder(		const uint8_t*		DATA,
+													const size_t		SIZE);
+
+	public: // functions
+		inline uint32_t			get_numVertices() const
+		{
+			return m_header->numVertices;
+		}
+
+		inline uint32_t			get_numIndices() const
+		{
+			return m_header->numIndices;
+		}
+
+		inline uint32_t			get_numRemainingVertices() const
+		{
+			return m_header->numVertices - m_numDecodedVertices;
+		}
+
+		inline uint32_t			get_numRemainingIndices() const
+		{
+			return m_header->numIndices - m_numDecodedIndices;
+		}
+
+		/*
+			Bounds used for quantization.
+		*/
+		inline AABB				get_box() const
+		{
+			const Vec3 MIN(m_header->boundsMin[0], m_header->boundsMin[1], m_header->boundsMin[2]);
+			const Vec3 STEP(m_header->step[0], m_header->step[1], m_header->step[2]);
+			return AABB(MIN, MIN + STEP * static_cast<float>((1u << m_header->positionBits) - 1));
+		}
+
+		/*
+			Restarts decoding from the first vertex and index.
+		*/
+		void					reset();
+
+		/*
+			Decodes next vertices and returns their number(less than MAX_VERTICES only at the end).
+		*/
+		uint32_t				decode_vertices(	Vec3*				output,
+													const uint32_t		MAX_VERTICES);
+
+		/*
+			Decodes next indices and returns their number(less than MAX_INDICES only at the end).
+		*/
+		uint32_t				decode_indices(		uint32_t*			output,
+													const uint32_t		MAX_INDICES);
+	};
+}
\ No newline at end of file
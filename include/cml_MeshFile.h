@@ -0,0 +1,157 @@
+#pragma once
+
+
+#include <string>
+#include "cml_BVH.h"
+#include "cml_TriangleMesh.h"
+
+
+namespace cml
+{
+	/*
+		Binary container of the triangle mesh that can be used directly from memory(e.g. mapped file) without parsing.
+
+		File starts with the header followed by blocks of vertices, indices and optional normals and BVH,
+		each block starts at the multiple of BLOCK_ALIGNMENT bytes, so that arrays can be read in place.
+		Data is stored in the native(little-endian) layout of the types. Bounds of the vertices are always stored in the header.
+	*/
+	class	MeshFile
+	{
+	public: // constants
+		static constexpr uint32_t	MAGIC			= 0x4D4C4D43; // "CMLM"
+		static constexpr uint32_t	VERSION			= 1;
+		static constexpr uint64_t	BLOCK_ALIGNMENT	= 64;
+
+		static constexpr uint32_t	HAS_NORMALS		= 1 << 0;
+		static constexpr uint32_t	HAS_BVH			= 1 << 1;
+
+	public: // subtypes
+		struct	Header
+		{
+			uint32_t	magic;
+			uint32_t	version;
+			uint32_t	flags;
+			uint32_t	numVertices;
+			uint32_t	numIndices;
+			uint32_t	numBVHNodes;
+			uint32_t	numBVHIndices;
+			uint32_t	reserved;
+			uint64_t	fileSize;
+			uint64_t	vertexOffset;
+			uint64_t	indexOffset;
+			uint64_t	normalOffset;	// 0 if there are no normals.
+			uint64_t	bvhNodeOffset;	// 0 if there is no BVH.
+			uint64_t	bvhIndexOffset;	// 0 if there is no BVH.
+			float		boundsMin[3];
+			float		boundsMax[3];
+		};
+
+		static_assert(sizeof(Header) == 104, "Layout of the mesh file header must not change.");
+
+	public: // functions
+		/*
+			Normals must have one entry per vertex. BVH is stored as it is, so it should be built over triangles of the mesh.
+		*/
+		static void		write(				const std::string&		PATH,
+											const TriangleMesh&		MESH,
+											const Vec3*				NORMALS		= nullptr,
+											const BVH*				HIERARCHY	= nullptr);
+	};
+
+
+	/*
+		Read-only mesh stored in the memory of the mesh file, its arrays point straight into the given buffer.
+		Constructor checks the header and bounds of all blocks, but does not read the blocks(indices are not validated).
+		View does not own the memory, so the buffer must outlive it.
+	*/
+	class	MeshView
+	{
+	private: // data
+		const MeshFile::Header*	m_header;
+		const Vec3*				m_vertices;
+		const uint32_t*			m_indices;
+		const Vec3*				m_normals;
+		const BVH::Node*		m_bvhNodes;
+		const uint32_t*			m_bvhIndices;
+
+	public: // lifecycle
+		CLASS_CTOR				MeshView(			const void*			DATA,
+													const size_t		SIZE);
+
+	public: // functions
+		inline uint32_t			get_numVertices() const
+		{
+			return m_header->numVertices;
+		}
+
+		inline uint32_t			get_numIndices() const
+		{
+			return m_header->numIndices;
+		}
+
+		inline uint32_t			get_numTriangles() const
+		{
+			return m_header->numIndices / 3;
+		}
+
+		inline const Vec3*		vertices() const
+		{
+			return m_vertices;
+		}
+
+		inline const uint32_t*	indices() const
+		{
+			return m_indices;
+		}
+
+		inline bool				has_normals() const
+		{
+			return m_normals != nullptr;
+		}
+
+		/*
+			Returns nullptr if the file has no normals.
+		*/
+		inline const Vec3*		normals() const
+		{
+			return m_normals;
+		}
+
+		inline bool				has_bvh() const
+		{
+			return m_bvhNodes != nullptr;
+		}
+
+		inline uint32_t			get_numBVHNodes() const
+		{
+			return m_header->numBVHNodes;
+		}
+
+		/*
+			Nodes in the layout of BVH::nodes(), root is the first node. Returns nullptr if the file has no BVH.
+		*/
+		inline const BVH::Node*	bvhNodes() const
+		{
+			return m_bvhNodes;
+		}
+
+		/*
+			Triangle indices referenced by the BVH leaves.
+		*/
+		inline const uint32_t*	bvhIndices() const
+		{
+			return m_bvhIndices;
+		}
+
+		inline AABB				get_box() const
+		{
+			return AABB(Vec3(m_header->boundsMin[0], m_header->boundsMin[1], m_header->boundsMin[2]),
+						Vec3(m_header->boundsMax[0], m_header->boundsMax[1], m_header->boundsMax[2]));
+		}
+
+		/*
+			Copies vertices and indices to the mesh that can be modified.
+		*/
+		void					copy_to(			TriangleMesh&		output) const;
+	};
+}
\ No newline at end of file
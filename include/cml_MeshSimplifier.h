@@ -0,0 +1,154 @@
+#pragma once
+
+
+#include <vector>
+#include "cml_TriangleMesh.h"
+
+
+namespace cml
+{
+	/*
+		Decimates triangle mesh by collapsing edges in order of increasing quadric error.
+
+		Each vertex accumulates quadrics of the planes of its triangles weighted by their area, collapsed edge is replaced
+		with the point that minimizes the sum of quadrics of both vertices. Collapses are kept in binary heap and invalidated lazily
+		with vertex versions, so that simplification runs in O(n log n). Heap is purged from invalid collapses when it grows
+		several times larger than the number of edges, which keeps memory proportional to the size of the mesh.
+		Vertices of border and non-manifold edges never move and are never removed, so that neighbouring tiles still match
+		after simplification. Collapses that would flip triangle or make the mesh non-manifold are rejected.
+		Input mesh should be welded, otherwise duplicated vertices form borders and are locked.
+
+		Simplification is progressive, so LODs with decreasing triangle budgets are extracted from one pass.
+
+		https://www.cs.cmu.edu/~garland/Papers/quadrics.pdf
+	*/
+	class	MeshSimplifier
+	{
+	public: // constants
+		static constexpr uint32_t	NULL_INDEX = 0xFFFFFFFF;
+
+	private: // subtypes
+		/*
+			Symmetric 4x4 matrix of the plane quadric and sum of the weights of its planes.
+		*/
+		struct	Quadric
+		{
+			double	a2, ab, ac, ad;
+			double	b2, bc, bd;
+			double	c2, cd;
+			double	d2;
+			double	weight;
+
+			Quadric&	operator+=(	const Quadric&		OTHER);
+
+			double		evaluate(	const Vec3&			POINT) const;
+
+			/*
+				Returns false when the quadric is singular(e.g. all planes are parallel).
+			*/
+			bool		minimize(	Vec3&				output) const;
+		};
+
+		struct	Collapse
+		{
+			float		error;
+			uint32_t	kept;
+			uint32_t	removed;
+			uint32_t	keptVersion;
+			uint32_t	removedVersion;
+			Vec3		target;
+		};
+
+	private: // data
+		std::vector<Vec3>					m_vertices;
+		std::vector<Quadric>				m_quadrics;
+		std::vector<uint32_t>				m_versions;
+		std::vector<uint8_t>				m_locked;
+		std::vector<uint8_t>				m_removed;
+		std::vector<uint8_t>				m_rejected; // Vertices of collapses rejected by can_collapse.
+		std::vector<std::vector<uint32_t>>	m_vertexTriangles; // May contain removed triangles.
+		std::vector<uint32_t>				m_indices;
+		std::vector<uint8_t>				m_collapsed; // Triangles removed by collapses.
+		std::vector<Collapse>				m_heap;
+		std::vector<uint32_t>				m_keptNeighbours; // Scratch buffers.
+		std::vector<uint32_t>				m_removedNeighbours;
+		uint32_t							m_numTriangles;
+		float								m_error;
+
+	public: // lifecycle
+		CLASS_CTOR				MeshSimplifier(		const TriangleMesh&				MESH);
+
+	public: // functions
+		inline uint32_t			get_numTriangles() const
+		{
+			return m_numTriangles;
+		}
+
+		/*
+			Largest error of the performed collapses, which is the root mean square distance to the planes of merged triangles.
+		*/
+		inline float			get_error() const
+		{
+			return m_error;
+		}
+
+		/*
+			Collapses edges until the mesh has at most TARGET_NUM_TRIANGLES triangles or the next collapse would exceed MAX_ERROR.
+			Returns true when the target was reached.
+		*/
+		bool					simplify(			const uint32_t					TARGET_NUM_TRIANGLES,
+													const float						MAX_ERROR = FLOAT_INFINITY);
+
+		/*
+			Writes current state of the mesh to the output, unused vertices are skipped.
+		*/
+		void					extract(			TriangleMesh&					output) const;
+
+		/*
+			Simplifies the mesh to each triangle budget, budgets are processed from the largest one in a single pass.
+			Output LODs are in the order of given budgets.
+		*/
+		static std::vector<TriangleMesh> generate_lodChain(const TriangleMesh&		MESH,
+													const std::vector<uint32_t>&	TRIANGLE_BUDGETS);
+
+	private: // functions
+		static inline bool		compare(			const Collapse&					A,
+													const Collapse&					B)
+		{
+			return A.error > B.error; // Smallest error on top of the heap.
+		}
+
+		inline bool				is_valid(			const Collapse&					COLLAPSE) const
+		{
+			return !m_removed[COLLAPSE.kept] && !m_removed[COLLAPSE.removed]
+				&& m_versions[COLLAPSE.kept] == COLLAPSE.keptVersion && m_versions[COLLAPSE.removed] == COLLAPSE.removedVersion;
+		}
+
+		inline bool				is_collapsed(		const uint32_t					TRIANGLE_ID) const
+		{
+			return m_collapsed[TRIANGLE_ID] != 0;
+		}
+
+		void					push_collapse(		const uint32_t					VERTEX_A,
+													const uint32_t					VERTEX_B);
+
+		void					purge_heap();
+
+		/*
+			Collects sorted vertices connected with the vertex by the triangle edge and removes collapsed triangles from its list.
+		*/
+		void					collect_neighbours(	const uint32_t					VERTEX_ID,
+													std::vector<uint32_t>&			output);
+
+		bool					can_collapse(		const Collapse&					COLLAPSE);
+
+		/*
+			Returns true when no triangle around the vertex(except the ones shared with the other vertex) flips after moving it.
+		*/
+		bool					preserves_orientation(const uint32_t				VERTEX_ID,
+													const uint32_t					OTHER_ID,
+													const Vec3&						TARGET) const;
+
+		void					collapse(			const Collapse&					COLLAPSE);
+	};
+}
\ No newline at end of file
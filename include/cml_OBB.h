@@ -74,6 +74,15 @@ namespace cml
 
 		bool			intersects(			const OBB&				OTHER) const;
 
+		/*
+			Tests this OBB against each of the given OBBs.
+			Writes 1 to the output mask for every intersecting OBB and 0 otherwise.
+			Returns number of intersections.
+		*/
+		uint32_t		intersects(			const OBB*				OTHERS,
+											const uint32_t			NUM_OTHERS,
+											uint8_t*				outputMask) const;
+
 		bool			intersects(			const Sphere&			sphere) const;
 
 		bool			intersects(			const Cone&				cone) const;
@@ -86,10 +95,5 @@ namespace cml
 		void			extend(				const Vec3&				POINT);
 
 		void			extend(				const OBB&				OTHER);
-
-	private: // tests
-		bool			is_separation_axis(	const OBB&				OTHER,
-											const Vec3&				TO_OTHER,
-											const Vec3&				AXIS) const;
 	};
 }
\ No newline at end of file
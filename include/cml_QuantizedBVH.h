@@ -0,0 +1,314 @@
+#pragma once
+
+
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include "cml_BVH.h"
+
+
+namespace cml
+{
+	/*
+		Compressed binary bounding volume hierarchy converted from the BVH.
+
+		Node stores bounds of both children as QuantT offsets(8 or 16 bits) relative to its own bounds,
+		which are decoded during traversal from the root down. Encoding rounds minimum down and maximum up
+		and is verified against decoding, so decoded box always encloses the original one and queries stay correct.
+		Children are referenced with 32 bits, leaf references pack the first primitive index(27 bits)
+		and the number of primitives(4 bits) together with the leaf flag.
+
+		With 8-bit offsets node takes 20 bytes instead of 64 bytes of two BVH nodes.
+	*/
+	template<typename QuantT>
+	class	QuantizedBVH
+	{
+	public: // constants
+		static constexpr uint32_t	MAX_QUANTIZED	= std::numeric_limits<QuantT>::max();
+		static constexpr uint32_t	LEAF_FLAG		= 0x80000000;
+		static constexpr uint32_t	COUNT_SHIFT		= 27;
+		static constexpr uint32_t	MAX_FIRST		= (1u << COUNT_SHIFT) - 1;
+		static constexpr uint32_t	MAX_LEAF_SIZE	= 16;
+
+		static_assert(std::is_same_v<QuantT, uint8_t> || std::is_same_v<QuantT, uint16_t>, "Quantized BVH supports only 8 and 16 bit offsets.");
+
+	public: // subtypes
+		struct	Node
+		{
+			QuantT		childMin[2][3];
+			QuantT		childMax[2][3];
+			uint32_t	children[2]; // Node index or leaf reference.
+		};
+
+		/*
+			Bounds of the node decoded from its parent.
+		*/
+		struct	Bounds
+		{
+			Vec3	min;
+			Vec3	max;
+		};
+
+	private: // subtypes
+		struct	StackEntry
+		{
+			Bounds		bounds;
+			uint32_t	reference;
+			float		distance;
+		};
+
+	private: // data
+		std::vector<Node>		m_nodes;
+		std::vector<uint32_t>	m_indices;
+		Bounds					m_rootBounds;
+		uint32_t				m_root;
+
+	public: // lifecycle
+		CLASS_CTOR				QuantizedBVH()
+			: m_rootBounds({Vec3(0.f, 0.f, 0.f), Vec3(0.f, 0.f, 0.f)})
+			, m_root(0)
+		{
+
+		}
+
+		CLASS_CTOR				QuantizedBVH(		const BVH&			BINARY)
+			: QuantizedBVH()
+		{
+			build(BINARY);
+		}
+
+	public: // functions
+		inline bool				empty() const
+		{
+			return m_indices.empty();
+		}
+
+		inline uint32_t			get_numNodes() const
+		{
+			return static_cast<uint32_t>(m_nodes.size());
+		}
+
+		inline uint32_t			get_numPrimitives() const
+		{
+			return static_cast<uint32_t>(m_indices.size());
+		}
+
+		/*
+			Returns number of bytes used by nodes and primitive indices.
+		*/
+		inline size_t			calculate_memory_size() const
+		{
+			return m_nodes.size() * sizeof(Node) + m_indices.size() * sizeof(uint32_t);
+		}
+
+		static inline bool		is_leaf(			const uint32_t		REFERENCE)
+		{
+			return (REFERENCE & LEAF_FLAG) != 0;
+		}
+
+		static inline uint32_t	get_first(			const uint32_t		LEAF_REFERENCE)
+		{
+			return LEAF_REFERENCE & MAX_FIRST;
+		}
+
+		static inline uint32_t	get_count(			const uint32_t		LEAF_REFERENCE)
+		{
+			return ((LEAF_REFERENCE & ~LEAF_FLAG) >> COUNT_SHIFT) + 1;
+		}
+
+		/*
+			Decodes bounds of the child relative to the bounds of its parent.
+		*/
+		static inline Bounds	decode(				const Node&			NODE,
+													const uint32_t		CHILD,
+													const Bounds&		PARENT)
+		{
+			const Vec3 SCALE = calculate_scale(PARENT);
+
+			return {PARENT.min + Vec3(NODE.childMin[CHILD][0], NODE.childMin[CHILD][1], NODE.childMin[CHILD][2]) * SCALE,
+					PARENT.min + Vec3(NODE.childMax[CHILD][0], NODE.childMax[CHILD][1], NODE.childMax[CHILD][2]) * SCALE};
+		}
+
+		void					clear();
+
+		/*
+			Leaves of the source hierarchy can not have more than MAX_LEAF_SIZE primitives.
+		*/
+		void					build(				const BVH&			BINARY);
+
+	public: // queries
+		/*
+			Reports every primitive of the leaves that overlap the volume, so callback should test the primitive itself.
+			Callback receives primitive index and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		inline void				query(				const Sphere&		SPHERE,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const Bounds& BOUNDS){ return SPHERE.intersects(AABB(BOUNDS.min, BOUNDS.max)); }, callback);
+		}
+
+		template<typename CallbackT>
+		inline void				query(				const OBB&			BOX,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const Bounds& BOUNDS){ return BOX.intersects(AABB(BOUNDS.min, BOUNDS.max)); }, callback);
+		}
+
+		template<typename CallbackT>
+		inline void				query(				const ConvexHull&	CONVEX_HULL,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const Bounds& BOUNDS){ return AABB(BOUNDS.min, BOUNDS.max).intersects(CONVEX_HULL); }, callback);
+		}
+
+		/*
+			Visits nodes in near to far order.
+			Callback receives primitive index and distance at which the ray enters its leaf.
+			It returns new maximal distance of the ray(e.g. distance to the exact hit),
+			returning 0 stops the query and returning the current maximum continues it unchanged.
+		*/
+		template<typename CallbackT>
+		void					query(				const Ray&			RAY,
+													CallbackT&&			callback,
+													float				maxDistance = FLOAT_INFINITY) const
+		{
+			if(empty())
+				return;
+
+			const Vec3 ORIGIN				= RAY.origin();
+			const Vec3 INVERSE_DIRECTION	= RAY.calculate_inverse_direction();
+
+			// Same slab test as AABB::intersects(ray, entry, exit), limited to the current maximal distance.
+			auto calculate_entry = [&](const Bounds& BOUNDS)
+			{
+				const Vec3 TO_MIN	= (BOUNDS.min - ORIGIN) * INVERSE_DIRECTION;
+				const Vec3 TO_MAX	= (BOUNDS.max - ORIGIN) * INVERSE_DIRECTION;
+				const Vec3 NEAR		= glm::min(TO_MIN, TO_MAX);
+				const Vec3 FAR		= glm::max(TO_MIN, TO_MAX);
+				const float ENTRY	= glm::max(glm::max(NEAR.x, NEAR.y), glm::max(NEAR.z, 0.f));
+				const float EXIT	= glm::min(glm::min(FAR.x, FAR.y), glm::min(FAR.z, maxDistance));
+
+				return (ENTRY <= EXIT) ? ENTRY : FLOAT_INFINITY;
+			};
+
+			const float ROOT_ENTRY = calculate_entry(m_rootBounds);
+			if(ROOT_ENTRY == FLOAT_INFINITY)
+				return;
+
+			std::vector<StackEntry> stack;
+			stack.reserve(64);
+			stack.push_back({m_rootBounds, m_root, ROOT_ENTRY});
+
+			while(!stack.empty())
+			{
+				const StackEntry CURRENT = stack.back();
+				stack.pop_back();
+
+				if(CURRENT.distance > maxDistance)
+					continue; // Closer hit was found after the entry was pushed.
+
+				if(is_leaf(CURRENT.reference))
+				{
+					const uint32_t FIRST = get_first(CURRENT.reference);
+					const uint32_t COUNT = get_count(CURRENT.reference);
+
+					for(uint32_t i = FIRST; i < FIRST + COUNT; ++i)
+					{
+						maxDistance = callback(m_indices[i], CURRENT.distance);
+						if(maxDistance <= 0.f)
+							return;
+					}
+
+					continue;
+				}
+
+				const Node& NODE = m_nodes[CURRENT.reference];
+
+				StackEntry nearChild;
+				nearChild.bounds	= decode(NODE, 0, CURRENT.bounds);
+				nearChild.reference	= NODE.children[0];
+				nearChild.distance	= calculate_entry(nearChild.bounds);
+
+				StackEntry farChild;
+				farChild.bounds		= decode(NODE, 1, CURRENT.bounds);
+				farChild.reference	= NODE.children[1];
+				farChild.distance	= calculate_entry(farChild.bounds);
+
+				if(farChild.distance < nearChild.distance)
+					std::swap(nearChild, farChild);
+
+				if(farChild.distance != FLOAT_INFINITY)
+					stack.push_back(farChild);
+
+				if(nearChild.distance != FLOAT_INFINITY)
+					stack.push_back(nearChild);
+			}
+		}
+
+	private: // functions
+		/*
+			Slightly enlarged step guarantees that the largest offset reaches the maximum of the parent.
+		*/
+		static inline Vec3		calculate_scale(	const Bounds&		PARENT)
+		{
+			return (PARENT.max - PARENT.min) * ((1.f + 0.000002f) / MAX_QUANTIZED);
+		}
+
+		template<typename OverlapTestT, typename CallbackT>
+		void					traverse(			OverlapTestT&&		overlaps,
+													CallbackT&&			callback) const
+		{
+			if(empty() || !overlaps(m_rootBounds))
+				return;
+
+			std::vector<StackEntry> stack;
+			stack.reserve(64);
+			stack.push_back({m_rootBounds, m_root, 0.f});
+
+			while(!stack.empty())
+			{
+				const StackEntry CURRENT = stack.back();
+				stack.pop_back();
+
+				if(is_leaf(CURRENT.reference))
+				{
+					const uint32_t FIRST = get_first(CURRENT.reference);
+					const uint32_t COUNT = get_count(CURRENT.reference);
+
+					for(uint32_t i = FIRST; i < FIRST + COUNT; ++i)
+					{
+						if(!callback(m_indices[i]))
+							return;
+					}
+
+					continue;
+				}
+
+				const Node& NODE = m_nodes[CURRENT.reference];
+
+				for(uint32_t child = 2; child-- > 0;)
+				{
+					const Bounds CHILD_BOUNDS = decode(NODE, child, CURRENT.bounds);
+
+					if(overlaps(CHILD_BOUNDS))
+						stack.push_back({CHILD_BOUNDS, NODE.children[child], 0.f});
+				}
+			}
+		}
+
+		uint32_t				make_leaf_reference(const BVH::Node&	BINARY_LEAF) const;
+
+		/*
+			Writes offsets of the child and returns its decoded bounds.
+		*/
+		Bounds					encode(				Node&				node,
+													const uint32_t		CHILD,
+													const Bounds&		PARENT,
+													const BVH::Node&	BINARY_CHILD) const;
+	};
+
+
+	using	QuantizedBVH8	= QuantizedBVH<uint8_t>;
+	using	QuantizedBVH16	= QuantizedBVH<uint16_t>;
+}
\ No newline at end of file
@@ -0,0 +1,332 @@
+#pragma once
+
+
+#include <vector>
+#include <string>
+#include <queue>
+#include <limits>
+#include "cml_AABR.h"
+
+
+namespace cml
+{
+	/*
+		Two dimensional R-tree of axis aligned rectangles.
+
+		Tree is bulk loaded with Sort-Tile-Recursive packing, which fills nodes completely and keeps siblings spatially close.
+		Afterwards rectangles can be inserted(R* split) and removed(underfull nodes are dissolved and their rectangles reinserted).
+		Node stores bounds of all its children as structure-of-arrays, so that they are tested in one branchless loop.
+		Unused lanes have empty bounds, which fail every test without additional checks.
+
+		http://www.dtic.mil/dtic/tr/fulltext/u2/a324493.pdf
+		https://infolab.usc.edu/csci599/Fall2001/paper/rstar-tree.pdf
+	*/
+	class	RTree
+	{
+	public: // constants
+		static constexpr uint32_t	NULL_INDEX		= 0xFFFFFFFF;
+		static constexpr uint32_t	MAX_CHILDREN	= 16;
+		static constexpr uint32_t	MIN_CHILDREN	= 6;
+
+	public: // subtypes
+		struct alignas(64) Node
+		{
+			float		minX[MAX_CHILDREN];
+			float		minY[MAX_CHILDREN];
+			float		maxX[MAX_CHILDREN];
+			float		maxY[MAX_CHILDREN];
+			uint32_t	children[MAX_CHILDREN]; // Child nodes or proxies in leaves.
+			uint32_t	parent; // Next free node when node is not used.
+			uint32_t	count;
+			uint32_t	level; // Leaf = 0.
+
+			inline bool is_leaf() const
+			{
+				return level == 0;
+			}
+		};
+
+	private: // subtypes
+		struct	Proxy
+		{
+			AABR		box;
+			uint32_t	objectID;
+			uint32_t	leaf; // NULL_INDEX if proxy is not used.
+			uint32_t	next; // Next free proxy.
+		};
+
+		struct	Entry
+		{
+			Vec2		min;
+			Vec2		max;
+			uint32_t	child;
+		};
+
+		struct	NearestEntry
+		{
+			float		squaredDistance;
+			uint32_t	reference;
+			bool		bProxy;
+
+			inline bool operator>(const NearestEntry& OTHER) const
+			{
+				return squaredDistance > OTHER.squaredDistance;
+			}
+		};
+
+	private: // data
+		std::vector<Node>		m_nodes;
+		std::vector<Proxy>		m_proxies;
+		uint32_t				m_root;
+		uint32_t				m_freeNodes;
+		uint32_t				m_freeProxies;
+		uint32_t				m_numNodes;
+		uint32_t				m_numProxies;
+
+	public: // lifecycle
+		CLASS_CTOR				RTree();
+
+	public: // functions
+		inline uint32_t			size() const
+		{
+			return m_numProxies;
+		}
+
+		inline bool				empty() const
+		{
+			return m_numProxies == 0;
+		}
+
+		inline uint32_t			get_numNodes() const
+		{
+			return m_numNodes;
+		}
+
+		/*
+			Returns number of levels(1 when root is a leaf).
+		*/
+		inline uint32_t			get_height() const
+		{
+			return m_nodes[m_root].level + 1;
+		}
+
+		inline const AABR&		get_AABR(			const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_proxies[PROXY_ID].box;
+		}
+
+		inline uint32_t			get_objectID(		const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_proxies[PROXY_ID].objectID;
+		}
+
+		void					clear();
+
+		/*
+			Replaces content of the tree with given rectangles. Index of the rectangle is used as its object ID and proxy.
+		*/
+		void					build(				const AABR*			BOXES,
+													const uint32_t		NUM_BOXES);
+
+		/*
+			Adds rectangle and returns proxy used to move and remove it.
+		*/
+		uint32_t				insert(				const AABR&			BOX,
+													const uint32_t		OBJECT_ID);
+
+		void					remove(				const uint32_t		PROXY_ID);
+
+		/*
+			Updates bounds of the rectangle. Proxy is reinserted only when rectangle leaves bounds of its leaf.
+		*/
+		void					move(				const uint32_t		PROXY_ID,
+													const AABR&			BOX);
+
+		/*
+			Checks structure of the tree and throws if it is corrupted.
+		*/
+		void					validate() const;
+
+	public: // queries
+		/*
+			Callback receives object ID and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		void					query(				const Vec2&			POINT,
+													CallbackT&&			callback) const
+		{
+			traverse([&](const Node& NODE, const uint32_t LANE)
+			{
+				return (NODE.minX[LANE] <= POINT.x) & (POINT.x <= NODE.maxX[LANE]) & (NODE.minY[LANE] <= POINT.y) & (POINT.y <= NODE.maxY[LANE]);
+			}, callback);
+		}
+
+		template<typename CallbackT>
+		void					query(				const AABR&			BOX,
+													CallbackT&&			callback) const
+		{
+			const Vec2 MIN = BOX.min();
+			const Vec2 MAX = BOX.max();
+
+			traverse([&](const Node& NODE, const uint32_t LANE)
+			{
+				return (NODE.minX[LANE] <= MAX.x) & (MIN.x <= NODE.maxX[LANE]) & (NODE.minY[LANE] <= MAX.y) & (MIN.y <= NODE.maxY[LANE]);
+			}, callback);
+		}
+
+		/*
+			Reports up to K nearest rectangles in order of increasing distance(0 for rectangles that contain the point).
+			Callback receives object ID and distance and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		void					query_nearest(		const Vec2&			POINT,
+													uint32_t			K,
+													CallbackT&&			callback) const
+		{
+			if(empty() || K == 0)
+				return;
+
+			std::priority_queue<NearestEntry, std::vector<NearestEntry>, std::greater<NearestEntry>> queue;
+			queue.push({0.f, m_root, false});
+
+			while(!queue.empty())
+			{
+				const NearestEntry CURRENT = queue.top();
+				queue.pop();
+
+				if(CURRENT.bProxy)
+				{
+					if(!callback(m_proxies[CURRENT.reference].objectID, glm::sqrt(CURRENT.squaredDistance)) || --K == 0)
+						return;
+
+					continue;
+				}
+
+				const Node& NODE = m_nodes[CURRENT.reference];
+				float		squaredDistances[MAX_CHILDREN];
+
+				for(uint32_t lane = 0; lane < MAX_CHILDREN; ++lane)
+				{
+					const float DX = glm::max(glm::max(NODE.minX[lane] - POINT.x, POINT.x - NODE.maxX[lane]), 0.f);
+					const float DY = glm::max(glm::max(NODE.minY[lane] - POINT.y, POINT.y - NODE.maxY[lane]), 0.f);
+
+					squaredDistances[lane] = DX * DX + DY * DY;
+				}
+
+				for(uint32_t lane = 0; lane < NODE.count; ++lane)
+				{
+					queue.push({squaredDistances[lane], NODE.children[lane], NODE.is_leaf()});
+				}
+			}
+		}
+
+	private: // functions
+		inline void				validate_proxy(		[[maybe_unused]] const uint32_t PROXY_ID) const
+		{
+#ifdef _DEBUG
+			if(PROXY_ID >= m_proxies.size() || m_proxies[PROXY_ID].leaf == NULL_INDEX)
+				throw dpl::GeneralException(this, __LINE__, "Invalid proxy: " + std::to_string(PROXY_ID));
+#endif // _DEBUG
+		}
+
+		template<typename OverlapTestT, typename CallbackT>
+		void					traverse(			OverlapTestT&&		overlaps,
+													CallbackT&&			callback) const
+		{
+			uint32_t stack[256]; // Enough for any tree that fits in 32-bit indices.
+			uint32_t stackSize = 0;
+			stack[stackSize++] = m_root;
+
+			while(stackSize > 0)
+			{
+				const Node& NODE = m_nodes[stack[--stackSize]];
+				uint32_t	hit[MAX_CHILDREN];
+
+				for(uint32_t lane = 0; lane < MAX_CHILDREN; ++lane)
+				{
+					hit[lane] = static_cast<uint32_t>(overlaps(NODE, lane));
+				}
+
+				for(uint32_t lane = 0; lane < NODE.count; ++lane)
+				{
+					if(!hit[lane])
+						continue;
+
+					if(!NODE.is_leaf())
+					{
+						stack[stackSize++] = NODE.children[lane];
+					}
+					else if(!callback(m_proxies[NODE.children[lane]].objectID))
+					{
+						return;
+					}
+				}
+			}
+		}
+
+		static void				set_lane(			Node&				node,
+													const uint32_t		LANE,
+													const Entry&		ENTRY);
+
+		static void				clear_lane(			Node&				node,
+													const uint32_t		LANE);
+
+		static Entry			get_lane(			const Node&			NODE,
+													const uint32_t		LANE);
+
+		/*
+			Returns bounds of all children of the node.
+		*/
+		Entry					calculate_entry(	const uint32_t		NODE_ID) const;
+
+		uint32_t				allocate_node(		const uint32_t		LEVEL);
+
+		void					free_node(			const uint32_t		NODE_ID);
+
+		void					set_parent(			const uint32_t		NODE_ID,
+													const uint32_t		LANE);
+
+		uint32_t				find_lane(			const uint32_t		PARENT_ID,
+													const uint32_t		CHILD_ID) const;
+
+		void					remove_lane(		const uint32_t		NODE_ID,
+													const uint32_t		LANE);
+
+		/*
+			Descends to the node at given level whose bounds need the smallest enlargement.
+		*/
+		uint32_t				choose_node(		const Entry&		ENTRY,
+													const uint32_t		LEVEL) const;
+
+		/*
+			Adds child to the node and splits it when it is full.
+		*/
+		void					add_entry(			const uint32_t		NODE_ID,
+													const Entry&		ENTRY);
+
+		/*
+			Distributes children of the full node and the new entry between the node and returned sibling.
+		*/
+		uint32_t				split(				const uint32_t		NODE_ID,
+													const Entry&		ENTRY);
+
+		/*
+			Updates bounds of the node stored in its ancestors.
+		*/
+		void					refit_ancestors(	uint32_t			nodeID);
+
+		/*
+			Dissolves underfull nodes on the path from the leaf to the root and reinserts their proxies.
+		*/
+		void					condense(			uint32_t			nodeID);
+
+		void					collect_proxies(	const uint32_t		NODE_ID,
+													std::vector<uint32_t>& proxies);
+
+		void					insert_proxy(		const uint32_t		PROXY_ID);
+
+		uint32_t				validate_subtree(	const uint32_t		NODE_ID) const;
+	};
+}
\ No newline at end of file
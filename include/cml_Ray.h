@@ -2,6 +2,7 @@
 
 
 #include <optional>
+#include <cmath>
 #include <dpl_ReadOnly.h>
 #include "cml_CoordinateSystem.h"
 
@@ -68,6 +69,18 @@ namespace cml
 			return origin() + direction() * DISTANCE;
 		}
 
+		/*
+			Returns reciprocal of the ray direction used by the slab tests.
+			Zero components are replaced with the smallest normalized float of the same sign,
+			so that the result is always finite and slab distances never evaluate to NaN.
+		*/
+		inline Vec3					calculate_inverse_direction() const
+		{
+			return Vec3(calculate_safe_inverse(direction().x),
+						calculate_safe_inverse(direction().y),
+						calculate_safe_inverse(direction().z));
+		}
+
 		/*
 			Returns positive value when plane and ray are facing towards each other, 
 			negative when away from each other and nullopt if ray is perpendicular to the plane normal.
@@ -81,5 +94,12 @@ namespace cml
 
 			return std::nullopt;
 		}
+
+	private: // functions
+		static inline float			calculate_safe_inverse(	const float	VALUE)
+		{
+			const float MIN_VALUE = std::numeric_limits<float>::min();
+			return 1.f / (std::abs(VALUE) > MIN_VALUE ? VALUE : std::copysign(MIN_VALUE, VALUE));
+		}
 	};
 }
\ No newline at end of file
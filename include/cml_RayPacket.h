@@ -0,0 +1,162 @@
+#pragma once
+
+
+#include <dpl_GeneralException.h>
+#include "cml_Ray.h"
+#include "cml_AABB.h"
+
+
+namespace cml
+{
+	/*
+		Group of WIDTH rays stored as structure-of-arrays with precomputed inverse directions.
+
+		Each ray is tested against the box with the same branchless slab test,
+		so that compiler can evaluate all lanes at once(4 lanes = SSE, 8 lanes = AVX).
+		Lanes without a ray never report a hit.
+	*/
+	template<uint32_t WIDTH>
+	class	RayPacket
+	{
+	public: // constants
+		static constexpr uint32_t	NUM_LANES	= WIDTH;
+		static constexpr uint32_t	FULL_MASK	= (WIDTH >= 32) ? 0xFFFFFFFF : ((1u << WIDTH) - 1u);
+
+		static_assert(WIDTH > 0 && WIDTH <= 32, "Ray packet must have between 1 and 32 lanes.");
+
+	private: // data
+		float m_originX[WIDTH];
+		float m_originY[WIDTH];
+		float m_originZ[WIDTH];
+		float m_inverseX[WIDTH];
+		float m_inverseY[WIDTH];
+		float m_inverseZ[WIDTH];
+		float m_minDistance[WIDTH];
+		float m_maxDistance[WIDTH];
+
+	public: // lifecycle
+		CLASS_CTOR				RayPacket()
+		{
+			for(uint32_t lane = 0; lane < WIDTH; ++lane)
+			{
+				disable_ray(lane);
+			}
+		}
+
+		CLASS_CTOR				RayPacket(			const Ray*			RAYS,
+													const uint32_t		NUM_RAYS)
+			: RayPacket()
+		{
+			for(uint32_t lane = 0; lane < NUM_RAYS; ++lane)
+			{
+				set_ray(lane, RAYS[lane]);
+			}
+		}
+
+	public: // functions
+		inline void				set_ray(			const uint32_t		LANE,
+													const Ray&			RAY,
+													const float			MIN_DISTANCE = 0.f,
+													const float			MAX_DISTANCE = FLOAT_INFINITY)
+		{
+			validate_lane(LANE);
+
+			const Vec3 INVERSE_DIRECTION = RAY.calculate_inverse_direction();
+
+			m_originX[LANE]		= RAY.origin().x;
+			m_originY[LANE]		= RAY.origin().y;
+			m_originZ[LANE]		= RAY.origin().z;
+			m_inverseX[LANE]	= INVERSE_DIRECTION.x;
+			m_inverseY[LANE]	= INVERSE_DIRECTION.y;
+			m_inverseZ[LANE]	= INVERSE_DIRECTION.z;
+			m_minDistance[LANE] = MIN_DISTANCE;
+			m_maxDistance[LANE] = MAX_DISTANCE;
+		}
+
+		/*
+			Disabled lane has an empty distance range and never hits anything.
+		*/
+		inline void				disable_ray(		const uint32_t		LANE)
+		{
+			validate_lane(LANE);
+
+			m_originX[LANE]		= 0.f;
+			m_originY[LANE]		= 0.f;
+			m_originZ[LANE]		= 0.f;
+			m_inverseX[LANE]	= 1.f;
+			m_inverseY[LANE]	= 1.f;
+			m_inverseZ[LANE]	= 1.f;
+			m_minDistance[LANE] = FLOAT_INFINITY;
+			m_maxDistance[LANE] = -FLOAT_INFINITY;
+		}
+
+		/*
+			Shortens the ray, e.g. after closer hit was found.
+		*/
+		inline void				set_max_distance(	const uint32_t		LANE,
+													const float			MAX_DISTANCE)
+		{
+			validate_lane(LANE);
+			m_maxDistance[LANE] = MAX_DISTANCE;
+		}
+
+		inline float			get_max_distance(	const uint32_t		LANE) const
+		{
+			validate_lane(LANE);
+			return m_maxDistance[LANE];
+		}
+
+		/*
+			Returns bit mask of the rays that hit the box.
+			Distances are written for every lane, but are only meaningful for the lanes with a hit.
+		*/
+		inline uint32_t			intersects(			const AABB&			BOX,
+													float*				entryDistances,
+													float*				exitDistances) const
+		{
+			const Vec3 MIN = BOX.min();
+			const Vec3 MAX = BOX.max();
+
+			uint32_t hitMask = 0;
+
+			for(uint32_t lane = 0; lane < WIDTH; ++lane)
+			{
+				const float T1X = (MIN.x - m_originX[lane]) * m_inverseX[lane];
+				const float T2X = (MAX.x - m_originX[lane]) * m_inverseX[lane];
+				const float T1Y = (MIN.y - m_originY[lane]) * m_inverseY[lane];
+				const float T2Y = (MAX.y - m_originY[lane]) * m_inverseY[lane];
+				const float T1Z = (MIN.z - m_originZ[lane]) * m_inverseZ[lane];
+				const float T2Z = (MAX.z - m_originZ[lane]) * m_inverseZ[lane];
+
+				const float ENTRY	= glm::max(glm::max(glm::min(T1X, T2X), glm::min(T1Y, T2Y)), glm::max(glm::min(T1Z, T2Z), m_minDistance[lane]));
+				const float EXIT	= glm::min(glm::min(glm::max(T1X, T2X), glm::max(T1Y, T2Y)), glm::min(glm::max(T1Z, T2Z), m_maxDistance[lane]));
+
+				entryDistances[lane]	= ENTRY;
+				exitDistances[lane]		= EXIT;
+				hitMask					|= static_cast<uint32_t>(ENTRY <= EXIT) << lane;
+			}
+
+			return hitMask;
+		}
+
+		inline uint32_t			intersects(			const AABB&			BOX) const
+		{
+			float entryDistances[WIDTH];
+			float exitDistances[WIDTH];
+			return intersects(BOX, entryDistances, exitDistances);
+		}
+
+	private: // functions
+		inline void				validate_lane(		const uint32_t		LANE) const
+		{
+#ifdef _DEBUG
+			if(LANE >= WIDTH)
+				throw dpl::GeneralException(this, __LINE__, "Invalid ray packet lane: " + std::to_string(LANE));
+#endif // _DEBUG
+		}
+	};
+
+
+	using	RayPacket4 = RayPacket<4>;
+	using	RayPacket8 = RayPacket<8>;
+}
\ No newline at end of file
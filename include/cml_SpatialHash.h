@@ -0,0 +1,341 @@
+#pragma once
+
+
+#include <vector>
+#include <string>
+#include "cml_AABB.h"
+#include "cml_Sphere.h"
+#include "cml_parallel.h"
+
+
+namespace cml
+{
+	/*
+		Uniform grid of spheres hashed by integer cell coordinates.
+
+		Sphere is stored in the cell of its center, cells are kept in open addressing table(linear probing)
+		and objects of the cell form intrusive doubly linked list, so that moving object between cells is O(1).
+		Queries extend their range by the largest radius ever inserted, which works best when spheres are similarly sized
+		and cell size is close to their diameter.
+	*/
+	class	SpatialHash
+	{
+	public: // constants
+		static constexpr uint32_t	NULL_INDEX = 0xFFFFFFFF;
+
+	private: // subtypes
+		struct	Object
+		{
+			Vec3		center;
+			float		radius;
+			IVec3		cell;
+			uint32_t	objectID;
+			uint32_t	previous;
+			uint32_t	next; // Next free object when object is not used.
+		};
+
+		struct	Slot
+		{
+			IVec3		cell;
+			uint32_t	head; // NULL_INDEX if slot is empty.
+		};
+
+	private: // data
+		std::vector<Object>		m_objects;
+		std::vector<Slot>		m_slots;
+		std::vector<IVec3>		m_forwardOffsets; // Half of the neighbourhood used by pair queries.
+		uint32_t				m_freeList;
+		uint32_t				m_numObjects;
+		uint32_t				m_numCells;
+		float					m_cellSize;
+		float					m_inverseCellSize;
+		float					m_maxRadius;
+		int32_t					m_pairRange;
+
+	public: // lifecycle
+		CLASS_CTOR				SpatialHash(		const float			CELL_SIZE,
+													const uint32_t		INITIAL_CAPACITY = 1024);
+
+	public: // functions
+		inline uint32_t			size() const
+		{
+			return m_numObjects;
+		}
+
+		inline bool				empty() const
+		{
+			return m_numObjects == 0;
+		}
+
+		inline float			get_cellSize() const
+		{
+			return m_cellSize;
+		}
+
+		inline uint32_t			get_numCells() const
+		{
+			return m_numCells;
+		}
+
+		/*
+			Number of slots of the hash table. Pair queries can be split into ranges of slots.
+		*/
+		inline uint32_t			get_numSlots() const
+		{
+			return static_cast<uint32_t>(m_slots.size());
+		}
+
+		inline Sphere			get_sphere(			const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return Sphere(m_objects[PROXY_ID].center, m_objects[PROXY_ID].radius);
+		}
+
+		inline uint32_t			get_objectID(		const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_objects[PROXY_ID].objectID;
+		}
+
+		inline IVec3			calculate_cell(		const Vec3&			POINT) const
+		{
+			return IVec3(glm::floor(POINT * m_inverseCellSize));
+		}
+
+		void					clear();
+
+		/*
+			Adds object to the grid and returns proxy used to move and remove it.
+		*/
+		uint32_t				insert(				const Sphere&		SPHERE,
+													const uint32_t		OBJECT_ID);
+
+		void					remove(				const uint32_t		PROXY_ID);
+
+		/*
+			Updates sphere of the object. Lists are modified only when its center moves to another cell.
+		*/
+		void					move(				const uint32_t		PROXY_ID,
+													const Sphere&		SPHERE);
+
+	public: // queries
+		/*
+			Callback receives object ID of every sphere that intersects the query volume and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		void					query(				const Sphere&		SPHERE,
+													CallbackT&&			callback) const
+		{
+			const Vec3	CENTER	= SPHERE.center();
+			const float	RANGE	= SPHERE.radius() + m_maxRadius;
+
+			query_cells(CENTER - Vec3(RANGE), CENTER + Vec3(RANGE), [&](const Object& OBJECT)
+			{
+				if(!test_overlap(OBJECT, CENTER, SPHERE.radius()))
+					return true;
+
+				return callback(OBJECT.objectID);
+			});
+		}
+
+		template<typename CallbackT>
+		void					query(				const AABB&			BOX,
+													CallbackT&&			callback) const
+		{
+			query_cells(BOX.min() - Vec3(m_maxRadius), BOX.max() + Vec3(m_maxRadius), [&](const Object& OBJECT)
+			{
+				if(!Sphere(OBJECT.center, OBJECT.radius).intersects(BOX))
+					return true;
+
+				return callback(OBJECT.objectID);
+			});
+		}
+
+		/*
+			Reports every pair of intersecting spheres whose first sphere is stored in the given range of slots.
+			Ranges that cover all slots report every pair exactly once.
+			Function is const and does not use any shared state, so that disjoint ranges can be processed by separate threads.
+			Callback receives both object IDs and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		void					query_pairs(		const uint32_t		BEGIN_SLOT,
+													const uint32_t		END_SLOT,
+													CallbackT&&			callback) const
+		{
+			for(uint32_t slotID = BEGIN_SLOT; slotID < END_SLOT; ++slotID)
+			{
+				const Slot& SLOT = m_slots[slotID];
+				if(SLOT.head == NULL_INDEX)
+					continue;
+
+				// Objects of the same cell.
+				for(uint32_t objectA = SLOT.head; objectA != NULL_INDEX; objectA = m_objects[objectA].next)
+				{
+					const Object& A = m_objects[objectA];
+
+					for(uint32_t objectB = A.next; objectB != NULL_INDEX; objectB = m_objects[objectB].next)
+					{
+						const Object& B = m_objects[objectB];
+
+						if(test_overlap(A, B.center, B.radius) && !callback(A.objectID, B.objectID))
+							return;
+					}
+				}
+
+				// Objects of the neighbouring cells, each pair of cells is checked from one side only.
+				for(auto& iOffset : m_forwardOffsets)
+				{
+					const uint32_t NEIGHBOUR_SLOT = find_slot(SLOT.cell + iOffset);
+					if(NEIGHBOUR_SLOT == NULL_INDEX)
+						continue;
+
+					for(uint32_t objectA = SLOT.head; objectA != NULL_INDEX; objectA = m_objects[objectA].next)
+					{
+						const Object& A = m_objects[objectA];
+
+						for(uint32_t objectB = m_slots[NEIGHBOUR_SLOT].head; objectB != NULL_INDEX; objectB = m_objects[objectB].next)
+						{
+							const Object& B = m_objects[objectB];
+
+							if(test_overlap(A, B.center, B.radius) && !callback(A.objectID, B.objectID))
+								return;
+						}
+					}
+				}
+			}
+		}
+
+		template<typename CallbackT>
+		inline void				query_pairs(		CallbackT&&			callback) const
+		{
+			query_pairs(0, get_numSlots(), callback);
+		}
+
+		/*
+			Splits pair query into ranges of slots processed in parallel.
+			Callback receives both object IDs and the worker ID, it must be thread-safe.
+		*/
+		template<typename CallbackT>
+		void					parallel_query_pairs(CallbackT&&		callback) const
+		{
+			parallel_for(0, get_numSlots(), 1024, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t WORKER_ID)
+			{
+				query_pairs(BEGIN, END, [&](const uint32_t OBJECT_A, const uint32_t OBJECT_B)
+				{
+					callback(OBJECT_A, OBJECT_B, WORKER_ID);
+					return true;
+				});
+			});
+		}
+
+	private: // functions
+		inline void				validate_proxy(		[[maybe_unused]] const uint32_t PROXY_ID) const
+		{
+#ifdef _DEBUG
+			if(PROXY_ID >= m_objects.size() || m_objects[PROXY_ID].radius < 0.f)
+				throw dpl::GeneralException(this, __LINE__, "Invalid proxy: " + std::to_string(PROXY_ID));
+#endif // _DEBUG
+		}
+
+		static inline bool		test_overlap(		const Object&		OBJECT,
+													const Vec3&			CENTER,
+													const float			RADIUS)
+		{
+			// Same test as Sphere::intersects(const Sphere&) without the square root.
+			const Vec3	TO_CENTER	= CENTER - OBJECT.center;
+			const float	RADII		= OBJECT.radius + RADIUS;
+			return calculate_dot(TO_CENTER, TO_CENTER) < RADII * RADII;
+		}
+
+		static inline uint32_t	calculate_hash(		const IVec3&		CELL)
+		{
+			const uint32_t HASH =	(static_cast<uint32_t>(CELL.x) * 73856093u) ^
+									(static_cast<uint32_t>(CELL.y) * 19349663u) ^
+									(static_cast<uint32_t>(CELL.z) * 83492791u);
+
+			// Table is indexed with the lower bits, so higher bits are mixed into them.
+			return HASH ^ (HASH >> 16);
+		}
+
+		inline uint32_t			find_slot(			const IVec3&		CELL) const
+		{
+			const uint32_t MASK = get_numSlots() - 1;
+
+			for(uint32_t slotID = calculate_hash(CELL) & MASK;; slotID = (slotID + 1) & MASK)
+			{
+				const Slot& SLOT = m_slots[slotID];
+
+				if(SLOT.head == NULL_INDEX)
+					return NULL_INDEX;
+
+				if(SLOT.cell == CELL)
+					return slotID;
+			}
+		}
+
+		/*
+			Visits objects of all cells that overlap given range.
+			When range covers more cells than are occupied, whole table is scanned instead.
+		*/
+		template<typename VisitorT>
+		void					query_cells(		const Vec3&			MIN,
+													const Vec3&			MAX,
+													VisitorT&&			visit) const
+		{
+			const IVec3 MIN_CELL = calculate_cell(MIN);
+			const IVec3 MAX_CELL = calculate_cell(MAX);
+			const Vec3	SIZE	 = Vec3(MAX_CELL - MIN_CELL) + Vec3(1.f);
+
+			auto visit_slot = [&](const Slot& SLOT)
+			{
+				for(uint32_t objectID = SLOT.head; objectID != NULL_INDEX; objectID = m_objects[objectID].next)
+				{
+					if(!visit(m_objects[objectID]))
+						return false;
+				}
+
+				return true;
+			};
+
+			if(SIZE.x * SIZE.y * SIZE.z > static_cast<float>(m_numCells))
+			{
+				for(auto& iSlot : m_slots)
+				{
+					if(iSlot.head == NULL_INDEX || glm::any(glm::lessThan(iSlot.cell, MIN_CELL)) || glm::any(glm::greaterThan(iSlot.cell, MAX_CELL)))
+						continue;
+
+					if(!visit_slot(iSlot))
+						return;
+				}
+
+				return;
+			}
+
+			for(int32_t z = MIN_CELL.z; z <= MAX_CELL.z; ++z)
+			{
+				for(int32_t y = MIN_CELL.y; y <= MAX_CELL.y; ++y)
+				{
+					for(int32_t x = MIN_CELL.x; x <= MAX_CELL.x; ++x)
+					{
+						const uint32_t SLOT_ID = find_slot(IVec3(x, y, z));
+
+						if(SLOT_ID != NULL_INDEX && !visit_slot(m_slots[SLOT_ID]))
+							return;
+					}
+				}
+			}
+		}
+
+		uint32_t				find_or_add_slot(	const IVec3&		CELL);
+
+		void					remove_slot(		const uint32_t		SLOT_ID);
+
+		void					rehash(				const uint32_t		NUM_SLOTS);
+
+		void					link(				const uint32_t		PROXY_ID);
+
+		void					unlink(				const uint32_t		PROXY_ID);
+
+		void					update_max_radius(	const float			RADIUS);
+	};
+}
\ No newline at end of file
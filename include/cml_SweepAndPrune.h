@@ -0,0 +1,218 @@
+#pragma once
+
+
+#include <vector>
+#include <string>
+#include "cml_AABB.h"
+
+
+namespace cml
+{
+	/*
+		Incremental sort and sweep broadphase of moving AABBs.
+
+		Endpoints of all boxes along the sweep axis are kept sorted between updates. Objects move coherently,
+		so insertion sort reorders them in nearly linear time. Sweep over sorted endpoints tests only boxes whose
+		intervals overlap along the axis and the result is compared with the persistent set of pairs
+		to report pairs that started and stopped overlapping since the previous update.
+		Axis along which centers of the boxes have the largest variance separates them best and can be chosen automatically.
+	*/
+	class	SweepAndPrune
+	{
+	public: // constants
+		static constexpr uint32_t	NULL_INDEX = 0xFFFFFFFF;
+
+	public: // subtypes
+		struct	Pair
+		{
+			uint32_t	objectA;
+			uint32_t	objectB;
+		};
+
+	private: // subtypes
+		struct	Proxy
+		{
+			AABB		box;
+			uint32_t	objectID;
+			uint32_t	next; // Next free proxy.
+			bool		bUsed;
+		};
+
+		struct	Endpoint
+		{
+			float		value;
+			uint32_t	data; // Proxy ID shifted left by one, lowest bit is set for maximum.
+
+			inline uint32_t get_proxyID() const
+			{
+				return data >> 1;
+			}
+
+			inline bool		is_max() const
+			{
+				return (data & 1) != 0;
+			}
+
+			/*
+				Minimum goes before maximum of the same value, so that touching boxes are tested.
+			*/
+			inline bool		operator<(const Endpoint& OTHER) const
+			{
+				return (value < OTHER.value) || (value == OTHER.value && !is_max() && OTHER.is_max());
+			}
+		};
+
+	private: // data
+		std::vector<Proxy>		m_proxies;
+		std::vector<Endpoint>	m_endpoints;
+		std::vector<uint64_t>	m_pairs;			// Sorted keys of overlapping proxies.
+		std::vector<uint64_t>	m_currentPairs;		// Pairs found by the last sweep.
+		std::vector<uint32_t>	m_active;			// Proxies whose interval contains current endpoint.
+		std::vector<uint32_t>	m_activeIndices;	// Position of the proxy in the active list.
+		std::vector<uint32_t>	m_removed;			// Proxies released after their pairs are ended.
+		std::vector<Pair>		m_beganPairs;
+		std::vector<Pair>		m_endedPairs;
+		uint32_t				m_freeList;
+		uint32_t				m_numProxies;
+		uint32_t				m_numSorted;		// Endpoints sorted by the previous update, the rest was added since.
+		uint32_t				m_axis;
+
+	public: // lifecycle
+		CLASS_CTOR				SweepAndPrune(		const uint32_t		AXIS = 0);
+
+	public: // functions
+		inline uint32_t			size() const
+		{
+			return m_numProxies;
+		}
+
+		inline bool				empty() const
+		{
+			return m_numProxies == 0;
+		}
+
+		inline uint32_t			get_axis() const
+		{
+			return m_axis;
+		}
+
+		inline uint32_t			get_numPairs() const
+		{
+			return static_cast<uint32_t>(m_pairs.size());
+		}
+
+		inline const AABB&		get_AABB(			const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_proxies[PROXY_ID].box;
+		}
+
+		inline uint32_t			get_objectID(		const uint32_t		PROXY_ID) const
+		{
+			validate_proxy(PROXY_ID);
+			return m_proxies[PROXY_ID].objectID;
+		}
+
+		/*
+			Pairs that started overlapping during the last update.
+		*/
+		inline const std::vector<Pair>&	began_pairs() const
+		{
+			return m_beganPairs;
+		}
+
+		/*
+			Pairs that stopped overlapping during the last update, including pairs of removed objects.
+		*/
+		inline const std::vector<Pair>&	ended_pairs() const
+		{
+			return m_endedPairs;
+		}
+
+		/*
+			Changes sweep axis(0 = X, 1 = Y, 2 = Z), endpoints are sorted again during the next update.
+		*/
+		void					set_axis(			const uint32_t		AXIS);
+
+		/*
+			Returns axis along which centers of the boxes have the largest variance.
+		*/
+		uint32_t				calculate_best_axis() const;
+
+		void					clear();
+
+		/*
+			Adds object and returns proxy used to move and remove it. Its pairs are found during the next update.
+		*/
+		uint32_t				insert(				const AABB&			BOX,
+													const uint32_t		OBJECT_ID);
+
+		/*
+			Removes object, its pairs are reported as ended during the next update.
+			Proxy is not reused before that.
+		*/
+		void					remove(				const uint32_t		PROXY_ID);
+
+		void					move(				const uint32_t		PROXY_ID,
+													const AABB&			BOX);
+
+		/*
+			Sorts endpoints, finds overlapping pairs and updates lists of began and ended pairs.
+			When bCHOOSE_AXIS is set, axis with the largest variance is used as the sweep axis.
+		*/
+		void					update(				const bool			bCHOOSE_AXIS = false);
+
+	public: // queries
+		/*
+			Reports every pair found by the last update.
+			Callback receives both object IDs and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		void					query_pairs(		CallbackT&&			callback) const
+		{
+			for(const uint64_t KEY : m_pairs)
+			{
+				if(!callback(m_proxies[get_proxyA(KEY)].objectID, m_proxies[get_proxyB(KEY)].objectID))
+					return;
+			}
+		}
+
+	private: // functions
+		inline void				validate_proxy(		[[maybe_unused]] const uint32_t PROXY_ID) const
+		{
+#ifdef _DEBUG
+			if(PROXY_ID >= m_proxies.size() || !m_proxies[PROXY_ID].bUsed)
+				throw dpl::GeneralException(this, __LINE__, "Invalid proxy: " + std::to_string(PROXY_ID));
+#endif // _DEBUG
+		}
+
+		static inline uint64_t	make_key(			const uint32_t		PROXY_A,
+													const uint32_t		PROXY_B)
+		{
+			return (PROXY_A < PROXY_B) ? (static_cast<uint64_t>(PROXY_A) << 32) | PROXY_B
+									   : (static_cast<uint64_t>(PROXY_B) << 32) | PROXY_A;
+		}
+
+		static inline uint32_t	get_proxyA(			const uint64_t		KEY)
+		{
+			return static_cast<uint32_t>(KEY >> 32);
+		}
+
+		static inline uint32_t	get_proxyB(			const uint64_t		KEY)
+		{
+			return static_cast<uint32_t>(KEY);
+		}
+
+		inline float			get_value(			const Endpoint&		ENDPOINT) const
+		{
+			const AABB& BOX = m_proxies[ENDPOINT.get_proxyID()].box;
+			return ENDPOINT.is_max() ? BOX.max()[m_axis] : BOX.min()[m_axis];
+		}
+
+		void					sort_endpoints();
+
+		void					sweep();
+
+		void					report_changes();
+	};
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 
 #include <vector>
+#include <memory>
 #include <dpl_ReadOnly.h>
 #include "cml_utilities.h"
 #include "cml_CoordinateSystem.h"
@@ -13,6 +14,9 @@ namespace cml
 {
 	class TriangleMesh
 	{
+	public: // constants
+		static constexpr uint32_t	MAX_SMALL_POLYGON_VERTICES = 64;
+
 	public: // subtypes
 		using	Vertices	= std::vector<Vec3>;
 		using	Indices		= std::vector<uint32_t>;
@@ -21,17 +25,209 @@ namespace cml
 		using	Vertices2D		= std::vector<Vec2>;
 		using	Vertices2DArray	= std::vector<const Vertices2D*>;
 
+		/*
+			Polygon with holes triangulated by the batch triangulation, same as arguments of the single triangulation.
+		*/
+		struct	TriangulationJob
+		{
+			const CoordinateSystem*	rps;
+			uint32_t				x2DIndex;
+			uint32_t				y2DIndex;
+			const Vertices2D*		border;
+			const Vertices2DArray*	holes; // Can be nullptr.
+			Orientation				targetOrientation;
+		};
+
+		/*
+			Algorithm used for polygons that are not handled by the fast paths.
+		*/
+		enum class TriangulationBackend : uint8_t
+		{
+			CDT,		// Constrained Delaunay triangulation(poly2tri), robust and produces well shaped triangles.
+			MONOTONE	// Sweep that splits polygon into monotone pieces. Experimental: it often fails when vertices share X coordinate,
+						// so it throws when its triangles do not cover the polygon exactly or vertices share X and Y coordinate.
+		};
+
+		/*
+			Polygons without holes skip the backend when they are small.
+			Convex polygons are triangulated with a fan and other simple polygons with ear clipping,
+			both work on stack buffers and do not allocate memory. Thresholds are limited by MAX_SMALL_POLYGON_VERTICES, zero disables the algorithm.
+		*/
+		struct	TriangulationSettings
+		{
+			uint32_t				maxFanVertices			= 32;
+			uint32_t				maxEarClippingVertices	= 16;
+			TriangulationBackend	backend					= TriangulationBackend::CDT;
+		};
+
+		/*
+			Buffers of the triangulation that keep their memory between calls, so that polygons appended one by one
+			do not allocate scratch memory each time. One scratch can be shared by many meshes, but not by many threads at once.
+		*/
+		class	TriangulationScratch
+		{
+		public: // subtypes
+			struct	Buffers; // Defined with the triangulation.
+
+		private: // data
+			std::unique_ptr<Buffers>	m_buffers;
+
+		public: // lifecycle
+			CLASS_CTOR				TriangulationScratch();
+
+			CLASS_CTOR				TriangulationScratch(	const TriangulationScratch&	OTHER) = delete;
+
+			TriangulationScratch&	operator=(				const TriangulationScratch&	OTHER) = delete;
+
+									~TriangulationScratch();
+
+		public: // functions
+			inline Buffers&			buffers()
+			{
+				return *m_buffers;
+			}
+		};
+
+		/*
+			Vertices and indices of the mesh produced by one triangulation job.
+		*/
+		struct	TriangulationRange
+		{
+			uint32_t	firstVertex;
+			uint32_t	numVertices;
+			uint32_t	firstIndex;
+			uint32_t	numIndices;
+		};
+
+		/*
+			Mesh placed in the world with affine transformation(projective part of the matrix is ignored).
+		*/
+		struct	Instance
+		{
+			const TriangleMesh*	mesh;
+			Mat4				transformation;
+		};
+
+		/*
+			Contribution of each triangle to the normals of its vertices.
+		*/
+		enum class NormalWeighting : uint8_t
+		{
+			UNIFORM,	// Each triangle contributes equally.
+			AREA,		// Large triangles contribute more.
+			ANGLE		// Triangles contribute by their angle at the vertex, result does not depend on tessellation.
+		};
+
+		/*
+			Triangle corners of each vertex in compressed sparse row format.
+			Corners of the vertex V are stored in corners[offsets[V], offsets[V+1]), corner C belongs to the triangle C/3.
+			Adjacency depends only on indices, so it can be reused while vertices of the mesh change.
+		*/
+		struct	VertexAdjacency
+		{
+			std::vector<uint32_t>	offsets;
+			std::vector<uint32_t>	corners;
+		};
+
+		/*
+			Efficiency of the post-transform vertex cache.
+			ACMR is the number of cache misses per triangle(0.5 at best for regular grids, 3 at worst),
+			ATVR is the number of cache misses per used vertex(1 at best).
+		*/
+		struct	CacheStatistics
+		{
+			float	acmr;
+			float	atvr;
+		};
+
 	public: // data
 		dpl::ReadOnly<Vertices,	TriangleMesh> vertices;
 		dpl::ReadOnly<Indices,	TriangleMesh> indices;
 
 	public: // functions
+		/*
+			Replaces content of the mesh with the triangulated polygon, mesh is not changed when triangulation fails.
+			TARGET_ORIENTATION is the orientation of the triangles in 2D space of the RPS, as returned by calculate_polygon_orientation.
+		*/
 		void			triangulate(			const CoordinateSystem& RPS,
 												const uint32_t			X_2D_INDEX,
 												const uint32_t			Y_2D_INDEX,
 												const Vertices2D&		BORDER_POLYGON,
 												const Vertices2DArray&	HOLE_POLYGONS,
-												const Orientation		TARGET_ORIENTATION);
+												const Orientation		TARGET_ORIENTATION,
+												const TriangulationSettings& SETTINGS);
+
+		inline void		triangulate(			const CoordinateSystem& RPS,
+												const uint32_t			X_2D_INDEX,
+												const uint32_t			Y_2D_INDEX,
+												const Vertices2D&		BORDER_POLYGON,
+												const Vertices2DArray&	HOLE_POLYGONS,
+												const Orientation		TARGET_ORIENTATION)
+		{
+			triangulate(RPS, X_2D_INDEX, Y_2D_INDEX, BORDER_POLYGON, HOLE_POLYGONS, TARGET_ORIENTATION, TriangulationSettings());
+		}
+
+		/*
+			Triangulates polygon and appends the result to the end of the mesh, indices are rebased onto the existing vertices.
+			Buffers keep their capacity, so that one mesh can be built from many polygons without intermediate meshes.
+			Mesh is restored to its previous size when triangulation fails.
+		*/
+		void			append_triangulation(	const CoordinateSystem& RPS,
+												const uint32_t			X_2D_INDEX,
+												const uint32_t			Y_2D_INDEX,
+												const Vertices2D&		BORDER_POLYGON,
+												const Vertices2DArray&	HOLE_POLYGONS,
+												const Orientation		TARGET_ORIENTATION,
+												const TriangulationSettings& SETTINGS,
+												TriangulationScratch&	scratch);
+
+		inline void		append_triangulation(	const CoordinateSystem& RPS,
+												const uint32_t			X_2D_INDEX,
+												const uint32_t			Y_2D_INDEX,
+												const Vertices2D&		BORDER_POLYGON,
+												const Vertices2DArray&	HOLE_POLYGONS,
+												const Orientation		TARGET_ORIENTATION,
+												const TriangulationSettings& SETTINGS)
+		{
+			TriangulationScratch scratch;
+			append_triangulation(RPS, X_2D_INDEX, Y_2D_INDEX, BORDER_POLYGON, HOLE_POLYGONS, TARGET_ORIENTATION, SETTINGS, scratch);
+		}
+
+		inline void		append_triangulation(	const CoordinateSystem& RPS,
+												const uint32_t			X_2D_INDEX,
+												const uint32_t			Y_2D_INDEX,
+												const Vertices2D&		BORDER_POLYGON,
+												const Vertices2DArray&	HOLE_POLYGONS,
+												const Orientation		TARGET_ORIENTATION)
+		{
+			append_triangulation(RPS, X_2D_INDEX, Y_2D_INDEX, BORDER_POLYGON, HOLE_POLYGONS, TARGET_ORIENTATION, TriangulationSettings());
+		}
+
+		/*
+			Triangulates all jobs on multiple threads and replaces content of the mesh with their results in the order of jobs.
+			Jobs are taken dynamically in small groups and each thread reuses its own scratch buffers.
+			Returns ranges of vertices and indices of each job, indices are relative to the whole mesh.
+		*/
+		std::vector<TriangulationRange> triangulate(const TriangulationJob*	JOBS,
+												const uint32_t			NUM_JOBS,
+												const TriangulationSettings& SETTINGS);
+
+		inline std::vector<TriangulationRange> triangulate(const TriangulationJob*	JOBS,
+												const uint32_t			NUM_JOBS)
+		{
+			return triangulate(JOBS, NUM_JOBS, TriangulationSettings());
+		}
+
+		inline std::vector<TriangulationRange> triangulate(const std::vector<TriangulationJob>& JOBS,
+												const TriangulationSettings& SETTINGS)
+		{
+			return triangulate(JOBS.data(), static_cast<uint32_t>(JOBS.size()), SETTINGS);
+		}
+
+		inline std::vector<TriangulationRange> triangulate(const std::vector<TriangulationJob>& JOBS)
+		{
+			return triangulate(JOBS, TriangulationSettings());
+		}
 
 		inline void		reset()
 		{
@@ -77,11 +273,60 @@ namespace cml
 			indices->push_back(NEW_INDEX);
 		}
 
+		/*
+			Replaces content of the mesh with given buffers without copying them, mesh is not changed when number of indices is not divisible by 3.
+		*/
+		void			assign(					Vertices&&				newVertices,
+												Indices&&				newIndices);
+
 		void			extend(					const TriangleMesh&		OTHER,
 												const Mat4&				OTHER_TRANSFORMATION);
 
+		/*
+			Appends all instances at once. Memory is allocated once for the final size,
+			vertices are transformed and indices rebased in parallel. Instance can reference this mesh.
+		*/
+		void			extend(					const Instance*			INSTANCES,
+												const uint32_t			NUM_INSTANCES);
+
+		inline void		extend(					const std::vector<Instance>& INSTANCES)
+		{
+			extend(INSTANCES.data(), static_cast<uint32_t>(INSTANCES.size()));
+		}
+
 		void			flip();
 
+		/*
+			Merges vertices that are not further than EPSILON apart(only equal ones when EPSILON is 0)
+			and removes triangles that became degenerated. Vertices are compacted in place without changing their order,
+			vertices that are no longer used are removed as well. Returns number of removed vertices.
+		*/
+		uint32_t		weld(					const float				EPSILON);
+
+		/*
+			Simulates FIFO vertex cache of the given size.
+		*/
+		CacheStatistics	calculate_cacheStatistics(const uint32_t		CACHE_SIZE = 32) const;
+
+		/*
+			Reorders triangles for the vertex cache of the given size with the Tipsify algorithm(linear time).
+			Triangles are emitted in fans around vertices chosen among the ones that are still in the cache.
+		*/
+		void			optimize_vertexCache(	const uint32_t			CACHE_SIZE = 32);
+
+		/*
+			Splits triangles into clusters that start with three cache misses and sorts them from the most outward facing,
+			so that front faces tend to be drawn before the ones they occlude. Cache efficiency is preserved within clusters,
+			so it should be called after optimize_vertexCache with the same cache size.
+		*/
+		void			optimize_overdraw(		const uint32_t			CACHE_SIZE = 32);
+
+		/*
+			Orders vertices by their first use in indices, unused vertices are moved to the end.
+			Returns new index of each old vertex, so that other vertex attributes can be reordered the same way.
+		*/
+		std::vector<uint32_t> optimize_vertexFetch();
+
 		void			generate_normals(		Vec3*					output) const;
 
 		inline Normals	generate_normals() const
@@ -90,6 +335,23 @@ namespace cml
 			generate_normals(output.data());
 			return output;
 		}
+
+		VertexAdjacency	build_vertexAdjacency() const;
+
+		/*
+			Calculates normals in parallel. Each thread gathers contributions of adjacent triangles for its own range of vertices,
+			so that no synchronization is needed. Output is overwritten, vertices without triangles get zero normals.
+		*/
+		void			generate_normals(		const VertexAdjacency&	ADJACENCY,
+												const NormalWeighting	WEIGHTING,
+												Vec3*					output) const;
+
+		inline Normals	generate_normals(		const NormalWeighting	WEIGHTING) const
+		{
+			Normals output(get_numVertices());
+			generate_normals(build_vertexAdjacency(), WEIGHTING, output.data());
+			return output;
+		}
 	};
 }
 
@@ -0,0 +1,283 @@
+#pragma once
+
+
+#include <vector>
+#include <limits>
+#include "cml_BVH.h"
+
+
+namespace cml
+{
+	/*
+		Bounding volume hierarchy with WIDTH children per node, collapsed from the binary BVH.
+
+		Bounds of all children are stored as structure-of-arrays, so that traversal tests them in one branchless loop
+		that compiler can evaluate at once(4 lanes = SSE, 8 lanes = AVX). Children are visited in near to far order.
+		Empty lanes have bounds at infinity, which makes them fail every test without additional checks.
+		Leaves reference ranges of the same primitive indices as the binary BVH, so it works for both mesh triangles and scene objects.
+	*/
+	template<uint32_t WIDTH>
+	class	WideBVH
+	{
+	public: // constants
+		static constexpr uint32_t	NUM_LANES	= WIDTH;
+		static constexpr uint32_t	EMPTY_LANE	= 0xFFFFFFFF;
+
+		static_assert(WIDTH == 4 || WIDTH == 8, "Wide BVH must have 4 or 8 children per node.");
+
+	public: // subtypes
+		struct alignas(64) Node
+		{
+			float		minX[WIDTH];
+			float		minY[WIDTH];
+			float		minZ[WIDTH];
+			float		maxX[WIDTH];
+			float		maxY[WIDTH];
+			float		maxZ[WIDTH];
+			uint32_t	children[WIDTH];	// Index of the child node, first primitive index of the leaf or EMPTY_LANE.
+			uint32_t	counts[WIDTH];		// Number of primitives in the leaf, 0 for child nodes and empty lanes.
+
+			inline bool is_leaf(const uint32_t LANE) const
+			{
+				return counts[LANE] > 0;
+			}
+
+			inline bool is_empty(const uint32_t LANE) const
+			{
+				return children[LANE] == EMPTY_LANE;
+			}
+		};
+
+	private: // subtypes
+		struct	StackEntry
+		{
+			uint32_t	child;
+			uint32_t	count;
+			float		distance;
+		};
+
+	private: // data
+		std::vector<Node>		m_nodes;
+		std::vector<uint32_t>	m_indices;
+
+	public: // lifecycle
+		CLASS_CTOR				WideBVH() = default;
+
+		CLASS_CTOR				WideBVH(			const BVH&			BINARY)
+		{
+			build(BINARY);
+		}
+
+	public: // functions
+		inline bool				empty() const
+		{
+			return m_nodes.empty();
+		}
+
+		inline uint32_t			get_numNodes() const
+		{
+			return static_cast<uint32_t>(m_nodes.size());
+		}
+
+		inline uint32_t			get_numPrimitives() const
+		{
+			return static_cast<uint32_t>(m_indices.size());
+		}
+
+		inline const Node*		nodes() const
+		{
+			return m_nodes.data();
+		}
+
+		inline const uint32_t*	indices() const
+		{
+			return m_indices.data();
+		}
+
+		void					clear();
+
+		/*
+			Collapses binary hierarchy by repeatedly replacing the largest child node with its own children,
+			until node has WIDTH children or all of them are leaves.
+		*/
+		void					build(				const BVH&			BINARY);
+
+	public: // queries
+		/*
+			Reports every primitive of the leaves that overlap the sphere, so callback should test the primitive itself.
+			Callback receives primitive index and returns false to stop the query.
+		*/
+		template<typename CallbackT>
+		void					query(				const Sphere&		SPHERE,
+													CallbackT&&			callback) const
+		{
+			if(m_nodes.empty())
+				return;
+
+			const Vec3	CENTER			= SPHERE.center();
+			const float	SQUARED_RADIUS	= SPHERE.radius() * SPHERE.radius();
+
+			std::vector<StackEntry> stack;
+			stack.reserve(64);
+			stack.push_back({0, 0, 0.f});
+
+			while(!stack.empty())
+			{
+				const StackEntry CURRENT = stack.back();
+				stack.pop_back();
+
+				if(CURRENT.count > 0)
+				{
+					if(!report_leaf(CURRENT, callback))
+						return;
+
+					continue;
+				}
+
+				const Node& NODE = m_nodes[CURRENT.child];
+				uint32_t	hit[WIDTH];
+
+				for(uint32_t lane = 0; lane < WIDTH; ++lane)
+				{
+					const float DX = glm::max(glm::max(NODE.minX[lane] - CENTER.x, CENTER.x - NODE.maxX[lane]), 0.f);
+					const float DY = glm::max(glm::max(NODE.minY[lane] - CENTER.y, CENTER.y - NODE.maxY[lane]), 0.f);
+					const float DZ = glm::max(glm::max(NODE.minZ[lane] - CENTER.z, CENTER.z - NODE.maxZ[lane]), 0.f);
+
+					hit[lane] = static_cast<uint32_t>(DX * DX + DY * DY + DZ * DZ <= SQUARED_RADIUS);
+				}
+
+				for(uint32_t lane = 0; lane < WIDTH; ++lane)
+				{
+					if(hit[lane])
+						stack.push_back({NODE.children[lane], NODE.counts[lane], 0.f});
+				}
+			}
+		}
+
+		/*
+			Visits children in near to far order.
+			Callback receives primitive index and distance at which the ray enters its leaf.
+			It returns new maximal distance of the ray(e.g. distance to the exact hit),
+			returning 0 stops the query and returning the current maximum continues it unchanged.
+		*/
+		template<typename CallbackT>
+		void					query(				const Ray&			RAY,
+													CallbackT&&			callback,
+													float				maxDistance = FLOAT_INFINITY) const
+		{
+			if(m_nodes.empty())
+				return;
+
+			const Vec3 ORIGIN				= RAY.origin();
+			const Vec3 INVERSE_DIRECTION	= RAY.calculate_inverse_direction();
+
+			std::vector<StackEntry> stack;
+			stack.reserve(64);
+			stack.push_back({0, 0, 0.f});
+
+			while(!stack.empty())
+			{
+				const StackEntry CURRENT = stack.back();
+				stack.pop_back();
+
+				if(CURRENT.distance > maxDistance)
+					continue; // Closer hit was found after the entry was pushed.
+
+				if(CURRENT.count > 0)
+				{
+					maxDistance = report_leaf(CURRENT, callback, maxDistance);
+					if(maxDistance <= 0.f)
+						return;
+
+					continue;
+				}
+
+				const Node& NODE = m_nodes[CURRENT.child];
+				float		entry[WIDTH];
+				uint32_t	hit[WIDTH];
+
+				// Same slab test as AABB::intersects(ray, entry, exit) for all children at once.
+				for(uint32_t lane = 0; lane < WIDTH; ++lane)
+				{
+					const float T1X = (NODE.minX[lane] - ORIGIN.x) * INVERSE_DIRECTION.x;
+					const float T2X = (NODE.maxX[lane] - ORIGIN.x) * INVERSE_DIRECTION.x;
+					const float T1Y = (NODE.minY[lane] - ORIGIN.y) * INVERSE_DIRECTION.y;
+					const float T2Y = (NODE.maxY[lane] - ORIGIN.y) * INVERSE_DIRECTION.y;
+					const float T1Z = (NODE.minZ[lane] - ORIGIN.z) * INVERSE_DIRECTION.z;
+					const float T2Z = (NODE.maxZ[lane] - ORIGIN.z) * INVERSE_DIRECTION.z;
+
+					const float ENTRY	= glm::max(glm::max(glm::min(T1X, T2X), glm::min(T1Y, T2Y)), glm::max(glm::min(T1Z, T2Z), 0.f));
+					const float EXIT	= glm::min(glm::min(glm::max(T1X, T2X), glm::max(T1Y, T2Y)), glm::min(glm::max(T1Z, T2Z), maxDistance));
+
+					entry[lane]	= ENTRY;
+					hit[lane]	= static_cast<uint32_t>(ENTRY <= EXIT);
+				}
+
+				// Hit children are sorted from far to near, so that the nearest one is on top of the stack.
+				const size_t FIRST = stack.size();
+
+				for(uint32_t lane = 0; lane < WIDTH; ++lane)
+				{
+					if(!hit[lane])
+						continue;
+
+					const StackEntry CHILD = {NODE.children[lane], NODE.counts[lane], entry[lane]};
+
+					size_t position = stack.size();
+					stack.push_back(CHILD);
+
+					for(; position > FIRST && stack[position - 1].distance < CHILD.distance; --position)
+					{
+						stack[position] = stack[position - 1];
+					}
+
+					stack[position] = CHILD;
+				}
+			}
+		}
+
+	private: // functions
+		template<typename CallbackT>
+		inline bool				report_leaf(		const StackEntry&	LEAF,
+													CallbackT&&			callback) const
+		{
+			for(uint32_t i = LEAF.child; i < LEAF.child + LEAF.count; ++i)
+			{
+				if(!callback(m_indices[i]))
+					return false;
+			}
+
+			return true;
+		}
+
+		template<typename CallbackT>
+		inline float			report_leaf(		const StackEntry&	LEAF,
+													CallbackT&&			callback,
+													float				maxDistance) const
+		{
+			for(uint32_t i = LEAF.child; i < LEAF.child + LEAF.count; ++i)
+			{
+				maxDistance = callback(m_indices[i], LEAF.distance);
+				if(maxDistance <= 0.f)
+					break;
+			}
+
+			return maxDistance;
+		}
+
+		uint32_t				collapse(			const BVH&			BINARY,
+													const uint32_t		BINARY_NODE_ID);
+
+		static void				set_lane(			Node&				node,
+													const uint32_t		LANE,
+													const BVH::Node&	BINARY_NODE,
+													const uint32_t		CHILD);
+
+		static void				clear_lane(			Node&				node,
+													const uint32_t		LANE);
+	};
+
+
+	using	BVH4 = WideBVH<4>;
+	using	BVH8 = WideBVH<8>;
+}
\ No newline at end of file
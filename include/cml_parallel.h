@@ -0,0 +1,73 @@
+#pragma once
+
+
+#include <future>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+
+namespace cml
+{
+	/*
+		Returns number of threads that can run concurrently(at least 1).
+	*/
+	inline uint32_t		get_numWorkers()
+	{
+		static const uint32_t NUM_WORKERS = std::max(std::thread::hardware_concurrency(), 1u);
+		return NUM_WORKERS;
+	}
+
+	/*
+		Splits range [BEGIN, END) into contiguous batches of at least MIN_BATCH_SIZE elements
+		and calls function(batchBegin, batchEnd, workerID) for each of them on separate threads.
+		The calling thread processes the first batch and waits for the others.
+		Worker IDs are in range [0, get_numWorkers()), so they can be used to index per-worker scratch data.
+		Exceptions thrown by the function are rethrown in the calling thread.
+	*/
+	template<typename FunctionT>
+	void				parallel_for(	const uint32_t		BEGIN,
+										const uint32_t		END,
+										const uint32_t		MIN_BATCH_SIZE,
+										FunctionT&&			function)
+	{
+		if(END <= BEGIN)
+			return;
+
+		const uint32_t COUNT		= END - BEGIN;
+		const uint32_t MAX_BATCHES	= (COUNT + std::max(MIN_BATCH_SIZE, 1u) - 1) / std::max(MIN_BATCH_SIZE, 1u);
+		const uint32_t NUM_BATCHES	= std::min(get_numWorkers(), MAX_BATCHES);
+
+		if(NUM_BATCHES <= 1)
+		{
+			function(BEGIN, END, 0u);
+			return;
+		}
+
+		const uint32_t BATCH_SIZE = COUNT / NUM_BATCHES;
+		const uint32_t REMAINDER	= COUNT % NUM_BATCHES;
+
+		auto get_batch_begin = [&](const uint32_t BATCH_ID)
+		{
+			return BEGIN + BATCH_ID * BATCH_SIZE + std::min(BATCH_ID, REMAINDER);
+		};
+
+		std::vector<std::future<void>> tasks;
+		tasks.reserve(NUM_BATCHES - 1);
+
+		for(uint32_t batchID = 1; batchID < NUM_BATCHES; ++batchID)
+		{
+			tasks.push_back(std::async(std::launch::async, [&, batchID]()
+			{
+				function(get_batch_begin(batchID), get_batch_begin(batchID + 1), batchID);
+			}));
+		}
+
+		function(get_batch_begin(0), get_batch_begin(1), 0u);
+
+		for(auto& iTask : tasks)
+		{
+			iTask.get();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+ * Monotonic arena used for the structures of the sweep.
+ *
+ * Objects are constructed in large blocks and are never freed one by one,
+ * all of them are released at once with Reset, which keeps the blocks for the next triangulation.
+ * Destructors are not called, so only trivially destructible types should be allocated.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <assert.h>
+
+namespace p2t {
+
+class Arena {
+public:
+
+/// Constructor - no memory is allocated until the first object
+explicit Arena(size_t block_size = 32 * 1024) :
+  block_size_(block_size),
+  block_(0),
+  offset_(0)
+{
+}
+
+/// Destructor - frees all blocks
+~Arena()
+{
+  Reset();
+  for (size_t i = 0; i < blocks_.size(); i++) {
+    ::operator delete(blocks_[i]);
+  }
+}
+
+Arena(const Arena&) = delete;
+Arena& operator=(const Arena&) = delete;
+
+/// Allocates aligned memory that is valid until the next Reset
+void* Allocate(size_t size, size_t alignment)
+{
+  assert(alignment <= alignof(std::max_align_t));
+
+  // Objects larger than the block get their own allocation.
+  if (size > block_size_) {
+    large_blocks_.push_back(::operator new(size));
+    return large_blocks_.back();
+  }
+
+  size_t offset = (offset_ + alignment - 1) & ~(alignment - 1);
+
+  if (block_ == blocks_.size() || offset + size > block_size_) {
+    if (block_ < blocks_.size())
+      block_++;
+    if (block_ == blocks_.size())
+      blocks_.push_back(::operator new(block_size_));
+    offset = 0;
+  }
+
+  offset_ = offset + size;
+  return static_cast<char*>(blocks_[block_]) + offset;
+}
+
+template<typename T, typename... Args>
+T* New(Args&&... args)
+{
+  return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+}
+
+/// Releases all objects, blocks are kept for reuse
+void Reset()
+{
+  for (size_t i = 0; i < large_blocks_.size(); i++) {
+    ::operator delete(large_blocks_[i]);
+  }
+  large_blocks_.clear();
+  block_ = 0;
+  offset_ = 0;
+}
+
+private:
+
+size_t block_size_;
+/// Index of the current block, equal to the number of blocks before the first allocation
+size_t block_;
+/// First free byte of the current block
+size_t offset_;
+
+std::vector<void*> blocks_;
+std::vector<void*> large_blocks_;
+
+};
+
+}
+
+#endif
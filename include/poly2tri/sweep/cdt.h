@@ -52,8 +52,10 @@ public:
    * Constructor - add polyline with non repeating points
    * 
    * @param polyline
+   * @param arena - memory of the sweep structures, it is reset by the caller after the CDT is destroyed.
+   *                Internal arena is used when it is NULL.
    */
-  CDT(std::vector<Point*> polyline);
+  CDT(const std::vector<Point*>& polyline, Arena* arena = NULL);
   
    /**
    * Destructor - clean up memory
@@ -65,7 +67,7 @@ public:
    * 
    * @param polyline
    */
-  void AddHole(std::vector<Point*> polyline);
+  void AddHole(const std::vector<Point*>& polyline);
   
   /**
    * Add a steiner point
@@ -82,12 +84,12 @@ public:
   /**
    * Get CDT triangles
    */
-  std::vector<Triangle*> GetTriangles();
+  const std::vector<Triangle*>& GetTriangles();
   
   /**
    * Get triangle map
    */
-  std::list<Triangle*> GetMap();
+  const std::vector<Triangle*>& GetMap();
 
   private:
 
@@ -95,8 +97,9 @@ public:
    * Internals
    */
    
-  SweepContext* sweep_context_;
-  Sweep* sweep_;
+  Arena own_arena_;
+  SweepContext sweep_context_;
+  Sweep sweep_;
 
 };
 
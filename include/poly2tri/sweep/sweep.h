@@ -60,11 +60,6 @@ public:
    * @param tcx
    */
   void Triangulate(SweepContext& tcx);
-  
-  /**
-   * Destructor - clean up memory
-   */
-  ~Sweep();
 
 private:
 
@@ -277,8 +272,6 @@ private:
 
   void FinalizationPolygon(SweepContext& tcx);
 
-  std::vector<Node*> nodes_;
-
 };
 
 }
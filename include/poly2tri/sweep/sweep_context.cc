@@ -34,7 +34,8 @@
 
 namespace p2t {
 
-SweepContext::SweepContext(std::vector<Point*> polyline) :
+SweepContext::SweepContext(const std::vector<Point*>& polyline, Arena& arena) :
+  arena_(arena),
   front_(0),
   head_(0),
   tail_(0),
@@ -50,7 +51,7 @@ SweepContext::SweepContext(std::vector<Point*> polyline) :
   InitEdges(points_);
 }
 
-void SweepContext::AddHole(std::vector<Point*> polyline)
+void SweepContext::AddHole(const std::vector<Point*>& polyline)
 {
   InitEdges(polyline);
   for(unsigned int i = 0; i < polyline.size(); i++) {
@@ -62,12 +63,12 @@ void SweepContext::AddPoint(Point* point) {
   points_.push_back(point);
 }
 
-std::vector<Triangle*> SweepContext::GetTriangles()
+const std::vector<Triangle*>& SweepContext::GetTriangles()
 {
   return triangles_;
 }
 
-std::list<Triangle*> SweepContext::GetMap()
+const std::vector<Triangle*>& SweepContext::GetMap()
 {
   return map_;
 }
@@ -92,20 +93,21 @@ void SweepContext::InitTriangulation()
 
   P2T_PRECISION_TYPE dx = kAlpha * (xmax - xmin);
   P2T_PRECISION_TYPE dy = kAlpha * (ymax - ymin);
-  head_ = new Point(xmax + dx, ymin - dy);
-  tail_ = new Point(xmin - dx, ymin - dy);
+  head_ = arena_.New<Point>(xmax + dx, ymin - dy);
+  tail_ = arena_.New<Point>(xmin - dx, ymin - dy);
 
   // Sort points along y-axis
   std::sort(points_.begin(), points_.end(), cmp);
 
 }
 
-void SweepContext::InitEdges(std::vector<Point*> polyline)
+void SweepContext::InitEdges(const std::vector<Point*>& polyline)
 {
   uint64_t num_points = polyline.size();
+  edge_list.reserve(edge_list.size() + num_points);
   for (uint64_t i = 0; i < num_points; i++) {
     uint64_t j = i < num_points - 1 ? i + 1 : 0;
-    edge_list.push_back(new Edge(*polyline[i], *polyline[j]));
+    edge_list.push_back(arena_.New<Edge>(*polyline[i], *polyline[j]));
   }
 }
 
@@ -125,19 +127,17 @@ Node& SweepContext::LocateNode(Point& point)
   return *front_->LocateNode(point.x);
 }
 
-void SweepContext::CreateAdvancingFront(std::vector<Node*> nodes)
+void SweepContext::CreateAdvancingFront()
 {
-
-  (void) nodes;
   // Initial triangle
-  Triangle* triangle = new Triangle(*points_[0], *tail_, *head_);
+  Triangle* triangle = arena_.New<Triangle>(*points_[0], *tail_, *head_);
 
   map_.push_back(triangle);
 
-  af_head_ = new Node(*triangle->GetPoint(1), *triangle);
-  af_middle_ = new Node(*triangle->GetPoint(0), *triangle);
-  af_tail_ = new Node(*triangle->GetPoint(2));
-  front_ = new AdvancingFront(*af_head_, *af_tail_);
+  af_head_ = arena_.New<Node>(*triangle->GetPoint(1), *triangle);
+  af_middle_ = arena_.New<Node>(*triangle->GetPoint(0), *triangle);
+  af_tail_ = arena_.New<Node>(*triangle->GetPoint(2));
+  front_ = arena_.New<AdvancingFront>(*af_head_, *af_tail_);
 
   // TODO: More intuitive if head is middles next and not previous?
   //       so swap head and tail
@@ -149,7 +149,8 @@ void SweepContext::CreateAdvancingFront(std::vector<Node*> nodes)
 
 void SweepContext::RemoveNode(Node* node)
 {
-  delete node;
+  // Node stays in the arena until it is reset.
+  (void) node;
 }
 
 void SweepContext::MapTriangleToNodes(Triangle& t)
@@ -165,7 +166,7 @@ void SweepContext::MapTriangleToNodes(Triangle& t)
 
 void SweepContext::RemoveFromMap(Triangle* triangle)
 {
-  map_.remove(triangle);
+  map_.erase(std::remove(map_.begin(), map_.end(), triangle), map_.end());
 }
 
 void SweepContext::MeshClean(Triangle& triangle)
@@ -190,27 +191,12 @@ void SweepContext::MeshClean(Triangle& triangle)
 
 SweepContext::~SweepContext()
 {
-
-    // Clean up memory
-
-    delete head_;
-    delete tail_;
-    delete front_;
-    delete af_head_;
-    delete af_middle_;
-    delete af_tail_;
-
-    typedef std::list<Triangle*> type_list;
-
-    for(type_list::iterator iter = map_.begin(); iter != map_.end(); ++iter) {
-        Triangle* ptr = *iter;
-        delete ptr;
-    }
-
-     for(unsigned int i = 0; i < edge_list.size(); i++) {
-        delete edge_list[i];
-    }
-
+  // Triangles, nodes and edges are released with the arena,
+  // only the points own memory(edge list), so they are destroyed explicitly.
+  if (head_)
+    head_->~Point();
+  if (tail_)
+    tail_->~Point();
 }
 
 }
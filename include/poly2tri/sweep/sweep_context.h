@@ -32,10 +32,10 @@
 #ifndef SWEEP_CONTEXT_H
 #define SWEEP_CONTEXT_H
 
-#include <list>
 #include <vector>
 #include <cstddef>
 #include "..//common/p2t.h"
+#include "..//common/arena.h"
 
 namespace p2t {
 
@@ -52,11 +52,13 @@ class AdvancingFront;
 class SweepContext {
 public:
 
-/// Constructor
-SweepContext(std::vector<Point*> polyline);
+/// Constructor - triangles, nodes and edges are allocated from the arena, which must outlive the context
+SweepContext(const std::vector<Point*>& polyline, Arena& arena);
 /// Destructor
 ~SweepContext();
 
+Arena& arena();
+
 void set_head(Point* p1);
 
 Point* head();
@@ -71,7 +73,7 @@ Node& LocateNode(Point& point);
 
 void RemoveNode(Node* node);
 
-void CreateAdvancingFront(std::vector<Node*> nodes);
+void CreateAdvancingFront();
 
 /// Try to map a node to all sides of this triangle that don't have a neighbor
 void MapTriangleToNodes(Triangle& t);
@@ -84,7 +86,7 @@ Point* GetPoints();
 
 void RemoveFromMap(Triangle* triangle);
 
-void AddHole(std::vector<Point*> polyline);
+void AddHole(const std::vector<Point*>& polyline);
 
 void AddPoint(Point* point);
 
@@ -92,8 +94,8 @@ AdvancingFront* front();
 
 void MeshClean(Triangle& triangle);
 
-std::vector<Triangle*> GetTriangles();
-std::list<Triangle*> GetMap();
+const std::vector<Triangle*>& GetTriangles();
+const std::vector<Triangle*>& GetMap();
 
 std::vector<Edge*> edge_list;
 
@@ -134,8 +136,10 @@ private:
 
 friend class Sweep;
 
+Arena& arena_;
+
 std::vector<Triangle*> triangles_;
-std::list<Triangle*> map_;
+std::vector<Triangle*> map_;
 std::vector<Point*> points_;
 
 // Advancing front
@@ -148,10 +152,15 @@ Point* tail_;
 Node *af_head_, *af_middle_, *af_tail_;
 
 void InitTriangulation();
-void InitEdges(std::vector<Point*> polyline);
+void InitEdges(const std::vector<Point*>& polyline);
 
 };
 
+inline Arena& SweepContext::arena()
+{
+  return arena_;
+}
+
 inline AdvancingFront* SweepContext::front()
 {
   return front_;
@@ -382,7 +382,7 @@ namespace cml
 
 	bool		AABB::above(				const Plane&		plane) const
 	{
-		float signedDistance = calculate_dot(plane.normal, center() - plane.distance());
+		float signedDistance = plane.point_distance(center());
 
 		if(signedDistance <= 0.f)
 			return false;
@@ -392,7 +392,7 @@ namespace cml
 
 	bool		AABB::below(				const Plane&		plane) const
 	{
-		float signedDistance = calculate_dot(plane.normal, center() - plane.distance());
+		float signedDistance = plane.point_distance(center());
 
 		if(signedDistance >= 0.f)
 			return false;
@@ -502,6 +502,22 @@ namespace cml
 		return true;
 	}
 
+	bool		AABB::intersects(			const Ray&			ray,
+											float&				entryDistance,
+											float&				exitDistance) const
+	{
+		const Vec3 INVERSE_DIRECTION	= ray.calculate_inverse_direction();
+		const Vec3 TO_MIN				= (min() - ray.origin()) * INVERSE_DIRECTION;
+		const Vec3 TO_MAX				= (max() - ray.origin()) * INVERSE_DIRECTION;
+		const Vec3 NEAR					= glm::min(TO_MIN, TO_MAX);
+		const Vec3 FAR					= glm::max(TO_MIN, TO_MAX);
+
+		entryDistance	= glm::max(glm::max(NEAR.x, NEAR.y), glm::max(NEAR.z, 0.f));
+		exitDistance	= glm::min(glm::min(FAR.x, FAR.y), glm::min(FAR.z, FLOAT_INFINITY));
+
+		return entryDistance <= exitDistance;
+	}
+
 	bool		AABB::intersects(			const Vec3&			point) const
 	{
 		if (abs(center().x - point.x) > halfWidth())
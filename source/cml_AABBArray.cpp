@@ -0,0 +1,281 @@
+#include "../include/cml_AABBArray.h"
+#include "../include/cml_Ray.h"
+#include "../include/cml_Plane.h"
+#include "../include/cml_ConvexHull.h"
+#include <algorithm>
+
+
+namespace cml
+{
+	inline uint32_t	calculate_padded_size(	const uint32_t		NUM_BOXES)
+	{
+		return ((NUM_BOXES + AABBArray::LANE_WIDTH - 1) / AABBArray::LANE_WIDTH) * AABBArray::LANE_WIDTH;
+	}
+
+
+//=====> AABBArray -> public lifecycle
+	CLASS_CTOR	AABBArray::AABBArray(		const AABB*			BOXES,
+											const uint32_t		NUM_BOXES)
+		: m_size(0)
+	{
+		reset(BOXES, NUM_BOXES);
+	}
+
+//=====> AABBArray -> public functions
+	void		AABBArray::reserve(			const uint32_t		NUM_BOXES)
+	{
+		const uint32_t PADDED_SIZE = calculate_padded_size(NUM_BOXES);
+
+		m_centerX.reserve(PADDED_SIZE);
+		m_centerY.reserve(PADDED_SIZE);
+		m_centerZ.reserve(PADDED_SIZE);
+		m_extentX.reserve(PADDED_SIZE);
+		m_extentY.reserve(PADDED_SIZE);
+		m_extentZ.reserve(PADDED_SIZE);
+	}
+
+	void		AABBArray::clear()
+	{
+		resize_streams(0);
+	}
+
+	void		AABBArray::reset(			const AABB*			BOXES,
+											const uint32_t		NUM_BOXES)
+	{
+		resize_streams(BOXES ? NUM_BOXES : 0);
+
+		for(uint32_t index = 0; index < m_size; ++index)
+		{
+			set(index, BOXES[index]);
+		}
+	}
+
+	uint32_t	AABBArray::add(				const AABB&			BOX)
+	{
+		const uint32_t INDEX = m_size;
+		resize_streams(m_size + 1);
+		set(INDEX, BOX);
+		return INDEX;
+	}
+
+	void		AABBArray::set(				const uint32_t		INDEX,
+											const AABB&			BOX)
+	{
+		validate_index(INDEX);
+
+		m_centerX[INDEX] = BOX.center().x;
+		m_centerY[INDEX] = BOX.center().y;
+		m_centerZ[INDEX] = BOX.center().z;
+		m_extentX[INDEX] = BOX.halfWidth();
+		m_extentY[INDEX] = BOX.halfHeight();
+		m_extentZ[INDEX] = BOX.halfDepth();
+	}
+
+	AABB		AABBArray::get(				const uint32_t		INDEX) const
+	{
+		validate_index(INDEX);
+
+		const Vec3 CENTER(m_centerX[INDEX], m_centerY[INDEX], m_centerZ[INDEX]);
+		const Vec3 EXTENTS(m_extentX[INDEX], m_extentY[INDEX], m_extentZ[INDEX]);
+
+		return AABB(CENTER - EXTENTS, CENTER + EXTENTS);
+	}
+
+	void		AABBArray::remove_swap(		const uint32_t		INDEX)
+	{
+		validate_index(INDEX);
+
+		const uint32_t LAST = m_size - 1;
+
+		m_centerX[INDEX] = m_centerX[LAST];
+		m_centerY[INDEX] = m_centerY[LAST];
+		m_centerZ[INDEX] = m_centerZ[LAST];
+		m_extentX[INDEX] = m_extentX[LAST];
+		m_extentY[INDEX] = m_extentY[LAST];
+		m_extentZ[INDEX] = m_extentZ[LAST];
+
+		resize_streams(LAST);
+	}
+
+//=====> AABBArray -> public culling
+	uint32_t	AABBArray::cull(			const ConvexHull&	CONVEX_HULL,
+											uint8_t*			outputMask) const
+	{
+		uint32_t numVisible = 0;
+		uint8_t	 laneMask[LANE_WIDTH];
+
+		const uint32_t NUM_BLOCKS = get_numBlocks();
+
+		for(uint32_t blockID = 0; blockID < NUM_BLOCKS; ++blockID)
+		{
+			cull_block(CONVEX_HULL, blockID, laneMask);
+
+			const uint32_t OFFSET		= blockID * LANE_WIDTH;
+			const uint32_t NUM_LANES	= glm::min(LANE_WIDTH, m_size - OFFSET);
+
+			for(uint32_t lane = 0; lane < NUM_LANES; ++lane)
+			{
+				outputMask[OFFSET + lane]	= laneMask[lane];
+				numVisible					+= laneMask[lane];
+			}
+		}
+
+		return numVisible;
+	}
+
+	uint32_t	AABBArray::cull(			const ConvexHull&	CONVEX_HULL,
+											Indices&			outputIndices) const
+	{
+		const uint64_t	OLD_SIZE = outputIndices.size();
+		uint8_t			laneMask[LANE_WIDTH];
+
+		const uint32_t NUM_BLOCKS = get_numBlocks();
+
+		for(uint32_t blockID = 0; blockID < NUM_BLOCKS; ++blockID)
+		{
+			cull_block(CONVEX_HULL, blockID, laneMask);
+
+			const uint32_t OFFSET		= blockID * LANE_WIDTH;
+			const uint32_t NUM_LANES	= glm::min(LANE_WIDTH, m_size - OFFSET);
+
+			for(uint32_t lane = 0; lane < NUM_LANES; ++lane)
+			{
+				if(laneMask[lane])
+					outputIndices.push_back(OFFSET + lane);
+			}
+		}
+
+		return static_cast<uint32_t>(outputIndices.size() - OLD_SIZE);
+	}
+
+//=====> AABBArray -> public ray tests
+	uint32_t	AABBArray::intersects(		const Ray&			RAY,
+											uint8_t*			outputMask,
+											float*				entryDistances,
+											float*				exitDistances,
+											const float			MIN_DISTANCE,
+											const float			MAX_DISTANCE) const
+	{
+		const Vec3	ORIGIN				= RAY.origin();
+		const Vec3	INVERSE_DIRECTION	= RAY.calculate_inverse_direction();
+
+		uint32_t	numHits = 0;
+		float		entry[LANE_WIDTH];
+		float		exit[LANE_WIDTH];
+		uint8_t		hit[LANE_WIDTH];
+
+		const uint32_t NUM_BLOCKS = get_numBlocks();
+
+		for(uint32_t blockID = 0; blockID < NUM_BLOCKS; ++blockID)
+		{
+			const uint32_t OFFSET = blockID * LANE_WIDTH;
+
+			const float* CX = m_centerX.data() + OFFSET;
+			const float* CY = m_centerY.data() + OFFSET;
+			const float* CZ = m_centerZ.data() + OFFSET;
+			const float* EX = m_extentX.data() + OFFSET;
+			const float* EY = m_extentY.data() + OFFSET;
+			const float* EZ = m_extentZ.data() + OFFSET;
+
+			for(uint32_t lane = 0; lane < LANE_WIDTH; ++lane)
+			{
+				const float T1X = (CX[lane] - EX[lane] - ORIGIN.x) * INVERSE_DIRECTION.x;
+				const float T2X = (CX[lane] + EX[lane] - ORIGIN.x) * INVERSE_DIRECTION.x;
+				const float T1Y = (CY[lane] - EY[lane] - ORIGIN.y) * INVERSE_DIRECTION.y;
+				const float T2Y = (CY[lane] + EY[lane] - ORIGIN.y) * INVERSE_DIRECTION.y;
+				const float T1Z = (CZ[lane] - EZ[lane] - ORIGIN.z) * INVERSE_DIRECTION.z;
+				const float T2Z = (CZ[lane] + EZ[lane] - ORIGIN.z) * INVERSE_DIRECTION.z;
+
+				entry[lane]	= glm::max(glm::max(glm::min(T1X, T2X), glm::min(T1Y, T2Y)), glm::max(glm::min(T1Z, T2Z), MIN_DISTANCE));
+				exit[lane]	= glm::min(glm::min(glm::max(T1X, T2X), glm::max(T1Y, T2Y)), glm::min(glm::max(T1Z, T2Z), MAX_DISTANCE));
+				hit[lane]	= static_cast<uint8_t>(entry[lane] <= exit[lane]);
+			}
+
+			const uint32_t NUM_LANES = glm::min(LANE_WIDTH, m_size - OFFSET);
+
+			for(uint32_t lane = 0; lane < NUM_LANES; ++lane)
+			{
+				outputMask[OFFSET + lane]	= hit[lane];
+				numHits						+= hit[lane];
+			}
+
+			if(entryDistances)
+				std::copy(entry, entry + NUM_LANES, entryDistances + OFFSET);
+
+			if(exitDistances)
+				std::copy(exit, exit + NUM_LANES, exitDistances + OFFSET);
+		}
+
+		return numHits;
+	}
+
+//=====> AABBArray -> private functions
+	void		AABBArray::resize_streams(	const uint32_t		NUM_BOXES)
+	{
+		const uint32_t PADDED_SIZE = calculate_padded_size(NUM_BOXES);
+
+		// Padding lanes are left as empty boxes at the origin.
+		m_centerX.resize(PADDED_SIZE, 0.f);
+		m_centerY.resize(PADDED_SIZE, 0.f);
+		m_centerZ.resize(PADDED_SIZE, 0.f);
+		m_extentX.resize(PADDED_SIZE, 0.f);
+		m_extentY.resize(PADDED_SIZE, 0.f);
+		m_extentZ.resize(PADDED_SIZE, 0.f);
+
+		for(uint32_t index = NUM_BOXES; index < PADDED_SIZE; ++index)
+		{
+			m_centerX[index] = 0.f;
+			m_centerY[index] = 0.f;
+			m_centerZ[index] = 0.f;
+			m_extentX[index] = 0.f;
+			m_extentY[index] = 0.f;
+			m_extentZ[index] = 0.f;
+		}
+
+		m_size = NUM_BOXES;
+	}
+
+	void		AABBArray::cull_block(		const ConvexHull&	CONVEX_HULL,
+											const uint32_t		BLOCK_ID,
+											uint8_t*			laneMask) const
+	{
+		const uint32_t OFFSET = BLOCK_ID * LANE_WIDTH;
+
+		const float* CX = m_centerX.data() + OFFSET;
+		const float* CY = m_centerY.data() + OFFSET;
+		const float* CZ = m_centerZ.data() + OFFSET;
+		const float* EX = m_extentX.data() + OFFSET;
+		const float* EY = m_extentY.data() + OFFSET;
+		const float* EZ = m_extentZ.data() + OFFSET;
+
+		// Lane is set when its box lies entirely above at least one face.
+		uint32_t outside[LANE_WIDTH] = {};
+
+		for(auto& iFace : CONVEX_HULL.faces())
+		{
+			const Vec3&	NORMAL		= iFace.normal();
+			const Vec3	ABS_NORMAL	= glm::abs(NORMAL);
+			const float	DISTANCE	= iFace.distance();
+
+			uint32_t numOutside = 0;
+
+			// Same test as AABB::above, evaluated for the whole block without branches.
+			for(uint32_t lane = 0; lane < LANE_WIDTH; ++lane)
+			{
+				const float SIGNED_DISTANCE = NORMAL.x * CX[lane] + NORMAL.y * CY[lane] + NORMAL.z * CZ[lane] - DISTANCE;
+				const float PROJECTED_SIZE	= ABS_NORMAL.x * EX[lane] + ABS_NORMAL.y * EY[lane] + ABS_NORMAL.z * EZ[lane];
+
+				outside[lane]	|= static_cast<uint32_t>(SIGNED_DISTANCE > PROJECTED_SIZE);
+				numOutside		+= outside[lane];
+			}
+
+			if(numOutside == LANE_WIDTH)
+				break; // Every box in this block is already rejected.
+		}
+
+		for(uint32_t lane = 0; lane < LANE_WIDTH; ++lane)
+		{
+			laneMask[lane] = static_cast<uint8_t>(outside[lane] ^ 1);
+		}
+	}
+}
\ No newline at end of file
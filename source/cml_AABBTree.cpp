@@ -0,0 +1,398 @@
+#include "../include/cml_AABBTree.h"
+
+
+namespace cml
+{
+	inline AABB		calculate_union(		const AABB&			A,
+											const AABB&			B)
+	{
+		return AABB(glm::min(A.min(), B.min()), glm::max(A.max(), B.max()));
+	}
+
+	/*
+		Surface area heuristic only compares costs, so half of the surface area is enough.
+	*/
+	inline float	calculate_half_area(	const AABB&			BOX)
+	{
+		return BOX.width() * BOX.height() + BOX.height() * BOX.depth() + BOX.depth() * BOX.width();
+	}
+
+
+//=====> AABBTree -> public lifecycle
+	CLASS_CTOR	AABBTree::AABBTree(			const float			FAT_MARGIN)
+		: m_root(NULL_NODE)
+		, m_freeList(NULL_NODE)
+		, m_numLeaves(0)
+		, m_margin(FAT_MARGIN)
+	{
+
+	}
+
+//=====> AABBTree -> public functions
+	void		AABBTree::clear()
+	{
+		m_nodes.clear();
+		m_root		= NULL_NODE;
+		m_freeList	= NULL_NODE;
+		m_numLeaves	= 0;
+	}
+
+	uint32_t	AABBTree::insert(			const AABB&			BOX,
+											const uint32_t		OBJECT_ID)
+	{
+		const Vec3		MARGIN(m_margin, m_margin, m_margin);
+		const uint32_t	PROXY_ID = allocate_node();
+
+		Node& leaf		= m_nodes[PROXY_ID];
+		leaf.box		= AABB(BOX.min() - MARGIN, BOX.max() + MARGIN);
+		leaf.objectID	= OBJECT_ID;
+		leaf.height		= 0;
+
+		insert_leaf(PROXY_ID);
+		++m_numLeaves;
+		return PROXY_ID;
+	}
+
+	void		AABBTree::remove(			const uint32_t		PROXY_ID)
+	{
+		validate_proxy(PROXY_ID);
+		remove_leaf(PROXY_ID);
+		free_node(PROXY_ID);
+		--m_numLeaves;
+	}
+
+	bool		AABBTree::move(				const uint32_t		PROXY_ID,
+											const AABB&			BOX,
+											const Vec3&			DISPLACEMENT)
+	{
+		validate_proxy(PROXY_ID);
+
+		if(m_nodes[PROXY_ID].box.contains(BOX))
+			return false;
+
+		remove_leaf(PROXY_ID);
+
+		// Extend fat AABB in the direction of movement, so that object can keep moving without reinsertion.
+		const Vec3 MARGIN(m_margin, m_margin, m_margin);
+		const Vec3 PREDICTION = DISPLACEMENT * DISPLACEMENT_MULTIPLIER;
+
+		m_nodes[PROXY_ID].box = AABB(BOX.min() - MARGIN + glm::min(PREDICTION, Vec3(0.f, 0.f, 0.f)),
+									 BOX.max() + MARGIN + glm::max(PREDICTION, Vec3(0.f, 0.f, 0.f)));
+
+		insert_leaf(PROXY_ID);
+		return true;
+	}
+
+	float		AABBTree::calculate_area_ratio() const
+	{
+		if(m_root == NULL_NODE)
+			return 0.f;
+
+		const float ROOT_AREA = calculate_half_area(m_nodes[m_root].box);
+		if(ROOT_AREA <= 0.f)
+			return 0.f;
+
+		float totalArea = 0.f;
+
+		for(auto& iNode : m_nodes)
+		{
+			if(iNode.height > 0)
+				totalArea += calculate_half_area(iNode.box);
+		}
+
+		return totalArea / ROOT_AREA;
+	}
+
+	void		AABBTree::validate() const
+	{
+		if(m_root != NULL_NODE && m_nodes[m_root].parent != NULL_NODE)
+			throw dpl::GeneralException(this, __LINE__, "Root node has a parent.");
+
+		const uint32_t NUM_LEAVES = validate_subtree(m_root);
+		if(NUM_LEAVES != m_numLeaves)
+			throw dpl::GeneralException(this, __LINE__, "Invalid number of leaves: " + std::to_string(NUM_LEAVES));
+
+		uint32_t numFree = 0;
+
+		for(uint32_t nodeID = m_freeList; nodeID != NULL_NODE; nodeID = m_nodes[nodeID].parent)
+		{
+			if(m_nodes[nodeID].height != -1 || ++numFree > m_nodes.size())
+				throw dpl::GeneralException(this, __LINE__, "Free list is corrupted.");
+		}
+
+		// Full binary tree with N leaves has N-1 internal nodes.
+		const uint32_t NUM_USED = (m_numLeaves > 0) ? 2 * m_numLeaves - 1 : 0;
+		if(NUM_USED + numFree != m_nodes.size())
+			throw dpl::GeneralException(this, __LINE__, "Some nodes are neither used nor free.");
+	}
+
+//=====> AABBTree -> private functions
+	uint32_t	AABBTree::allocate_node()
+	{
+		uint32_t nodeID = m_freeList;
+
+		if(nodeID != NULL_NODE)
+		{
+			m_freeList = m_nodes[nodeID].parent;
+		}
+		else
+		{
+			nodeID = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+
+		Node& node		= m_nodes[nodeID];
+		node.parent		= NULL_NODE;
+		node.left		= NULL_NODE;
+		node.right		= NULL_NODE;
+		node.objectID	= NULL_NODE;
+		node.height		= 0;
+		return nodeID;
+	}
+
+	void		AABBTree::free_node(		const uint32_t		NODE_ID)
+	{
+		Node& node	= m_nodes[NODE_ID];
+		node.parent	= m_freeList;
+		node.height	= -1;
+		m_freeList	= NODE_ID;
+	}
+
+	void		AABBTree::insert_leaf(		const uint32_t		LEAF_ID)
+	{
+		if(m_root == NULL_NODE)
+		{
+			m_root = LEAF_ID;
+			m_nodes[LEAF_ID].parent = NULL_NODE;
+			return;
+		}
+
+		// Find the best sibling by descending into the child with lower cost.
+		const AABB	LEAF_BOX	= m_nodes[LEAF_ID].box;
+		uint32_t	nodeID		= m_root;
+
+		while(!m_nodes[nodeID].is_leaf())
+		{
+			const Node& NODE = m_nodes[nodeID];
+
+			const float AREA			= calculate_half_area(NODE.box);
+			const float COMBINED_AREA	= calculate_half_area(calculate_union(NODE.box, LEAF_BOX));
+
+			// Cost of creating a new parent for this node and the new leaf.
+			const float COST = 2.f * COMBINED_AREA;
+
+			// Minimum cost of pushing the leaf further down the tree.
+			const float INHERITANCE_COST = 2.f * (COMBINED_AREA - AREA);
+
+			auto calculate_descent_cost = [&](const uint32_t CHILD_ID)
+			{
+				const Node& CHILD		= m_nodes[CHILD_ID];
+				const float NEW_AREA	= calculate_half_area(calculate_union(CHILD.box, LEAF_BOX));
+
+				return CHILD.is_leaf() ? NEW_AREA + INHERITANCE_COST
+									   : NEW_AREA - calculate_half_area(CHILD.box) + INHERITANCE_COST;
+			};
+
+			const float LEFT_COST	= calculate_descent_cost(NODE.left);
+			const float RIGHT_COST	= calculate_descent_cost(NODE.right);
+
+			if(COST < LEFT_COST && COST < RIGHT_COST)
+				break;
+
+			nodeID = (LEFT_COST < RIGHT_COST) ? NODE.left : NODE.right;
+		}
+
+		const uint32_t SIBLING_ID		= nodeID;
+		const uint32_t OLD_PARENT_ID	= m_nodes[SIBLING_ID].parent;
+		const uint32_t NEW_PARENT_ID	= allocate_node();
+
+		Node& newParent		= m_nodes[NEW_PARENT_ID];
+		newParent.parent	= OLD_PARENT_ID;
+		newParent.left		= SIBLING_ID;
+		newParent.right		= LEAF_ID;
+		newParent.box		= calculate_union(LEAF_BOX, m_nodes[SIBLING_ID].box);
+		newParent.height	= m_nodes[SIBLING_ID].height + 1;
+
+		if(OLD_PARENT_ID != NULL_NODE)
+		{
+			Node& oldParent = m_nodes[OLD_PARENT_ID];
+
+			if(oldParent.left == SIBLING_ID)
+				oldParent.left	= NEW_PARENT_ID;
+			else
+				oldParent.right = NEW_PARENT_ID;
+		}
+		else
+		{
+			m_root = NEW_PARENT_ID;
+		}
+
+		m_nodes[SIBLING_ID].parent	= NEW_PARENT_ID;
+		m_nodes[LEAF_ID].parent		= NEW_PARENT_ID;
+
+		refit_ancestors(OLD_PARENT_ID);
+	}
+
+	void		AABBTree::remove_leaf(		const uint32_t		LEAF_ID)
+	{
+		if(LEAF_ID == m_root)
+		{
+			m_root = NULL_NODE;
+			return;
+		}
+
+		const uint32_t PARENT_ID		= m_nodes[LEAF_ID].parent;
+		const uint32_t GRAND_PARENT_ID	= m_nodes[PARENT_ID].parent;
+		const uint32_t SIBLING_ID		= (m_nodes[PARENT_ID].left == LEAF_ID) ? m_nodes[PARENT_ID].right : m_nodes[PARENT_ID].left;
+
+		// Parent is replaced with the sibling.
+		if(GRAND_PARENT_ID != NULL_NODE)
+		{
+			Node& grandParent = m_nodes[GRAND_PARENT_ID];
+
+			if(grandParent.left == PARENT_ID)
+				grandParent.left	= SIBLING_ID;
+			else
+				grandParent.right	= SIBLING_ID;
+		}
+		else
+		{
+			m_root = SIBLING_ID;
+		}
+
+		m_nodes[SIBLING_ID].parent = GRAND_PARENT_ID;
+		free_node(PARENT_ID);
+		refit_ancestors(GRAND_PARENT_ID);
+	}
+
+	uint32_t	AABBTree::balance(			const uint32_t		NODE_ID)
+	{
+		const uint32_t A_ID = NODE_ID;
+		Node& A = m_nodes[A_ID];
+
+		if(A.is_leaf() || A.height < 2)
+			return A_ID;
+
+		const uint32_t B_ID = A.left;
+		const uint32_t C_ID = A.right;
+		Node& B = m_nodes[B_ID];
+		Node& C = m_nodes[C_ID];
+
+		const int32_t BALANCE = C.height - B.height;
+
+		/*
+			Promotes higher child(X) of A in place of A.
+			Higher grandchild stays under X while A adopts the lower one.
+		*/
+		auto rotate = [&](const uint32_t X_ID, Node& X, const uint32_t, Node& other, const bool bX_IS_RIGHT)
+		{
+			const uint32_t F_ID = X.left;
+			const uint32_t G_ID = X.right;
+			Node& F = m_nodes[F_ID];
+			Node& G = m_nodes[G_ID];
+
+			// Swap A and X.
+			X.left		= A_ID;
+			X.parent	= A.parent;
+			A.parent	= X_ID;
+
+			if(X.parent != NULL_NODE)
+			{
+				Node& xParent = m_nodes[X.parent];
+
+				if(xParent.left == A_ID)
+					xParent.left	= X_ID;
+				else
+					xParent.right	= X_ID;
+			}
+			else
+			{
+				m_root = X_ID;
+			}
+
+			const bool		bF_HIGHER	= F.height > G.height;
+			const uint32_t	HIGH_ID		= bF_HIGHER ? F_ID : G_ID;
+			const uint32_t	LOW_ID		= bF_HIGHER ? G_ID : F_ID;
+			Node&			high		= m_nodes[HIGH_ID];
+			Node&			low			= m_nodes[LOW_ID];
+
+			X.right = HIGH_ID;
+
+			if(bX_IS_RIGHT)
+				A.right = LOW_ID;
+			else
+				A.left	= LOW_ID;
+
+			low.parent = A_ID;
+
+			A.box		= calculate_union(other.box, low.box);
+			X.box		= calculate_union(A.box, high.box);
+			A.height	= 1 + glm::max(other.height, low.height);
+			X.height	= 1 + glm::max(A.height, high.height);
+		};
+
+		if(BALANCE > 1)
+		{
+			rotate(C_ID, C, B_ID, B, true);
+			return C_ID;
+		}
+
+		if(BALANCE < -1)
+		{
+			rotate(B_ID, B, C_ID, C, false);
+			return B_ID;
+		}
+
+		return A_ID;
+	}
+
+	void		AABBTree::refit_ancestors(	uint32_t			nodeID)
+	{
+		while(nodeID != NULL_NODE)
+		{
+			nodeID = balance(nodeID);
+
+			Node&		node	= m_nodes[nodeID];
+			const Node&	LEFT	= m_nodes[node.left];
+			const Node&	RIGHT	= m_nodes[node.right];
+
+			node.height	= 1 + glm::max(LEFT.height, RIGHT.height);
+			node.box	= calculate_union(LEFT.box, RIGHT.box);
+			nodeID		= node.parent;
+		}
+	}
+
+	uint32_t	AABBTree::validate_subtree(	const uint32_t		NODE_ID) const
+	{
+		if(NODE_ID == NULL_NODE)
+			return 0;
+
+		const Node& NODE = m_nodes[NODE_ID];
+
+		if(NODE.is_leaf())
+		{
+			if(NODE.right != NULL_NODE || NODE.height != 0)
+				throw dpl::GeneralException(this, __LINE__, "Invalid leaf: " + std::to_string(NODE_ID));
+
+			return 1;
+		}
+
+		const Node& LEFT	= m_nodes[NODE.left];
+		const Node& RIGHT	= m_nodes[NODE.right];
+
+		if(LEFT.parent != NODE_ID || RIGHT.parent != NODE_ID)
+			throw dpl::GeneralException(this, __LINE__, "Invalid parent of the children of node: " + std::to_string(NODE_ID));
+
+		if(NODE.height != 1 + glm::max(LEFT.height, RIGHT.height))
+			throw dpl::GeneralException(this, __LINE__, "Invalid height of node: " + std::to_string(NODE_ID));
+
+		// Boxes are stored as center and extents, so that their union is exact only up to the rounding error.
+		const Vec3 TOLERANCE		= glm::max(glm::abs(NODE.box.min()), glm::abs(NODE.box.max())) * 0.0001f + 0.0001f;
+		const AABB TOLERANT_BOX(NODE.box.min() - TOLERANCE, NODE.box.max() + TOLERANCE);
+
+		if(!TOLERANT_BOX.contains(LEFT.box) || !TOLERANT_BOX.contains(RIGHT.box))
+			throw dpl::GeneralException(this, __LINE__, "Node does not enclose its children: " + std::to_string(NODE_ID));
+
+		return validate_subtree(NODE.left) + validate_subtree(NODE.right);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,772 @@
+#include "../include/cml_BVH.h"
+#include "../include/cml_parallel.h"
+#include <atomic>
+#include <bit>
+#include <array>
+
+
+namespace cml
+{
+	/*
+		Surface area heuristic only compares costs, so half of the surface area is enough.
+	*/
+	inline float	calculate_half_area(	const Vec3&			MIN,
+											const Vec3&			MAX)
+	{
+		const Vec3 SIZE = glm::max(MAX - MIN, Vec3(0.f, 0.f, 0.f));
+		return SIZE.x * SIZE.y + SIZE.y * SIZE.z + SIZE.z * SIZE.x;
+	}
+
+	/*
+		Binned SAH builder(Wald 2007). Each subtree writes only its own nodes and its own range of indices,
+		so that subtrees above PARALLEL_THRESHOLD primitives can be built by separate threads.
+	*/
+	class	BinnedBuilder
+	{
+	public: // constants
+		static constexpr uint32_t	NUM_BINS			= BVH::NUM_BINS;
+		static constexpr uint32_t	PARALLEL_THRESHOLD	= 4096;
+		static constexpr uint32_t	PARALLEL_BINNING	= 65536;
+		static constexpr float		TRAVERSAL_COST		= 1.f; // Relative to the cost of a single primitive test.
+
+	private: // subtypes
+		struct	Bounds
+		{
+			Vec3 min = Vec3( FLOAT_INFINITY,  FLOAT_INFINITY,  FLOAT_INFINITY);
+			Vec3 max = Vec3(-FLOAT_INFINITY, -FLOAT_INFINITY, -FLOAT_INFINITY);
+
+			inline void extend(const Vec3& MIN, const Vec3& MAX)
+			{
+				min = glm::min(min, MIN);
+				max = glm::max(max, MAX);
+			}
+
+			inline void extend(const Bounds& OTHER)
+			{
+				extend(OTHER.min, OTHER.max);
+			}
+		};
+
+		struct	Bin
+		{
+			Bounds		bounds;
+			uint32_t	count = 0;
+		};
+
+		struct	RangeInfo
+		{
+			Bounds		bounds;
+			Bounds		centroidBounds;
+		};
+
+		/*
+			Primitives are partitioned directly instead of their indices, so that binning reads memory sequentially.
+		*/
+		struct	Primitive
+		{
+			Vec3		min;
+			uint32_t	index;
+			Vec3		max;
+			float		padding;
+
+			inline Vec3 get_centroid() const
+			{
+				return (min + max) * 0.5f;
+			}
+		};
+
+		using	Bins = Bin[3][NUM_BINS];
+
+	private: // data
+		BVH::Node*				m_nodes;
+		uint32_t*				m_indices;
+		std::vector<Primitive>	m_primitives;
+		std::atomic<uint32_t>	m_numNodes;
+		uint32_t				m_maxLeafSize;
+		uint32_t				m_maxParallelDepth;
+
+	public: // lifecycle
+		CLASS_CTOR				BinnedBuilder(		const AABB*			BOXES,
+													const uint32_t		NUM_BOXES,
+													const uint32_t		MAX_LEAF_SIZE,
+													BVH::Node*			nodes,
+													uint32_t*			indices)
+			: m_nodes(nodes)
+			, m_indices(indices)
+			, m_primitives(NUM_BOXES)
+			, m_numNodes(1)
+			, m_maxLeafSize(glm::max(MAX_LEAF_SIZE, 1u))
+			, m_maxParallelDepth(2 + static_cast<uint32_t>(glm::log2(static_cast<float>(get_numWorkers()))))
+		{
+			parallel_for(0, NUM_BOXES, PARALLEL_THRESHOLD, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t)
+			{
+				for(uint32_t i = BEGIN; i < END; ++i)
+				{
+					m_primitives[i].min		= BOXES[i].min();
+					m_primitives[i].max		= BOXES[i].max();
+					m_primitives[i].index	= i;
+				}
+			});
+		}
+
+	public: // functions
+		inline uint32_t			get_numNodes() const
+		{
+			return m_numNodes.load();
+		}
+
+		void					build(				const uint32_t		NODE_ID,
+													const uint32_t		BEGIN,
+													const uint32_t		END,
+													const uint32_t		DEPTH)
+		{
+			const RangeInfo	INFO	= calculate_range_info(BEGIN, END);
+			const uint32_t	COUNT	= END - BEGIN;
+
+			BVH::Node& node = m_nodes[NODE_ID];
+			node.min		= INFO.bounds.min;
+			node.max		= INFO.bounds.max;
+			node.leftFirst	= BEGIN;
+			node.count		= COUNT;
+
+			const uint32_t MID = (COUNT > 1) ? split(INFO, BEGIN, END) : BEGIN;
+
+			if(MID == BEGIN) // Leaf is cheaper than any split.
+			{
+				for(uint32_t i = BEGIN; i < END; ++i)
+				{
+					m_indices[i] = m_primitives[i].index;
+				}
+
+				return;
+			}
+
+			const uint32_t LEFT_ID = m_numNodes.fetch_add(2);
+			node.leftFirst	= LEFT_ID;
+			node.count		= 0;
+
+			if(COUNT >= PARALLEL_THRESHOLD && DEPTH < m_maxParallelDepth)
+			{
+				auto leftTask = std::async(std::launch::async, [&]()
+				{
+					build(LEFT_ID, BEGIN, MID, DEPTH + 1);
+				});
+
+				build(LEFT_ID + 1, MID, END, DEPTH + 1);
+				leftTask.get();
+			}
+			else
+			{
+				build(LEFT_ID,		BEGIN,	MID, DEPTH + 1);
+				build(LEFT_ID + 1,	MID,	END, DEPTH + 1);
+			}
+		}
+
+	private: // functions
+		RangeInfo				calculate_range_info(	const uint32_t		BEGIN,
+														const uint32_t		END) const
+		{
+			auto accumulate = [&](const uint32_t FIRST, const uint32_t LAST, RangeInfo& info)
+			{
+				for(uint32_t i = FIRST; i < LAST; ++i)
+				{
+					const Primitive&	PRIMITIVE	= m_primitives[i];
+					const Vec3			CENTROID	= PRIMITIVE.get_centroid();
+
+					info.bounds.extend(PRIMITIVE.min, PRIMITIVE.max);
+					info.centroidBounds.extend(CENTROID, CENTROID);
+				}
+			};
+
+			RangeInfo output;
+
+			if(END - BEGIN < PARALLEL_BINNING)
+			{
+				accumulate(BEGIN, END, output);
+				return output;
+			}
+
+			std::vector<RangeInfo> partials(get_numWorkers());
+
+			parallel_for(BEGIN, END, PARALLEL_THRESHOLD, [&](const uint32_t FIRST, const uint32_t LAST, const uint32_t WORKER_ID)
+			{
+				accumulate(FIRST, LAST, partials[WORKER_ID]);
+			});
+
+			for(auto& iPartial : partials)
+			{
+				output.bounds.extend(iPartial.bounds);
+				output.centroidBounds.extend(iPartial.centroidBounds);
+			}
+
+			return output;
+		}
+
+		/*
+			Partitions the range by the cheapest bin plane of all three axes.
+			Returns BEGIN if leaf should be created instead.
+		*/
+		uint32_t				split(				const RangeInfo&	INFO,
+													const uint32_t		BEGIN,
+													const uint32_t		END)
+		{
+			const uint32_t	COUNT			= END - BEGIN;
+			const Vec3		CENTROID_MIN	= INFO.centroidBounds.min;
+			const Vec3		CENTROID_SIZE	= INFO.centroidBounds.max - CENTROID_MIN;
+
+			// Small nodes do not need more bins than primitives, which makes the plane sweeps cheaper.
+			const uint32_t	BIN_COUNT		= glm::min(NUM_BINS, COUNT);
+
+			// Slightly smaller scale keeps the last centroid inside the last bin.
+			Vec3 scale;
+			for(uint32_t axis = 0; axis < 3; ++axis)
+			{
+				scale[axis] = (CENTROID_SIZE[axis] > 0.f) ? (BIN_COUNT * (1.f - PLUS_EPSILON)) / CENTROID_SIZE[axis] : 0.f;
+			}
+
+			auto get_binIDs = [&](const Primitive& PRIMITIVE)
+			{
+				const UVec3 BINS((PRIMITIVE.get_centroid() - CENTROID_MIN) * scale);
+				return glm::min(BINS, UVec3(BIN_COUNT - 1));
+			};
+
+			Bins bins;
+			fill_bins(BEGIN, END, get_binIDs, bins);
+
+			float		bestCost	= FLOAT_INFINITY;
+			uint32_t	bestAxis	= 0;
+			uint32_t	bestPlane	= 0;
+
+			for(uint32_t axis = 0; axis < 3; ++axis)
+			{
+				if(scale[axis] == 0.f)
+					continue;
+
+				// Sweep from the right to find area and count of every right side.
+				float		rightCosts[NUM_BINS];
+				Bounds		rightBounds;
+				uint32_t	rightCount = 0;
+
+				for(uint32_t plane = BIN_COUNT - 1; plane > 0; --plane)
+				{
+					const Bin& BIN = bins[axis][plane];
+					rightBounds.extend(BIN.bounds);
+					rightCount += BIN.count;
+					rightCosts[plane] = (rightCount > 0) ? rightCount * calculate_half_area(rightBounds.min, rightBounds.max) : 0.f;
+				}
+
+				Bounds		leftBounds;
+				uint32_t	leftCount = 0;
+
+				for(uint32_t plane = 1; plane < BIN_COUNT; ++plane)
+				{
+					const Bin& BIN = bins[axis][plane - 1];
+					leftBounds.extend(BIN.bounds);
+					leftCount += BIN.count;
+
+					if(leftCount == 0 || leftCount == COUNT)
+						continue;
+
+					const float COST = leftCount * calculate_half_area(leftBounds.min, leftBounds.max) + rightCosts[plane];
+
+					if(COST < bestCost)
+					{
+						bestCost	= COST;
+						bestAxis	= axis;
+						bestPlane	= plane;
+					}
+				}
+			}
+
+			const float AREA		= calculate_half_area(INFO.bounds.min, INFO.bounds.max);
+			const float LEAF_COST	= COUNT * AREA;
+
+			if(COUNT <= m_maxLeafSize && TRAVERSAL_COST * AREA + bestCost >= LEAF_COST)
+				return BEGIN;
+
+			// All centroids are in the same place, so only the order of primitives can split them.
+			if(bestCost == FLOAT_INFINITY)
+				return (COUNT <= m_maxLeafSize) ? BEGIN : BEGIN + COUNT / 2;
+
+			auto MID = std::partition(m_primitives.begin() + BEGIN, m_primitives.begin() + END, [&](const Primitive& PRIMITIVE)
+			{
+				return get_binIDs(PRIMITIVE)[bestAxis] < bestPlane;
+			});
+
+			return static_cast<uint32_t>(MID - m_primitives.begin());
+		}
+
+		template<typename GetBinT>
+		void					fill_bins(			const uint32_t		BEGIN,
+													const uint32_t		END,
+													GetBinT&&			get_binIDs,
+													Bins&				output) const
+		{
+			auto accumulate = [&](const uint32_t FIRST, const uint32_t LAST, Bins& bins)
+			{
+				for(uint32_t i = FIRST; i < LAST; ++i)
+				{
+					const Primitive&	PRIMITIVE	= m_primitives[i];
+					const UVec3			BIN_IDS		= get_binIDs(PRIMITIVE);
+
+					for(uint32_t axis = 0; axis < 3; ++axis)
+					{
+						Bin& bin = bins[axis][BIN_IDS[axis]];
+						bin.bounds.extend(PRIMITIVE.min, PRIMITIVE.max);
+						++bin.count;
+					}
+				}
+			};
+
+			if(END - BEGIN < PARALLEL_BINNING)
+			{
+				accumulate(BEGIN, END, output);
+				return;
+			}
+
+			std::vector<Bins> partials(get_numWorkers());
+
+			parallel_for(BEGIN, END, PARALLEL_THRESHOLD, [&](const uint32_t FIRST, const uint32_t LAST, const uint32_t WORKER_ID)
+			{
+				accumulate(FIRST, LAST, partials[WORKER_ID]);
+			});
+
+			for(auto& iPartial : partials)
+			{
+				for(uint32_t axis = 0; axis < 3; ++axis)
+				{
+					for(uint32_t binID = 0; binID < NUM_BINS; ++binID)
+					{
+						output[axis][binID].bounds.extend(iPartial[axis][binID].bounds);
+						output[axis][binID].count += iPartial[axis][binID].count;
+					}
+				}
+			}
+		}
+	};
+
+
+	/*
+		Inserts two zero bits between each of the lower 10 bits of the value.
+	*/
+	inline uint32_t	expand_bits_30(			uint32_t			value)
+	{
+		value = (value * 0x00010001u) & 0xFF0000FFu;
+		value = (value * 0x00000101u) & 0x0F00F00Fu;
+		value = (value * 0x00000011u) & 0xC30C30C3u;
+		value = (value * 0x00000005u) & 0x49249249u;
+		return value;
+	}
+
+	/*
+		Inserts two zero bits between each of the lower 21 bits of the value.
+	*/
+	inline uint64_t	expand_bits_63(			uint64_t			value)
+	{
+		value &= 0x1FFFFF;
+		value = (value | value << 32) & 0x001F00000000FFFF;
+		value = (value | value << 16) & 0x001F0000FF0000FF;
+		value = (value | value << 8)  & 0x100F00F00F00F00F;
+		value = (value | value << 4)  & 0x10C30C30C30C30C3;
+		value = (value | value << 2)  & 0x1249249249249249;
+		return value;
+	}
+
+	/*
+		Position must be normalized to the [0, 1] range of the scene bounds.
+	*/
+	template<typename CodeT>
+	inline CodeT	calculate_morton_code(	const Vec3&			POSITION)
+	{
+		if constexpr (sizeof(CodeT) == sizeof(uint32_t))
+		{
+			const UVec3 CELL = glm::clamp(POSITION * 1024.f, 0.f, 1023.f);
+			return (expand_bits_30(CELL.x) << 2) | (expand_bits_30(CELL.y) << 1) | expand_bits_30(CELL.z);
+		}
+		else
+		{
+			const UVec3 CELL = glm::clamp(POSITION * 2097152.f, 0.f, 2097151.f);
+			return (expand_bits_63(CELL.x) << 2) | (expand_bits_63(CELL.y) << 1) | expand_bits_63(CELL.z);
+		}
+	}
+
+	/*
+		Stable LSD radix sort of keys and their values(8 bits per pass).
+		Each worker counts digits of its own batch, so that it can scatter them without synchronization.
+		Temporary buffers must have the same size as the input.
+	*/
+	template<typename KeyT>
+	void			parallel_radix_sort(	std::vector<KeyT>&		keys,
+											std::vector<uint32_t>&	values,
+											std::vector<KeyT>&		tmpKeys,
+											std::vector<uint32_t>&	tmpValues,
+											const uint32_t			NUM_BITS)
+	{
+		static constexpr uint32_t RADIX			= 256;
+		static constexpr uint32_t MIN_BATCH_SIZE = 16384;
+
+		using Histogram = std::array<uint32_t, RADIX>;
+
+		const uint32_t			NUM_KEYS = static_cast<uint32_t>(keys.size());
+		std::vector<Histogram>	histograms(get_numWorkers());
+
+		for(uint32_t shift = 0; shift < NUM_BITS; shift += 8)
+		{
+			for(auto& iHistogram : histograms)
+			{
+				iHistogram.fill(0);
+			}
+
+			parallel_for(0, NUM_KEYS, MIN_BATCH_SIZE, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t WORKER_ID)
+			{
+				Histogram& histogram = histograms[WORKER_ID];
+
+				for(uint32_t i = BEGIN; i < END; ++i)
+				{
+					++histogram[(keys[i] >> shift) & (RADIX - 1)];
+				}
+			});
+
+			// Convert counts to the offsets. Batches are ordered, so lower workers write first within each digit.
+			uint32_t	offset			= 0;
+			bool		bSingleDigit	= false;
+
+			for(uint32_t digit = 0; digit < RADIX; ++digit)
+			{
+				const uint32_t DIGIT_BEGIN = offset;
+
+				for(auto& iHistogram : histograms)
+				{
+					const uint32_t COUNT = iHistogram[digit];
+					iHistogram[digit]	= offset;
+					offset				+= COUNT;
+				}
+
+				bSingleDigit |= (offset - DIGIT_BEGIN == NUM_KEYS);
+			}
+
+			if(bSingleDigit)
+				continue; // All keys have the same digit, so the order would not change.
+
+			parallel_for(0, NUM_KEYS, MIN_BATCH_SIZE, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t WORKER_ID)
+			{
+				Histogram& histogram = histograms[WORKER_ID];
+
+				for(uint32_t i = BEGIN; i < END; ++i)
+				{
+					const uint32_t TARGET = histogram[(keys[i] >> shift) & (RADIX - 1)]++;
+					tmpKeys[TARGET]		= keys[i];
+					tmpValues[TARGET]	= values[i];
+				}
+			});
+
+			keys.swap(tmpKeys);
+			values.swap(tmpValues);
+		}
+	}
+
+	/*
+		Linear BVH builder(Karras 2012). Primitives are sorted by Morton codes of their centers,
+		then each node is split where the highest differing bit of the codes in its range changes.
+		Node bounds are computed on the way back, so that the whole build is a single parallel pass over the hierarchy.
+	*/
+	template<typename CodeT>
+	class	LinearBuilder
+	{
+	public: // constants
+		static constexpr uint32_t	NUM_BITS			= (sizeof(CodeT) == sizeof(uint32_t)) ? 30 : 63;
+		static constexpr uint32_t	PARALLEL_THRESHOLD	= 4096;
+
+	private: // data
+		const AABB*				m_boxes;
+		BVH::Node*				m_nodes;
+		uint32_t*				m_indices;
+		std::vector<CodeT>		m_codes;
+		std::atomic<uint32_t>	m_numNodes;
+		uint32_t				m_maxLeafSize;
+		uint32_t				m_maxParallelDepth;
+
+	public: // lifecycle
+		CLASS_CTOR				LinearBuilder(		const AABB*			BOXES,
+													const uint32_t		NUM_BOXES,
+													const uint32_t		MAX_LEAF_SIZE,
+													BVH::Node*			nodes,
+													std::vector<uint32_t>& indices)
+			: m_boxes(BOXES)
+			, m_nodes(nodes)
+			, m_indices(nullptr)
+			, m_codes(NUM_BOXES)
+			, m_numNodes(1)
+			, m_maxLeafSize(glm::max(MAX_LEAF_SIZE, 1u))
+			, m_maxParallelDepth(2 + static_cast<uint32_t>(glm::log2(static_cast<float>(get_numWorkers()))))
+		{
+			// Bounds of the centers define the grid of the Morton curve.
+			std::vector<Vec3> partialMin(get_numWorkers(), Vec3( FLOAT_INFINITY,  FLOAT_INFINITY,  FLOAT_INFINITY));
+			std::vector<Vec3> partialMax(get_numWorkers(), Vec3(-FLOAT_INFINITY, -FLOAT_INFINITY, -FLOAT_INFINITY));
+
+			parallel_for(0, NUM_BOXES, PARALLEL_THRESHOLD, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t WORKER_ID)
+			{
+				for(uint32_t i = BEGIN; i < END; ++i)
+				{
+					partialMin[WORKER_ID] = glm::min(partialMin[WORKER_ID], BOXES[i].center());
+					partialMax[WORKER_ID] = glm::max(partialMax[WORKER_ID], BOXES[i].center());
+				}
+			});
+
+			Vec3 centerMin = partialMin[0];
+			Vec3 centerMax = partialMax[0];
+
+			for(uint32_t workerID = 1; workerID < get_numWorkers(); ++workerID)
+			{
+				centerMin = glm::min(centerMin, partialMin[workerID]);
+				centerMax = glm::max(centerMax, partialMax[workerID]);
+			}
+
+			const Vec3 SIZE		= centerMax - centerMin;
+			const Vec3 SCALE	= Vec3(	SIZE.x > 0.f ? 1.f / SIZE.x : 0.f,
+										SIZE.y > 0.f ? 1.f / SIZE.y : 0.f,
+										SIZE.z > 0.f ? 1.f / SIZE.z : 0.f);
+
+			parallel_for(0, NUM_BOXES, PARALLEL_THRESHOLD, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t)
+			{
+				for(uint32_t i = BEGIN; i < END; ++i)
+				{
+					m_codes[i]	= calculate_morton_code<CodeT>((BOXES[i].center() - centerMin) * SCALE);
+					indices[i]	= i;
+				}
+			});
+
+			std::vector<CodeT>		tmpCodes(NUM_BOXES);
+			std::vector<uint32_t>	tmpIndices(NUM_BOXES);
+			parallel_radix_sort(m_codes, indices, tmpCodes, tmpIndices, NUM_BITS);
+
+			m_indices = indices.data();
+		}
+
+	public: // functions
+		inline uint32_t			get_numNodes() const
+		{
+			return m_numNodes.load();
+		}
+
+		void					build(				const uint32_t		NODE_ID,
+													const uint32_t		BEGIN,
+													const uint32_t		END,
+													const uint32_t		DEPTH)
+		{
+			BVH::Node&		node	= m_nodes[NODE_ID];
+			const uint32_t	COUNT	= END - BEGIN;
+
+			if(COUNT <= m_maxLeafSize)
+			{
+				node.min		= m_boxes[m_indices[BEGIN]].min();
+				node.max		= m_boxes[m_indices[BEGIN]].max();
+				node.leftFirst	= BEGIN;
+				node.count		= COUNT;
+
+				for(uint32_t i = BEGIN + 1; i < END; ++i)
+				{
+					node.min = glm::min(node.min, m_boxes[m_indices[i]].min());
+					node.max = glm::max(node.max, m_boxes[m_indices[i]].max());
+				}
+
+				return;
+			}
+
+			const uint32_t MID		= find_split(BEGIN, END - 1) + 1;
+			const uint32_t LEFT_ID	= m_numNodes.fetch_add(2);
+
+			if(COUNT >= PARALLEL_THRESHOLD && DEPTH < m_maxParallelDepth)
+			{
+				auto leftTask = std::async(std::launch::async, [&]()
+				{
+					build(LEFT_ID, BEGIN, MID, DEPTH + 1);
+				});
+
+				build(LEFT_ID + 1, MID, END, DEPTH + 1);
+				leftTask.get();
+			}
+			else
+			{
+				build(LEFT_ID,		BEGIN,	MID, DEPTH + 1);
+				build(LEFT_ID + 1,	MID,	END, DEPTH + 1);
+			}
+
+			const BVH::Node& LEFT	= m_nodes[LEFT_ID];
+			const BVH::Node& RIGHT	= m_nodes[LEFT_ID + 1];
+
+			node.min		= glm::min(LEFT.min, RIGHT.min);
+			node.max		= glm::max(LEFT.max, RIGHT.max);
+			node.leftFirst	= LEFT_ID;
+			node.count		= 0;
+		}
+
+	private: // functions
+		/*
+			Returns index of the last primitive of the left child.
+			Binary search finds the last code that shares more leading bits with the first code than the last code does.
+		*/
+		uint32_t				find_split(			const uint32_t		FIRST,
+													const uint32_t		LAST) const
+		{
+			const CodeT FIRST_CODE	= m_codes[FIRST];
+			const CodeT LAST_CODE	= m_codes[LAST];
+
+			// Identical codes are split in the middle.
+			if(FIRST_CODE == LAST_CODE)
+				return (FIRST + LAST) / 2;
+
+			const int32_t	COMMON_PREFIX	= std::countl_zero(FIRST_CODE ^ LAST_CODE);
+			uint32_t		split			= FIRST;
+			uint32_t		step			= LAST - FIRST;
+
+			do
+			{
+				step = (step + 1) / 2;
+				const uint32_t NEW_SPLIT = split + step;
+
+				if(NEW_SPLIT < LAST && std::countl_zero(FIRST_CODE ^ m_codes[NEW_SPLIT]) > COMMON_PREFIX)
+					split = NEW_SPLIT;
+			}
+			while(step > 1);
+
+			return split;
+		}
+	};
+
+
+//=====> BVH -> public lifecycle
+	CLASS_CTOR	BVH::BVH(					const AABB*			BOXES,
+											const uint32_t		NUM_BOXES,
+											const uint32_t		MAX_LEAF_SIZE)
+	{
+		build(BOXES, NUM_BOXES, MAX_LEAF_SIZE);
+	}
+
+//=====> BVH -> public functions
+	void		BVH::clear()
+	{
+		m_nodes.clear();
+		m_indices.clear();
+	}
+
+	void		BVH::build(					const AABB*			BOXES,
+											const uint32_t		NUM_BOXES,
+											const uint32_t		MAX_LEAF_SIZE)
+	{
+		clear();
+
+		if(!BOXES || NUM_BOXES == 0)
+			return;
+
+		// Binary tree with at least one primitive per leaf never has more than 2N-1 nodes.
+		m_nodes.resize(2 * static_cast<size_t>(NUM_BOXES) - 1);
+		m_indices.resize(NUM_BOXES);
+
+		BinnedBuilder builder(BOXES, NUM_BOXES, MAX_LEAF_SIZE, m_nodes.data(), m_indices.data());
+		builder.build(0, 0, NUM_BOXES, 0);
+
+		m_nodes.resize(builder.get_numNodes());
+		m_nodes.shrink_to_fit();
+	}
+
+	void		BVH::build_linear(			const AABB*			BOXES,
+											const uint32_t		NUM_BOXES,
+											const MortonPrecision PRECISION,
+											const uint32_t		MAX_LEAF_SIZE)
+	{
+		clear();
+
+		if(!BOXES || NUM_BOXES == 0)
+			return;
+
+		m_nodes.resize(2 * static_cast<size_t>(NUM_BOXES) - 1);
+		m_indices.resize(NUM_BOXES);
+
+		auto build_with = [&](auto&& builder)
+		{
+			builder.build(0, 0, NUM_BOXES, 0);
+			m_nodes.resize(builder.get_numNodes());
+			m_nodes.shrink_to_fit();
+		};
+
+		if(PRECISION == MortonPrecision::BITS_30)
+		{
+			build_with(LinearBuilder<uint32_t>(BOXES, NUM_BOXES, MAX_LEAF_SIZE, m_nodes.data(), m_indices));
+		}
+		else
+		{
+			build_with(LinearBuilder<uint64_t>(BOXES, NUM_BOXES, MAX_LEAF_SIZE, m_nodes.data(), m_indices));
+		}
+	}
+
+	float		BVH::calculate_sah_cost() const
+	{
+		if(m_nodes.empty())
+			return 0.f;
+
+		const float ROOT_AREA = calculate_half_area(m_nodes[0].min, m_nodes[0].max);
+		if(ROOT_AREA <= 0.f)
+			return 0.f;
+
+		float cost = 0.f;
+
+		for(auto& iNode : m_nodes)
+		{
+			cost += calculate_half_area(iNode.min, iNode.max) * (iNode.is_leaf() ? iNode.count : 1.f);
+		}
+
+		return cost / ROOT_AREA;
+	}
+
+	void		BVH::validate() const
+	{
+		if(m_nodes.empty())
+			return;
+
+		const uint32_t NUM_PRIMITIVES = validate_subtree(0, 0);
+		if(NUM_PRIMITIVES != m_indices.size())
+			throw dpl::GeneralException(this, __LINE__, "Leaves do not reference all primitives: " + std::to_string(NUM_PRIMITIVES));
+
+		std::vector<bool> referenced(m_indices.size(), false);
+
+		for(auto& iIndex : m_indices)
+		{
+			if(iIndex >= referenced.size() || referenced[iIndex])
+				throw dpl::GeneralException(this, __LINE__, "Invalid primitive index: " + std::to_string(iIndex));
+
+			referenced[iIndex] = true;
+		}
+	}
+
+//=====> BVH -> private functions
+	uint32_t	BVH::validate_subtree(		const uint32_t		NODE_ID,
+											const uint32_t		DEPTH) const
+	{
+		const Node& NODE = m_nodes[NODE_ID];
+
+		if(DEPTH > m_nodes.size())
+			throw dpl::GeneralException(this, __LINE__, "Hierarchy contains a cycle.");
+
+		if(NODE.is_leaf())
+		{
+			if(NODE.leftFirst + NODE.count > m_indices.size())
+				throw dpl::GeneralException(this, __LINE__, "Leaf references invalid range of primitives: " + std::to_string(NODE_ID));
+
+			return NODE.count;
+		}
+
+		if(NODE.leftFirst <= NODE_ID || NODE.leftFirst + 1 >= m_nodes.size())
+			throw dpl::GeneralException(this, __LINE__, "Invalid children of node: " + std::to_string(NODE_ID));
+
+		for(uint32_t childID = NODE.leftFirst; childID < NODE.leftFirst + 2; ++childID)
+		{
+			const Node& CHILD = m_nodes[childID];
+
+			if(glm::any(glm::lessThan(CHILD.min, NODE.min)) || glm::any(glm::greaterThan(CHILD.max, NODE.max)))
+				throw dpl::GeneralException(this, __LINE__, "Node does not enclose its children: " + std::to_string(NODE_ID));
+		}
+
+		return validate_subtree(NODE.leftFirst, DEPTH + 1) + validate_subtree(NODE.leftFirst + 1, DEPTH + 1);
+	}
+}
\ No newline at end of file
@@ -78,6 +78,18 @@ namespace cml
 		return output;
 	}
 
+	bool			Cone::contains(				const AABB&			aabb) const
+	{
+		// Cone is convex, so it contains the box if it contains all of its corners.
+		for(uint32_t i = 0; i < 8; ++i)
+		{
+			if(!intersects(aabb.corner(static_cast<Cuboid::Corner>(i))))
+				return false;
+		}
+
+		return true;
+	}
+
 	bool			Cone::above(				const Plane&		plane) const
 	{
 		const float apexDistance = calculate_dot(plane.normal(), this->apex());
@@ -127,7 +139,7 @@ namespace cml
 		if(k < 0.f || k > this->height())
 			return false;
 
-		return (this->cosFi * this->cosFi) * glm::dot(V, V) <= k;
+		return (this->cosFi * this->cosFi) * glm::dot(V, V) <= k * k;
 	}
 
 	bool			Cone::intersects(			const AABB&			aabb) const
@@ -144,7 +156,7 @@ namespace cml
 
 	bool			Cone::intersects(			const Sphere&		sphere) const
 	{
-		const Vec3	CmU		= sphere.center() - this->apex() + (sphere.radius() * this->sinFi()) * this->axis();
+		const Vec3	CmU		= sphere.center() - this->apex() + (sphere.radius() / this->sinFi()) * this->axis();
 		const float AdCmU	= glm::dot(axis(), CmU);
 
 		if(AdCmU > 0.f)
@@ -10,6 +10,17 @@
 namespace cml
 {
 //=====> ConvexHull public: // intersection functions
+	bool		ConvexHull::contains(		const AABB&			aabb) const
+	{
+		for(auto& iFace : faces())
+		{
+			if(!aabb.below(iFace))
+				return false;
+		}
+
+		return true;
+	}
+
 	bool		ConvexHull::intersects(		const Vec3&			point) const
 	{
 		for(auto& iPlane : faces())
@@ -0,0 +1,238 @@
+#include "../include/cml_LooseOctree.h"
+
+
+namespace cml
+{
+	inline uint32_t		get_child_index(	const UVec3&		CELL)
+	{
+		return (CELL.x & 1) | ((CELL.y & 1) << 1) | ((CELL.z & 1) << 2);
+	}
+
+	inline UVec3		get_cell_from_key(	const uint64_t		KEY)
+	{
+		return UVec3(static_cast<uint32_t>(KEY >> 32) & 0xFFFF, static_cast<uint32_t>(KEY >> 16) & 0xFFFF, static_cast<uint32_t>(KEY) & 0xFFFF);
+	}
+
+
+//=====> LooseOctree -> public lifecycle
+	CLASS_CTOR	LooseOctree::LooseOctree(		const AABB&			WORLD,
+												const uint32_t		MAX_DEPTH)
+		: m_freeNodes(NULL_INDEX)
+		, m_freeObjects(NULL_INDEX)
+		, m_numNodes(0)
+		, m_numObjects(0)
+		, m_maxDepth(MAX_DEPTH)
+		, m_worldHalfSize(glm::max(glm::max(WORLD.halfWidth(), WORLD.halfHeight()), WORLD.halfDepth()))
+	{
+		if(MAX_DEPTH > MAX_DEPTH_LIMIT)
+			throw dpl::GeneralException(this, __LINE__, "Maximal depth exceeds the limit: " + std::to_string(MAX_DEPTH));
+
+		if(m_worldHalfSize <= 0.f)
+			throw dpl::GeneralException(this, __LINE__, "World bounds are empty.");
+
+		m_worldMin = WORLD.center() - Vec3(m_worldHalfSize);
+		clear();
+	}
+
+//=====> LooseOctree -> public functions
+	void		LooseOctree::clear()
+	{
+		m_objects.clear();
+		m_nodeMap.clear();
+		m_freeNodes		= NULL_INDEX;
+		m_freeObjects	= NULL_INDEX;
+		m_numObjects	= 0;
+		m_numNodes		= 1;
+
+		// Root always exists.
+		Node root;
+		root.center		= m_worldMin + Vec3(m_worldHalfSize);
+		root.halfSize	= m_worldHalfSize;
+		root.key		= make_key(0, UVec3(0, 0, 0));
+		root.parent		= NULL_INDEX;
+		root.numChildren	= 0;
+		root.head		= NULL_INDEX;
+		std::fill(root.children, root.children + 8, NULL_INDEX);
+
+		m_nodes.assign(1, root);
+		m_nodeMap.emplace(root.key, 0);
+	}
+
+	uint32_t	LooseOctree::insert(			const AABB&			BOX,
+												const uint32_t		OBJECT_ID)
+	{
+		uint32_t proxyID = m_freeObjects;
+
+		if(proxyID != NULL_INDEX)
+		{
+			m_freeObjects = m_objects[proxyID].next;
+		}
+		else
+		{
+			proxyID = static_cast<uint32_t>(m_objects.size());
+			m_objects.emplace_back();
+		}
+
+		m_objects[proxyID].box		= BOX;
+		m_objects[proxyID].objectID	= OBJECT_ID;
+
+		link(proxyID, find_or_add_node(calculate_key(BOX)));
+		++m_numObjects;
+		return proxyID;
+	}
+
+	void		LooseOctree::remove(			const uint32_t		PROXY_ID)
+	{
+		validate_proxy(PROXY_ID);
+
+		const uint32_t NODE_ID = m_objects[PROXY_ID].node;
+		unlink(PROXY_ID);
+		release_nodes(NODE_ID);
+
+		Object& object	= m_objects[PROXY_ID];
+		object.node		= NULL_INDEX;
+		object.next		= m_freeObjects;
+		m_freeObjects	= PROXY_ID;
+		--m_numObjects;
+	}
+
+	bool		LooseOctree::move(				const uint32_t		PROXY_ID,
+												const AABB&			BOX)
+	{
+		validate_proxy(PROXY_ID);
+
+		m_objects[PROXY_ID].box = BOX;
+
+		const uint64_t KEY = calculate_key(BOX);
+		if(KEY == m_nodes[m_objects[PROXY_ID].node].key)
+			return false;
+
+		// New node is added first, so that shared ancestors are not released and created again.
+		const uint32_t NEW_NODE_ID = find_or_add_node(KEY);
+		const uint32_t OLD_NODE_ID = m_objects[PROXY_ID].node;
+
+		unlink(PROXY_ID);
+		link(PROXY_ID, NEW_NODE_ID);
+		release_nodes(OLD_NODE_ID);
+		return true;
+	}
+
+//=====> LooseOctree -> private functions
+	uint64_t	LooseOctree::calculate_key(		const AABB&			BOX) const
+	{
+		const Vec3 LOCAL = (BOX.center() - m_worldMin) / (2.f * m_worldHalfSize);
+
+		if(glm::any(glm::lessThan(LOCAL, Vec3(0.f))) || glm::any(glm::greaterThan(LOCAL, Vec3(1.f))))
+			return make_key(0, UVec3(0, 0, 0));
+
+		// Cell at the chosen depth can not be smaller than the largest half-extent of the box.
+		const float EXTENT	= glm::max(glm::max(BOX.halfWidth(), BOX.halfHeight()), BOX.halfDepth());
+		uint32_t	depth	= m_maxDepth;
+
+		if(EXTENT > 0.f)
+		{
+			const float LEVEL = glm::floor(glm::log2(m_worldHalfSize / EXTENT));
+			depth = static_cast<uint32_t>(glm::clamp(LEVEL, 0.f, static_cast<float>(m_maxDepth)));
+
+			while(depth > 0 && std::ldexp(m_worldHalfSize, -static_cast<int32_t>(depth)) < EXTENT)
+			{
+				--depth;
+			}
+		}
+
+		const uint32_t NUM_CELLS = 1u << depth;
+		return make_key(depth, glm::min(UVec3(LOCAL * static_cast<float>(NUM_CELLS)), UVec3(NUM_CELLS - 1)));
+	}
+
+	uint32_t	LooseOctree::find_or_add_node(	const uint64_t		KEY)
+	{
+		auto it = m_nodeMap.find(KEY);
+		if(it != m_nodeMap.end())
+			return it->second;
+
+		// Root always exists, so new node has a parent one level above.
+		const uint32_t	DEPTH		= get_depth_from_key(KEY);
+		const UVec3		CELL		= get_cell_from_key(KEY);
+		const uint32_t	PARENT_ID	= find_or_add_node(make_key(DEPTH - 1, CELL >> 1u));
+
+		uint32_t nodeID = m_freeNodes;
+
+		if(nodeID != NULL_INDEX)
+		{
+			m_freeNodes = m_nodes[nodeID].parent;
+		}
+		else
+		{
+			nodeID = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+
+		Node& node			= m_nodes[nodeID];
+		node.halfSize		= std::ldexp(m_worldHalfSize, -static_cast<int32_t>(DEPTH));
+		node.center			= m_worldMin + (Vec3(CELL) * 2.f + Vec3(1.f)) * node.halfSize;
+		node.key			= KEY;
+		node.parent			= PARENT_ID;
+		node.numChildren	= 0;
+		node.head			= NULL_INDEX;
+		std::fill(node.children, node.children + 8, NULL_INDEX);
+
+		m_nodes[PARENT_ID].children[get_child_index(CELL)] = nodeID;
+		++m_nodes[PARENT_ID].numChildren;
+		++m_numNodes;
+
+		m_nodeMap.emplace(KEY, nodeID);
+		return nodeID;
+	}
+
+	void		LooseOctree::release_nodes(		uint32_t			nodeID)
+	{
+		while(nodeID != 0 && m_nodes[nodeID].head == NULL_INDEX && m_nodes[nodeID].numChildren == 0)
+		{
+			Node&			node		= m_nodes[nodeID];
+			const uint32_t	PARENT_ID	= node.parent;
+
+			m_nodes[PARENT_ID].children[get_child_index(get_cell_from_key(node.key))] = NULL_INDEX;
+			--m_nodes[PARENT_ID].numChildren;
+
+			m_nodeMap.erase(node.key);
+			node.parent	= m_freeNodes;
+			m_freeNodes	= nodeID;
+			--m_numNodes;
+
+			nodeID = PARENT_ID;
+		}
+	}
+
+	void		LooseOctree::link(				const uint32_t		PROXY_ID,
+												const uint32_t		NODE_ID)
+	{
+		Object& object	= m_objects[PROXY_ID];
+		Node&	node	= m_nodes[NODE_ID];
+
+		object.node		= NODE_ID;
+		object.previous	= NULL_INDEX;
+		object.next		= node.head;
+
+		if(node.head != NULL_INDEX)
+			m_objects[node.head].previous = PROXY_ID;
+
+		node.head = PROXY_ID;
+	}
+
+	void		LooseOctree::unlink(			const uint32_t		PROXY_ID)
+	{
+		const Object& OBJECT = m_objects[PROXY_ID];
+
+		if(OBJECT.next != NULL_INDEX)
+			m_objects[OBJECT.next].previous = OBJECT.previous;
+
+		if(OBJECT.previous != NULL_INDEX)
+		{
+			m_objects[OBJECT.previous].next = OBJECT.next;
+		}
+		else
+		{
+			m_nodes[OBJECT.node].head = OBJECT.next;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "../include/cml_MappedFile.h"
+#include <dpl_GeneralException.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif // _WIN32
+
+
+namespace cml
+{
+//=====> MappedFile -> public lifecycle
+	CLASS_CTOR	MappedFile::MappedFile()
+		: m_data(nullptr)
+		, m_size(0)
+#ifdef _WIN32
+		, m_file(nullptr)
+		, m_mapping(nullptr)
+#endif // _WIN32
+	{
+
+	}
+
+	CLASS_CTOR	MappedFile::MappedFile(			const std::string&	PATH)
+		: MappedFile()
+	{
+		open(PATH);
+	}
+
+	CLASS_CTOR	MappedFile::MappedFile(			MappedFile&&		other) noexcept
+		: MappedFile()
+	{
+		swap(other);
+	}
+
+	MappedFile&	MappedFile::operator=(			MappedFile&&		other) noexcept
+	{
+		if(this != &other)
+		{
+			close();
+			swap(other);
+		}
+
+		return *this;
+	}
+
+				MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+//=====> MappedFile -> public functions
+	void		MappedFile::open(				const std::string&	PATH)
+	{
+		close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(PATH.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if(file == INVALID_HANDLE_VALUE)
+			throw dpl::GeneralException(this, __LINE__, "Failed to open file: " + PATH);
+
+		LARGE_INTEGER fileSize;
+		if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			throw dpl::GeneralException(this, __LINE__, "Failed to map empty file: " + PATH);
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(mapping == nullptr)
+		{
+			CloseHandle(file);
+			throw dpl::GeneralException(this, __LINE__, "Failed to create file mapping: " + PATH);
+		}
+
+		const void* VIEW = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if(VIEW == nullptr)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			throw dpl::GeneralException(this, __LINE__, "Failed to map view of file: " + PATH);
+		}
+
+		m_file		= file;
+		m_mapping	= mapping;
+		m_data		= static_cast<const uint8_t*>(VIEW);
+		m_size		= static_cast<size_t>(fileSize.QuadPart);
+#else
+		const int DESCRIPTOR = ::open(PATH.c_str(), O_RDONLY);
+		if(DESCRIPTOR < 0)
+			throw dpl::GeneralException(this, __LINE__, "Failed to open file: " + PATH);
+
+		struct stat status;
+		if(fstat(DESCRIPTOR, &status) != 0 || status.st_size == 0)
+		{
+			::close(DESCRIPTOR);
+			throw dpl::GeneralException(this, __LINE__, "Failed to map empty file: " + PATH);
+		}
+
+		// Mapping stays valid after the descriptor is closed.
+		void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, DESCRIPTOR, 0);
+		::close(DESCRIPTOR);
+
+		if(view == MAP_FAILED)
+			throw dpl::GeneralException(this, __LINE__, "Failed to map file: " + PATH);
+
+		m_data = static_cast<const uint8_t*>(view);
+		m_size = static_cast<size_t>(status.st_size);
+#endif // _WIN32
+	}
+
+	void		MappedFile::close()
+	{
+		if(!m_data)
+			return;
+
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapping);
+		CloseHandle(m_file);
+		m_file		= nullptr;
+		m_mapping	= nullptr;
+#else
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif // _WIN32
+
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+//=====> MappedFile -> private functions
+	void		MappedFile::swap(				MappedFile&			other)
+	{
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+#ifdef _WIN32
+		std::swap(m_file, other.m_file);
+		std::swap(m_mapping, other.m_mapping);
+#endif // _WIN32
+	}
+}
\ No newline at end of file
@@ -0,0 +1,316 @@
+#include "../include/cml_MeshBVH.h"
+#include <cfloat>
+
+
+namespace cml
+{
+	/*
+		Ray transformed so that its direction is the Z axis(shear and scale), as required by the watertight test.
+	*/
+	struct	WatertightRay
+	{
+		Vec3		origin;
+		uint32_t	kx;
+		uint32_t	ky;
+		uint32_t	kz;
+		float		sx;
+		float		sy;
+		float		sz;
+
+		CLASS_CTOR	WatertightRay(			const Ray&			RAY)
+			: origin(RAY.origin())
+		{
+			const Vec3 DIRECTION	= RAY.direction();
+			const Vec3 ABS			= glm::abs(DIRECTION);
+
+			kz = (ABS.x > ABS.y) ? ((ABS.x > ABS.z) ? 0 : 2) : ((ABS.y > ABS.z) ? 1 : 2);
+			kx = (kz + 1) % 3;
+			ky = (kx + 1) % 3;
+
+			// Winding is preserved when the dominant component is negative.
+			if(DIRECTION[kz] < 0.f)
+				std::swap(kx, ky);
+
+			sx = DIRECTION[kx] / DIRECTION[kz];
+			sy = DIRECTION[ky] / DIRECTION[kz];
+			sz = 1.f / DIRECTION[kz];
+		}
+	};
+
+	/*
+		Returns true and updates the hit if ray hits the triangle closer than the current hit distance.
+	*/
+	inline bool		intersect_triangle(		const WatertightRay&	RAY,
+											const Vec3&				A,
+											const Vec3&				B,
+											const Vec3&				C,
+											MeshBVH::Hit&			hit)
+	{
+		const Vec3 LOCAL_A = A - RAY.origin;
+		const Vec3 LOCAL_B = B - RAY.origin;
+		const Vec3 LOCAL_C = C - RAY.origin;
+
+		const float AX = LOCAL_A[RAY.kx] - RAY.sx * LOCAL_A[RAY.kz];
+		const float AY = LOCAL_A[RAY.ky] - RAY.sy * LOCAL_A[RAY.kz];
+		const float BX = LOCAL_B[RAY.kx] - RAY.sx * LOCAL_B[RAY.kz];
+		const float BY = LOCAL_B[RAY.ky] - RAY.sy * LOCAL_B[RAY.kz];
+		const float CX = LOCAL_C[RAY.kx] - RAY.sx * LOCAL_C[RAY.kz];
+		const float CY = LOCAL_C[RAY.ky] - RAY.sy * LOCAL_C[RAY.kz];
+
+		// Scaled barycentric coordinates(signed areas of sub-triangles opposite to the vertices).
+		float u = CX * BY - CY * BX;
+		float v = AX * CY - AY * CX;
+		float w = BX * AY - BY * AX;
+
+		// Edge that passes exactly through the ray is evaluated again in double precision, so that neighbouring triangles agree on the result.
+		if(u == 0.f || v == 0.f || w == 0.f)
+		{
+			u = static_cast<float>(static_cast<double>(CX) * BY - static_cast<double>(CY) * BX);
+			v = static_cast<float>(static_cast<double>(AX) * CY - static_cast<double>(AY) * CX);
+			w = static_cast<float>(static_cast<double>(BX) * AY - static_cast<double>(BY) * AX);
+		}
+
+		if((u < 0.f || v < 0.f || w < 0.f) && (u > 0.f || v > 0.f || w > 0.f))
+			return false;
+
+		const float DETERMINANT = u + v + w;
+		if(DETERMINANT == 0.f)
+			return false;
+
+		// Distance is compared before the division, scaled by the determinant.
+		const float AZ			= RAY.sz * LOCAL_A[RAY.kz];
+		const float BZ			= RAY.sz * LOCAL_B[RAY.kz];
+		const float CZ			= RAY.sz * LOCAL_C[RAY.kz];
+		const float SCALED_T	= u * AZ + v * BZ + w * CZ;
+
+		if(DETERMINANT < 0.f ? (SCALED_T > 0.f || SCALED_T <= hit.distance * DETERMINANT)
+							 : (SCALED_T < 0.f || SCALED_T >= hit.distance * DETERMINANT))
+			return false;
+
+		const float INVERSE_DETERMINANT = 1.f / DETERMINANT;
+
+		hit.distance	= SCALED_T * INVERSE_DETERMINANT;
+		hit.barycentric	= Vec3(v, w, u) * INVERSE_DETERMINANT;
+		return true;
+	}
+
+
+//=====> MeshBVH -> public lifecycle
+	CLASS_CTOR	MeshBVH::MeshBVH(					const TriangleMesh&	MESH,
+													const uint32_t		MAX_LEAF_SIZE)
+		: m_depth(0)
+	{
+		build(MESH, MAX_LEAF_SIZE);
+	}
+
+//=====> MeshBVH -> public functions
+	void		MeshBVH::clear()
+	{
+		m_nodes.clear();
+		m_triangleIDs.clear();
+		m_triangles.clear();
+		m_depth = 0;
+	}
+
+	void		MeshBVH::build(						const TriangleMesh&	MESH,
+													const uint32_t		MAX_LEAF_SIZE)
+	{
+		MESH.validate_index_count();
+		clear();
+
+		const auto&		VERTICES		= MESH.vertices();
+		const auto&		INDICES			= MESH.indices();
+		const uint32_t	NUM_TRIANGLES	= MESH.get_numIndices() / 3;
+
+		if(NUM_TRIANGLES == 0)
+			return;
+
+		std::vector<AABB> boxes(NUM_TRIANGLES);
+
+		for(uint32_t triangleID = 0; triangleID < NUM_TRIANGLES; ++triangleID)
+		{
+			const Vec3& A = VERTICES[INDICES[3 * triangleID]];
+			const Vec3& B = VERTICES[INDICES[3 * triangleID + 1]];
+			const Vec3& C = VERTICES[INDICES[3 * triangleID + 2]];
+
+			boxes[triangleID] = AABB(glm::min(A, glm::min(B, C)), glm::max(A, glm::max(B, C)));
+		}
+
+		const BVH HIERARCHY(boxes.data(), NUM_TRIANGLES, MAX_LEAF_SIZE);
+
+		m_nodes.assign(HIERARCHY.nodes(), HIERARCHY.nodes() + HIERARCHY.get_numNodes());
+		m_triangleIDs.assign(HIERARCHY.indices(), HIERARCHY.indices() + NUM_TRIANGLES);
+		m_triangles.resize(NUM_TRIANGLES);
+
+		for(uint32_t i = 0; i < NUM_TRIANGLES; ++i)
+		{
+			const uint32_t TRIANGLE_ID = m_triangleIDs[i];
+
+			m_triangles[i] = {VERTICES[INDICES[3 * TRIANGLE_ID]], VERTICES[INDICES[3 * TRIANGLE_ID + 1]], VERTICES[INDICES[3 * TRIANGLE_ID + 2]]};
+		}
+
+		// Children are always stored after their parent, so bounds can be refitted in reverse order.
+		for(uint32_t nodeID = get_numNodes(); nodeID-- > 0;)
+		{
+			BVH::Node& node = m_nodes[nodeID];
+
+			if(node.is_leaf())
+			{
+				node.min = m_triangles[node.leftFirst].a;
+				node.max = m_triangles[node.leftFirst].a;
+
+				for(uint32_t i = node.leftFirst; i < node.leftFirst + node.count; ++i)
+				{
+					node.min = glm::min(node.min, glm::min(m_triangles[i].a, glm::min(m_triangles[i].b, m_triangles[i].c)));
+					node.max = glm::max(node.max, glm::max(m_triangles[i].a, glm::max(m_triangles[i].b, m_triangles[i].c)));
+				}
+			}
+			else
+			{
+				node.min = glm::min(m_nodes[node.leftFirst].min, m_nodes[node.leftFirst + 1].min);
+				node.max = glm::max(m_nodes[node.leftFirst].max, m_nodes[node.leftFirst + 1].max);
+			}
+		}
+
+		// Depth limits the size of the traversal stack.
+		std::vector<uint32_t> depths(get_numNodes(), 0);
+
+		for(uint32_t nodeID = 0; nodeID < get_numNodes(); ++nodeID)
+		{
+			const BVH::Node& NODE = m_nodes[nodeID];
+
+			if(NODE.is_leaf())
+			{
+				m_depth = glm::max(m_depth, depths[nodeID]);
+			}
+			else
+			{
+				depths[NODE.leftFirst]		= depths[nodeID] + 1;
+				depths[NODE.leftFirst + 1]	= depths[nodeID] + 1;
+			}
+		}
+	}
+
+	std::optional<MeshBVH::Hit>	MeshBVH::find_closest_hit(	const Ray&			RAY,
+															const float			MAX_DISTANCE) const
+	{
+		Hit hit;
+
+		if(!traverse(RAY, MAX_DISTANCE, false, hit))
+			return std::nullopt;
+
+		return hit;
+	}
+
+	bool		MeshBVH::intersects(				const Ray&			RAY,
+													const float			MAX_DISTANCE) const
+	{
+		Hit hit;
+		return traverse(RAY, MAX_DISTANCE, true, hit);
+	}
+
+//=====> MeshBVH -> private functions
+	bool		MeshBVH::traverse(					const Ray&			RAY,
+													const float			MAX_DISTANCE,
+													const bool			bANY_HIT,
+													Hit&				hit) const
+	{
+		if(empty())
+			return false;
+
+		const BVH::Node*	NODES				= m_nodes.data();
+		const WatertightRay	WATERTIGHT_RAY(RAY);
+		const Vec3			ORIGIN				= RAY.origin();
+		const Vec3			INVERSE_DIRECTION	= RAY.calculate_inverse_direction();
+
+		hit.distance = MAX_DISTANCE;
+
+		/*
+			Same slab test as BVH::query(ray), limited to the current hit distance.
+			Exit distances are enlarged by the maximal rounding error of the test,
+			otherwise boxes of triangles hit exactly at their vertex or edge could be culled.
+		*/
+		constexpr float ROBUST_SCALE = 1.f + 2.f * (3.f * FLT_EPSILON * 0.5f) / (1.f - 3.f * FLT_EPSILON * 0.5f);
+
+		auto calculate_entry = [&](const BVH::Node& NODE)
+		{
+			const Vec3 TO_MIN	= (NODE.min - ORIGIN) * INVERSE_DIRECTION;
+			const Vec3 TO_MAX	= (NODE.max - ORIGIN) * INVERSE_DIRECTION;
+			const Vec3 NEAR		= glm::min(TO_MIN, TO_MAX);
+			const Vec3 FAR		= glm::max(TO_MIN, TO_MAX) * ROBUST_SCALE;
+			const float ENTRY	= glm::max(glm::max(NEAR.x, NEAR.y), glm::max(NEAR.z, 0.f));
+			const float EXIT	= glm::min(glm::min(FAR.x, FAR.y), glm::min(FAR.z, hit.distance));
+
+			return (ENTRY <= EXIT) ? ENTRY : FLOAT_INFINITY;
+		};
+
+		struct Entry
+		{
+			uint32_t	nodeID;
+			float		distance;
+		};
+
+		// Depth first traversal never needs more than depth + 1 entries.
+		Entry				localStack[LOCAL_STACK_SIZE];
+		std::vector<Entry>	heapStack;
+		Entry*				stack = localStack;
+
+		if(m_depth + 1 > LOCAL_STACK_SIZE)
+		{
+			heapStack.resize(m_depth + 1);
+			stack = heapStack.data();
+		}
+
+		uint32_t	stackSize	= 0;
+		bool		bHit		= false;
+
+		const float ROOT_ENTRY = calculate_entry(NODES[0]);
+		if(ROOT_ENTRY == FLOAT_INFINITY)
+			return false;
+
+		stack[stackSize++] = {0, ROOT_ENTRY};
+
+		while(stackSize > 0)
+		{
+			const Entry CURRENT = stack[--stackSize];
+
+			if(CURRENT.distance > hit.distance)
+				continue; // Closer hit was found after the node was pushed.
+
+			const BVH::Node& NODE = NODES[CURRENT.nodeID];
+
+			if(NODE.is_leaf())
+			{
+				for(uint32_t i = NODE.leftFirst; i < NODE.leftFirst + NODE.count; ++i)
+				{
+					const Triangle& TRIANGLE = m_triangles[i];
+
+					if(intersect_triangle(WATERTIGHT_RAY, TRIANGLE.a, TRIANGLE.b, TRIANGLE.c, hit))
+					{
+						hit.triangleID	= m_triangleIDs[i];
+						bHit			= true;
+
+						if(bANY_HIT)
+							return true;
+					}
+				}
+
+				continue;
+			}
+
+			Entry nearChild	= {NODE.leftFirst,		calculate_entry(NODES[NODE.leftFirst])};
+			Entry farChild	= {NODE.leftFirst + 1,	calculate_entry(NODES[NODE.leftFirst + 1])};
+
+			if(farChild.distance < nearChild.distance)
+				std::swap(nearChild, farChild);
+
+			if(farChild.distance != FLOAT_INFINITY)
+				stack[stackSize++] = farChild;
+
+			if(nearChild.distance != FLOAT_INFINITY)
+				stack[stackSize++] = nearChild;
+		}
+
+		return bHit;
+	}
+}
\ No newline at end of file
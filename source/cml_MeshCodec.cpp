@@ -0,0 +1,229 @@
+#include "../include/cml_MeshCodec.h"
+#include <cstring>
+#include <dpl_GeneralException.h>
+
+
+namespace cml
+{
+//=====> MeshCodec -> public functions
+	std::vector<uint8_t> MeshCodec::encode(		const TriangleMesh&		MESH,
+												const uint32_t			POSITION_BITS)
+	{
+		MESH.validate_indices();
+
+		if(POSITION_BITS == 0 || POSITION_BITS > MAX_POSITION_BITS)
+			throw dpl::GeneralException(__FILE__, __LINE__, "Invalid number of position bits: " + std::to_string(POSITION_BITS));
+
+		const uint32_t NUM_VERTICES = MESH.get_numVertices();
+		const uint32_t NUM_INDICES	= MESH.get_numIndices();
+		const uint32_t MAX_QUANTIZED = (1u << POSITION_BITS) - 1;
+
+		Vec3 boundsMin(0.f, 0.f, 0.f);
+		Vec3 boundsMax(0.f, 0.f, 0.f);
+
+		if(NUM_VERTICES > 0)
+		{
+			boundsMin = boundsMax = MESH.vertices()[0];
+
+			for(auto& iVertex : MESH.vertices())
+			{
+				boundsMin = glm::min(boundsMin, iVertex);
+				boundsMax = glm::max(boundsMax, iVertex);
+			}
+		}
+
+		const Vec3 STEP				= (boundsMax - boundsMin) / static_cast<float>(MAX_QUANTIZED);
+		const Vec3 INVERSE_STEP		= glm::mix(Vec3(0.f, 0.f, 0.f), 1.f / STEP, glm::greaterThan(STEP, Vec3(0.f, 0.f, 0.f)));
+
+		Header header = {};
+		header.magic		= MAGIC;
+		header.version		= VERSION;
+		header.numVertices	= NUM_VERTICES;
+		header.numIndices	= NUM_INDICES;
+		header.positionBits	= POSITION_BITS;
+		header.indexOffset	= sizeof(Header) + static_cast<uint64_t>(NUM_VERTICES) * 3 * sizeof(uint16_t);
+
+		for(uint32_t axis = 0; axis < 3; ++axis)
+		{
+			header.boundsMin[axis]	= boundsMin[axis];
+			header.step[axis]		= STEP[axis];
+		}
+
+		std::vector<uint8_t> output(header.indexOffset);
+		output.reserve(header.indexOffset + NUM_INDICES + NUM_INDICES / 4);
+
+		// Chunks of quantized coordinates, all X coordinates of the chunk are followed by Y and Z coordinates.
+		for(uint32_t first = 0; first < NUM_VERTICES; first += VERTEX_CHUNK_SIZE)
+		{
+			const uint32_t	COUNT	= std::min(VERTEX_CHUNK_SIZE, NUM_VERTICES - first);
+			uint16_t*		chunk	= reinterpret_cast<uint16_t*>(output.data() + sizeof(Header)) + static_cast<size_t>(first) * 3;
+
+			for(uint32_t i = 0; i < COUNT; ++i)
+			{
+				const Vec3 QUANTIZED = glm::clamp(glm::round((MESH.vertices()[first + i] - boundsMin) * INVERSE_STEP), 0.f, static_cast<float>(MAX_QUANTIZED));
+
+				chunk[i]				= static_cast<uint16_t>(QUANTIZED.x);
+				chunk[COUNT + i]		= static_cast<uint16_t>(QUANTIZED.y);
+				chunk[COUNT * 2 + i]	= static_cast<uint16_t>(QUANTIZED.z);
+			}
+		}
+
+		uint32_t previousIndex = 0;
+
+		for(auto& index : MESH.indices())
+		{
+			const int32_t	DELTA	= static_cast<int32_t>(index - previousIndex);
+			uint32_t		zigzag	= (static_cast<uint32_t>(DELTA) << 1) ^ static_cast<uint32_t>(DELTA >> 31);
+
+			while(zigzag >= 0x80)
+			{
+				output.push_back(static_cast<uint8_t>(zigzag | 0x80));
+				zigzag >>= 7;
+			}
+
+			output.push_back(static_cast<uint8_t>(zigzag));
+			previousIndex = index;
+		}
+
+		header.size = output.size();
+		std::memcpy(output.data(), &header, sizeof(Header));
+		return output;
+	}
+
+	void		MeshCodec::decode(				const uint8_t*			DATA,
+												const size_t			SIZE,
+												TriangleMesh&			output)
+	{
+		MeshDecoder decoder(DATA, SIZE);
+
+		// Buffers are allocated once and decoded in place, then moved into the mesh.
+		TriangleMesh::Vertices	vertices(decoder.get_numVertices());
+		TriangleMesh::Indices	indices(decoder.get_numIndices());
+
+		decoder.decode_vertices(vertices.data(), decoder.get_numVertices());
+		decoder.decode_indices(indices.data(), decoder.get_numIndices());
+		output.assign(std::move(vertices), std::move(indices));
+	}
+
+//=====> MeshDecoder -> public lifecycle
+	CLASS_CTOR	MeshDecoder::MeshDecoder(		const uint8_t*			DATA,
+												const size_t			SIZE)
+		: m_data(DATA)
+		, m_header(reinterpret_cast<const MeshCodec::Header*>(DATA))
+		, m_indexPosition(0)
+		, m_numDecodedVertices(0)
+		, m_numDecodedIndices(0)
+		, m_previousIndex(0)
+	{
+		if(!DATA || reinterpret_cast<uintptr_t>(DATA) % alignof(MeshCodec::Header) != 0)
+			throw dpl::GeneralException(this, __LINE__, "Mesh encoding must be aligned to " + std::to_string(alignof(MeshCodec::Header)) + " bytes.");
+
+		if(SIZE < sizeof(MeshCodec::Header) || m_header->magic != MeshCodec::MAGIC)
+			throw dpl::GeneralException(this, __LINE__, "Data is not a mesh encoding.");
+
+		if(m_header->version != MeshCodec::VERSION)
+			throw dpl::GeneralException(this, __LINE__, "Unsupported mesh encoding version: " + std::to_string(m_header->version));
+
+		if(m_header->size > SIZE)
+			throw dpl::GeneralException(this, __LINE__, "Mesh encoding is truncated.");
+
+		if(m_header->positionBits == 0 || m_header->positionBits > MeshCodec::MAX_POSITION_BITS || m_header->numIndices % 3 != 0
+		|| m_header->indexOffset != sizeof(MeshCodec::Header) + static_cast<uint64_t>(m_header->numVertices) * 3 * sizeof(uint16_t)
+		|| m_header->indexOffset > m_header->size)
+			throw dpl::GeneralException(this, __LINE__, "Header of the mesh encoding is corrupted.");
+
+		reset();
+	}
+
+//=====> MeshDecoder -> public functions
+	void		MeshDecoder::reset()
+	{
+		m_indexPosition			= m_header->indexOffset;
+		m_numDecodedVertices	= 0;
+		m_numDecodedIndices		= 0;
+		m_previousIndex			= 0;
+	}
+
+	uint32_t	MeshDecoder::decode_vertices(	Vec3*					output,
+												const uint32_t			MAX_VERTICES)
+	{
+		const uint32_t	NUM_VERTICES	= m_header->numVertices;
+		const uint32_t	COUNT			= std::min(MAX_VERTICES, NUM_VERTICES - m_numDecodedVertices);
+		const uint16_t*	QUANTIZED		= reinterpret_cast<const uint16_t*>(m_data + sizeof(MeshCodec::Header));
+		const Vec3		MIN(m_header->boundsMin[0], m_header->boundsMin[1], m_header->boundsMin[2]);
+		const Vec3		STEP(m_header->step[0], m_header->step[1], m_header->step[2]);
+
+		for(uint32_t decoded = 0; decoded < COUNT;)
+		{
+			// Batch can start and end in the middle of the chunk.
+			const uint32_t	FIRST			= m_numDecodedVertices + decoded;
+			const uint32_t	CHUNK_FIRST		= FIRST - FIRST % MeshCodec::VERTEX_CHUNK_SIZE;
+			const uint32_t	CHUNK_SIZE		= std::min(MeshCodec::VERTEX_CHUNK_SIZE, NUM_VERTICES - CHUNK_FIRST);
+			const uint32_t	RUN				= std::min(CHUNK_FIRST + CHUNK_SIZE - FIRST, COUNT - decoded);
+			const uint16_t*	X				= QUANTIZED + static_cast<size_t>(CHUNK_FIRST) * 3 + (FIRST - CHUNK_FIRST);
+			const uint16_t*	Y				= X + CHUNK_SIZE;
+			const uint16_t*	Z				= Y + CHUNK_SIZE;
+			Vec3*			target			= output + decoded;
+
+			for(uint32_t i = 0; i < RUN; ++i)
+			{
+				target[i].x = MIN.x + static_cast<float>(X[i]) * STEP.x;
+				target[i].y = MIN.y + static_cast<float>(Y[i]) * STEP.y;
+				target[i].z = MIN.z + static_cast<float>(Z[i]) * STEP.z;
+			}
+
+			decoded += RUN;
+		}
+
+		m_numDecodedVertices += COUNT;
+		return COUNT;
+	}
+
+	uint32_t	MeshDecoder::decode_indices(	uint32_t*				output,
+												const uint32_t			MAX_INDICES)
+	{
+		const uint32_t	COUNT			= std::min(MAX_INDICES, m_header->numIndices - m_numDecodedIndices);
+		const uint32_t	NUM_VERTICES	= m_header->numVertices;
+		const uint64_t	END				= m_header->size;
+		uint64_t		position		= m_indexPosition;
+		uint32_t		index			= m_previousIndex;
+
+		for(uint32_t i = 0; i < COUNT; ++i)
+		{
+			if(position >= END)
+				throw dpl::GeneralException(this, __LINE__, "Index stream is truncated.");
+
+			uint32_t zigzag = m_data[position++];
+
+			// Most differences fit in a single byte.
+			if(zigzag & 0x80)
+			{
+				zigzag &= 0x7F;
+
+				for(uint32_t shift = 7;; shift += 7)
+				{
+					if(position >= END || shift > 28)
+						throw dpl::GeneralException(this, __LINE__, "Index stream is corrupted.");
+
+					const uint8_t BYTE = m_data[position++];
+					zigzag |= static_cast<uint32_t>(BYTE & 0x7F) << shift;
+
+					if(!(BYTE & 0x80))
+						break;
+				}
+			}
+
+			index += (zigzag >> 1) ^ (0u - (zigzag & 1));
+
+			if(index >= NUM_VERTICES)
+				throw dpl::GeneralException(this, __LINE__, "Invalid index: " + std::to_string(index));
+
+			output[i] = index;
+		}
+
+		m_indexPosition			= position;
+		m_previousIndex			= index;
+		m_numDecodedIndices		+= COUNT;
+		return COUNT;
+	}
+}
\ No newline at end of file
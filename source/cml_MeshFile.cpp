@@ -0,0 +1,177 @@
+#include "../include/cml_MeshFile.h"
+#include <fstream>
+#include <dpl_GeneralException.h>
+
+
+namespace cml
+{
+	inline uint64_t		align_offset(			const uint64_t		OFFSET)
+	{
+		return (OFFSET + MeshFile::BLOCK_ALIGNMENT - 1) / MeshFile::BLOCK_ALIGNMENT * MeshFile::BLOCK_ALIGNMENT;
+	}
+
+//=====> MeshFile -> public functions
+	void		MeshFile::write(				const std::string&		PATH,
+												const TriangleMesh&		MESH,
+												const Vec3*				NORMALS,
+												const BVH*				HIERARCHY)
+	{
+		MESH.validate_indices();
+
+		const uint32_t NUM_VERTICES = MESH.get_numVertices();
+		const uint32_t NUM_INDICES	= MESH.get_numIndices();
+
+		Header header = {};
+		header.magic		= MAGIC;
+		header.version		= VERSION;
+		header.numVertices	= NUM_VERTICES;
+		header.numIndices	= NUM_INDICES;
+
+		// Blocks are laid out one after another.
+		uint64_t offset = align_offset(sizeof(Header));
+
+		header.vertexOffset = offset;
+		offset = align_offset(offset + NUM_VERTICES * sizeof(Vec3));
+
+		header.indexOffset = offset;
+		offset = align_offset(offset + NUM_INDICES * sizeof(uint32_t));
+
+		if(NORMALS)
+		{
+			header.flags		|= HAS_NORMALS;
+			header.normalOffset	= offset;
+			offset = align_offset(offset + NUM_VERTICES * sizeof(Vec3));
+		}
+
+		if(HIERARCHY && !HIERARCHY->empty())
+		{
+			header.flags			|= HAS_BVH;
+			header.numBVHNodes		= HIERARCHY->get_numNodes();
+			header.numBVHIndices	= HIERARCHY->get_numPrimitives();
+			header.bvhNodeOffset	= offset;
+			offset = align_offset(offset + header.numBVHNodes * sizeof(BVH::Node));
+
+			header.bvhIndexOffset	= offset;
+			offset = align_offset(offset + header.numBVHIndices * sizeof(uint32_t));
+		}
+
+		header.fileSize = offset;
+
+		Vec3 boundsMin(0.f, 0.f, 0.f);
+		Vec3 boundsMax(0.f, 0.f, 0.f);
+
+		if(NUM_VERTICES > 0)
+		{
+			boundsMin = boundsMax = MESH.vertices()[0];
+
+			for(auto& iVertex : MESH.vertices())
+			{
+				boundsMin = glm::min(boundsMin, iVertex);
+				boundsMax = glm::max(boundsMax, iVertex);
+			}
+		}
+
+		for(uint32_t axis = 0; axis < 3; ++axis)
+		{
+			header.boundsMin[axis] = boundsMin[axis];
+			header.boundsMax[axis] = boundsMax[axis];
+		}
+
+		std::ofstream file(PATH, std::ios::binary | std::ios::trunc);
+		if(!file)
+			throw dpl::GeneralException(__FILE__, __LINE__, "Failed to create file: " + PATH);
+
+		auto write_block = [&](const uint64_t BLOCK_OFFSET, const void* DATA, const uint64_t SIZE)
+		{
+			static const char PADDING[BLOCK_ALIGNMENT] = {};
+
+			const uint64_t POSITION = static_cast<uint64_t>(file.tellp());
+			file.write(PADDING, static_cast<std::streamsize>(BLOCK_OFFSET - POSITION));
+			file.write(static_cast<const char*>(DATA), static_cast<std::streamsize>(SIZE));
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		write_block(header.vertexOffset, MESH.vertices().data(), NUM_VERTICES * sizeof(Vec3));
+		write_block(header.indexOffset, MESH.indices().data(), NUM_INDICES * sizeof(uint32_t));
+
+		if(header.flags & HAS_NORMALS)
+			write_block(header.normalOffset, NORMALS, NUM_VERTICES * sizeof(Vec3));
+
+		if(header.flags & HAS_BVH)
+		{
+			write_block(header.bvhNodeOffset, HIERARCHY->nodes(), header.numBVHNodes * sizeof(BVH::Node));
+			write_block(header.bvhIndexOffset, HIERARCHY->indices(), header.numBVHIndices * sizeof(uint32_t));
+		}
+
+		write_block(header.fileSize, nullptr, 0);
+
+		if(!file)
+			throw dpl::GeneralException(__FILE__, __LINE__, "Failed to write file: " + PATH);
+	}
+
+//=====> MeshView -> public lifecycle
+	CLASS_CTOR	MeshView::MeshView(				const void*				DATA,
+												const size_t			SIZE)
+		: m_header(static_cast<const MeshFile::Header*>(DATA))
+		, m_vertices(nullptr)
+		, m_indices(nullptr)
+		, m_normals(nullptr)
+		, m_bvhNodes(nullptr)
+		, m_bvhIndices(nullptr)
+	{
+		const uint8_t* BYTES = static_cast<const uint8_t*>(DATA);
+
+		if(!DATA || reinterpret_cast<uintptr_t>(DATA) % alignof(BVH::Node) != 0)
+			throw dpl::GeneralException(this, __LINE__, "Mesh file data must be aligned to " + std::to_string(alignof(BVH::Node)) + " bytes.");
+
+		if(SIZE < sizeof(MeshFile::Header) || m_header->magic != MeshFile::MAGIC)
+			throw dpl::GeneralException(this, __LINE__, "Data is not a mesh file.");
+
+		if(m_header->version != MeshFile::VERSION)
+			throw dpl::GeneralException(this, __LINE__, "Unsupported mesh file version: " + std::to_string(m_header->version));
+
+		if(m_header->fileSize > SIZE)
+			throw dpl::GeneralException(this, __LINE__, "Mesh file is truncated.");
+
+		if(m_header->numIndices % 3 != 0)
+			throw dpl::GeneralException(this, __LINE__, "Number of indices must be divisible by 3.");
+
+		auto get_block = [&](const uint64_t OFFSET, const uint64_t COUNT, const uint64_t ELEMENT_SIZE)
+		{
+			if(OFFSET % MeshFile::BLOCK_ALIGNMENT != 0 || OFFSET < sizeof(MeshFile::Header) || OFFSET > m_header->fileSize || COUNT * ELEMENT_SIZE > m_header->fileSize - OFFSET)
+				throw dpl::GeneralException(this, __LINE__, "Invalid block of the mesh file at: " + std::to_string(OFFSET));
+
+			return BYTES + OFFSET;
+		};
+
+		m_vertices	= reinterpret_cast<const Vec3*>(get_block(m_header->vertexOffset, m_header->numVertices, sizeof(Vec3)));
+		m_indices	= reinterpret_cast<const uint32_t*>(get_block(m_header->indexOffset, m_header->numIndices, sizeof(uint32_t)));
+
+		if(m_header->flags & MeshFile::HAS_NORMALS)
+			m_normals = reinterpret_cast<const Vec3*>(get_block(m_header->normalOffset, m_header->numVertices, sizeof(Vec3)));
+
+		if(m_header->flags & MeshFile::HAS_BVH)
+		{
+			m_bvhNodes		= reinterpret_cast<const BVH::Node*>(get_block(m_header->bvhNodeOffset, m_header->numBVHNodes, sizeof(BVH::Node)));
+			m_bvhIndices	= reinterpret_cast<const uint32_t*>(get_block(m_header->bvhIndexOffset, m_header->numBVHIndices, sizeof(uint32_t)));
+		}
+	}
+
+//=====> MeshView -> public functions
+	void		MeshView::copy_to(				TriangleMesh&			output) const
+	{
+		output.reset();
+		output.reserve_vertices(get_numVertices());
+		output.reserve_indices(get_numIndices());
+
+		for(uint32_t vertexID = 0; vertexID < get_numVertices(); ++vertexID)
+		{
+			output.add_vertex(m_vertices[vertexID]);
+		}
+
+		for(uint32_t i = 0; i < get_numIndices(); ++i)
+		{
+			output.add_index(m_indices[i]);
+		}
+	}
+}
\ No newline at end of file
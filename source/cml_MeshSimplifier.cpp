@@ -0,0 +1,482 @@
+#include "../include/cml_MeshSimplifier.h"
+#include <algorithm>
+#include <dpl_GeneralException.h>
+
+
+namespace cml
+{
+//=====> MeshSimplifier::Quadric -> public functions
+	MeshSimplifier::Quadric&	MeshSimplifier::Quadric::operator+=(const Quadric&	OTHER)
+	{
+		a2 += OTHER.a2; ab += OTHER.ab; ac += OTHER.ac; ad += OTHER.ad;
+		b2 += OTHER.b2; bc += OTHER.bc; bd += OTHER.bd;
+		c2 += OTHER.c2; cd += OTHER.cd;
+		d2 += OTHER.d2;
+		weight += OTHER.weight;
+		return *this;
+	}
+
+	double		MeshSimplifier::Quadric::evaluate(	const Vec3&			POINT) const
+	{
+		const double X = POINT.x;
+		const double Y = POINT.y;
+		const double Z = POINT.z;
+
+		return	a2 * X * X + 2.0 * (ab * X * Y + ac * X * Z + ad * X)
+			+	b2 * Y * Y + 2.0 * (bc * Y * Z + bd * Y)
+			+	c2 * Z * Z + 2.0 * cd * Z
+			+	d2;
+	}
+
+	bool		MeshSimplifier::Quadric::minimize(	Vec3&				output) const
+	{
+		// Cramer's rule for the gradient equal to zero.
+		const double COFACTOR_X = b2 * c2 - bc * bc;
+		const double COFACTOR_Y = bc * ac - ab * c2;
+		const double COFACTOR_Z = ab * bc - b2 * ac;
+		const double DETERMINANT = a2 * COFACTOR_X + ab * COFACTOR_Y + ac * COFACTOR_Z;
+		const double SCALE = a2 + b2 + c2;
+
+		if(std::abs(DETERMINANT) <= 1e-9 * SCALE * SCALE * SCALE)
+			return false;
+
+		const double INVERSE = -1.0 / DETERMINANT;
+
+		output.x = static_cast<float>(INVERSE * (ad * COFACTOR_X + bd * COFACTOR_Y + cd * COFACTOR_Z));
+		output.y = static_cast<float>(INVERSE * (ad * COFACTOR_Y + bd * (a2 * c2 - ac * ac) + cd * (ab * ac - a2 * bc)));
+		output.z = static_cast<float>(INVERSE * (ad * COFACTOR_Z + bd * (ab * ac - a2 * bc) + cd * (a2 * b2 - ab * ab)));
+		return true;
+	}
+
+//=====> MeshSimplifier -> public lifecycle
+	CLASS_CTOR	MeshSimplifier::MeshSimplifier(		const TriangleMesh&				MESH)
+		: m_vertices(MESH.vertices())
+		, m_numTriangles(0)
+		, m_error(0.f)
+	{
+		MESH.validate_indices();
+
+		const uint32_t NUM_VERTICES = MESH.get_numVertices();
+
+		m_quadrics.resize(NUM_VERTICES, Quadric());
+		m_versions.resize(NUM_VERTICES, 0);
+		m_locked.resize(NUM_VERTICES, 0);
+		m_removed.resize(NUM_VERTICES, 0);
+		m_rejected.resize(NUM_VERTICES, 0);
+		m_vertexTriangles.resize(NUM_VERTICES);
+		m_indices.reserve(MESH.get_numIndices());
+
+		// Triangles with repeated vertices are skipped.
+		for(uint32_t offset = 0; offset < MESH.get_numIndices(); offset += 3)
+		{
+			const uint32_t AID = MESH.indices()[offset+0];
+			const uint32_t BID = MESH.indices()[offset+1];
+			const uint32_t CID = MESH.indices()[offset+2];
+
+			if(AID == BID || BID == CID || CID == AID)
+				continue;
+
+			m_vertexTriangles[AID].push_back(m_numTriangles);
+			m_vertexTriangles[BID].push_back(m_numTriangles);
+			m_vertexTriangles[CID].push_back(m_numTriangles);
+			m_indices.insert(m_indices.end(), {AID, BID, CID});
+			++m_numTriangles;
+		}
+
+		m_collapsed.resize(m_numTriangles, 0);
+
+		// Quadric of the triangle plane weighted by its area.
+		for(uint32_t triangleID = 0; triangleID < m_numTriangles; ++triangleID)
+		{
+			const Vec3& A = m_vertices[m_indices[triangleID * 3 + 0]];
+			const Vec3& B = m_vertices[m_indices[triangleID * 3 + 1]];
+			const Vec3& C = m_vertices[m_indices[triangleID * 3 + 2]];
+
+			const Vec3	CROSS	= glm::cross(B - A, C - A);
+			const float LENGTH	= glm::length(CROSS);
+			if(LENGTH <= 0.f)
+				continue;
+
+			const Vec3		NORMAL	= CROSS / LENGTH;
+			const double	WEIGHT	= 0.5 * LENGTH;
+			const double	PA		= NORMAL.x;
+			const double	PB		= NORMAL.y;
+			const double	PC		= NORMAL.z;
+			const double	PD		= -glm::dot(NORMAL, A);
+
+			Quadric plane;
+			plane.a2 = PA * PA * WEIGHT; plane.ab = PA * PB * WEIGHT; plane.ac = PA * PC * WEIGHT; plane.ad = PA * PD * WEIGHT;
+			plane.b2 = PB * PB * WEIGHT; plane.bc = PB * PC * WEIGHT; plane.bd = PB * PD * WEIGHT;
+			plane.c2 = PC * PC * WEIGHT; plane.cd = PC * PD * WEIGHT;
+			plane.d2 = PD * PD * WEIGHT;
+			plane.weight = WEIGHT;
+
+			for(uint32_t offset = triangleID * 3; offset < triangleID * 3 + 3; ++offset)
+			{
+				m_quadrics[m_indices[offset]] += plane;
+			}
+		}
+
+		// Edges used by one triangle(border) or more than two triangles(non-manifold) lock their vertices.
+		std::vector<uint64_t> edges;
+		edges.reserve(m_indices.size());
+
+		for(uint32_t offset = 0; offset < m_indices.size(); ++offset)
+		{
+			const uint32_t FIRST	= m_indices[offset];
+			const uint32_t SECOND	= m_indices[offset - offset % 3 + (offset + 1) % 3];
+			edges.push_back(static_cast<uint64_t>(std::min(FIRST, SECOND)) << 32 | std::max(FIRST, SECOND));
+		}
+
+		std::sort(edges.begin(), edges.end());
+
+		for(size_t begin = 0, end = 0; begin < edges.size(); begin = end)
+		{
+			for(end = begin + 1; end < edges.size() && edges[end] == edges[begin]; ++end);
+
+			const uint32_t VERTEX_A = static_cast<uint32_t>(edges[begin] >> 32);
+			const uint32_t VERTEX_B = static_cast<uint32_t>(edges[begin] & 0xFFFFFFFF);
+
+			if(end - begin != 2)
+			{
+				m_locked[VERTEX_A] = 1;
+				m_locked[VERTEX_B] = 1;
+			}
+		}
+
+		m_heap.reserve(edges.size());
+
+		for(size_t begin = 0, end = 0; begin < edges.size(); begin = end)
+		{
+			for(end = begin + 1; end < edges.size() && edges[end] == edges[begin]; ++end);
+
+			push_collapse(static_cast<uint32_t>(edges[begin] >> 32), static_cast<uint32_t>(edges[begin] & 0xFFFFFFFF));
+		}
+	}
+
+//=====> MeshSimplifier -> public functions
+	bool		MeshSimplifier::simplify(			const uint32_t					TARGET_NUM_TRIANGLES,
+													const float						MAX_ERROR)
+	{
+		while(m_numTriangles > TARGET_NUM_TRIANGLES)
+		{
+			if(m_heap.empty())
+				return false;
+
+			std::pop_heap(m_heap.begin(), m_heap.end(), compare);
+			const Collapse CURRENT = m_heap.back();
+
+			if(!is_valid(CURRENT))
+			{
+				m_heap.pop_back();
+				continue;
+			}
+
+			if(CURRENT.error > MAX_ERROR)
+			{
+				// Collapse stays in the heap, so that simplification can continue with larger error.
+				std::push_heap(m_heap.begin(), m_heap.end(), compare);
+				return false;
+			}
+
+			m_heap.pop_back();
+
+			if(!can_collapse(CURRENT))
+			{
+				// Collapse is added again when another collapse changes the 1-ring of one of its vertices.
+				m_rejected[CURRENT.kept]	= 1;
+				m_rejected[CURRENT.removed]	= 1;
+				continue;
+			}
+
+			collapse(CURRENT);
+			m_error = std::max(m_error, CURRENT.error);
+
+			// Number of valid collapses never exceeds the number of edges(about 1.5 per triangle).
+			if(m_heap.size() > 4 * static_cast<size_t>(m_numTriangles) + 1024)
+				purge_heap();
+		}
+
+		return true;
+	}
+
+	void		MeshSimplifier::extract(			TriangleMesh&					output) const
+	{
+		std::vector<uint32_t> remap(m_vertices.size(), NULL_INDEX);
+
+		for(uint32_t triangleID = 0; triangleID < m_collapsed.size(); ++triangleID)
+		{
+			if(is_collapsed(triangleID))
+				continue;
+
+			for(uint32_t offset = triangleID * 3; offset < triangleID * 3 + 3; ++offset)
+			{
+				if(remap[m_indices[offset]] == NULL_INDEX)
+					remap[m_indices[offset]] = 0;
+			}
+		}
+
+		output.reset();
+		output.reserve_indices(m_numTriangles * 3);
+
+		for(uint32_t vertexID = 0; vertexID < m_vertices.size(); ++vertexID)
+		{
+			if(remap[vertexID] != NULL_INDEX)
+				remap[vertexID] = output.add_vertex(m_vertices[vertexID]);
+		}
+
+		for(uint32_t triangleID = 0; triangleID < m_collapsed.size(); ++triangleID)
+		{
+			if(is_collapsed(triangleID))
+				continue;
+
+			for(uint32_t offset = triangleID * 3; offset < triangleID * 3 + 3; ++offset)
+			{
+				output.add_index(remap[m_indices[offset]]);
+			}
+		}
+	}
+
+	std::vector<TriangleMesh> MeshSimplifier::generate_lodChain(const TriangleMesh&	MESH,
+													const std::vector<uint32_t>&	TRIANGLE_BUDGETS)
+	{
+		const uint32_t NUM_LODS = static_cast<uint32_t>(TRIANGLE_BUDGETS.size());
+
+		std::vector<uint32_t> order(NUM_LODS);
+		for(uint32_t lodID = 0; lodID < NUM_LODS; ++lodID)
+		{
+			order[lodID] = lodID;
+		}
+
+		std::sort(order.begin(), order.end(), [&](const uint32_t A, const uint32_t B)
+		{
+			return TRIANGLE_BUDGETS[A] > TRIANGLE_BUDGETS[B];
+		});
+
+		std::vector<TriangleMesh>	output(NUM_LODS);
+		MeshSimplifier				simplifier(MESH);
+
+		for(auto& iLOD : order)
+		{
+			simplifier.simplify(TRIANGLE_BUDGETS[iLOD]);
+			simplifier.extract(output[iLOD]);
+		}
+
+		return output;
+	}
+
+//=====> MeshSimplifier -> private functions
+	void		MeshSimplifier::push_collapse(		const uint32_t					VERTEX_A,
+													const uint32_t					VERTEX_B)
+	{
+		if(m_locked[VERTEX_A] && m_locked[VERTEX_B])
+			return;
+
+		Collapse collapse;
+		collapse.kept		= m_locked[VERTEX_B] ? VERTEX_B : VERTEX_A;
+		collapse.removed	= m_locked[VERTEX_B] ? VERTEX_A : VERTEX_B;
+
+		const Vec3&	KEPT	= m_vertices[collapse.kept];
+		const Vec3&	REMOVED	= m_vertices[collapse.removed];
+
+		Quadric quadric = m_quadrics[collapse.kept];
+				quadric += m_quadrics[collapse.removed];
+
+		if(m_locked[collapse.kept])
+		{
+			collapse.target = KEPT;
+		}
+		else
+		{
+			// Optimal point of nearly singular quadric can be far away from the edge, endpoints or midpoint are used instead.
+			const Vec3	MIDPOINT		= (KEPT + REMOVED) * 0.5f;
+			const float	EDGE_LENGTH		= glm::length(REMOVED - KEPT);
+
+			if(!quadric.minimize(collapse.target) || glm::length(collapse.target - MIDPOINT) > EDGE_LENGTH)
+			{
+				collapse.target = MIDPOINT;
+
+				if(quadric.evaluate(KEPT) < quadric.evaluate(collapse.target))
+					collapse.target = KEPT;
+
+				if(quadric.evaluate(REMOVED) < quadric.evaluate(collapse.target))
+					collapse.target = REMOVED;
+			}
+		}
+
+		const double SQUARED_ERROR = std::max(quadric.evaluate(collapse.target), 0.0) / std::max(quadric.weight, 1e-30);
+
+		collapse.error			= static_cast<float>(std::sqrt(SQUARED_ERROR));
+		collapse.keptVersion	= m_versions[collapse.kept];
+		collapse.removedVersion	= m_versions[collapse.removed];
+
+		m_heap.push_back(collapse);
+		std::push_heap(m_heap.begin(), m_heap.end(), compare);
+	}
+
+	void		MeshSimplifier::purge_heap()
+	{
+		m_heap.erase(std::remove_if(m_heap.begin(), m_heap.end(), [&](const Collapse& COLLAPSE){ return !is_valid(COLLAPSE); }), m_heap.end());
+		std::make_heap(m_heap.begin(), m_heap.end(), compare);
+	}
+
+	void		MeshSimplifier::collect_neighbours(	const uint32_t					VERTEX_ID,
+													std::vector<uint32_t>&			output)
+	{
+		auto& triangles = m_vertexTriangles[VERTEX_ID];
+		triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [&](const uint32_t TRIANGLE_ID){ return is_collapsed(TRIANGLE_ID); }), triangles.end());
+
+		output.clear();
+
+		for(auto& iTriangle : triangles)
+		{
+			for(uint32_t offset = iTriangle * 3; offset < iTriangle * 3 + 3; ++offset)
+			{
+				if(m_indices[offset] != VERTEX_ID)
+					output.push_back(m_indices[offset]);
+			}
+		}
+
+		std::sort(output.begin(), output.end());
+		output.erase(std::unique(output.begin(), output.end()), output.end());
+	}
+
+	bool		MeshSimplifier::can_collapse(		const Collapse&					COLLAPSE)
+	{
+		// Link condition, vertices can share only the opposite vertices of their common triangles.
+		collect_neighbours(COLLAPSE.kept, m_keptNeighbours);
+		collect_neighbours(COLLAPSE.removed, m_removedNeighbours);
+
+		uint32_t numSharedTriangles = 0;
+
+		for(auto& iTriangle : m_vertexTriangles[COLLAPSE.removed])
+		{
+			for(uint32_t offset = iTriangle * 3; offset < iTriangle * 3 + 3; ++offset)
+			{
+				numSharedTriangles += (m_indices[offset] == COLLAPSE.kept) ? 1 : 0;
+			}
+		}
+
+		uint32_t numSharedNeighbours = 0;
+
+		for(auto& iNeighbour : m_removedNeighbours)
+		{
+			numSharedNeighbours += std::binary_search(m_keptNeighbours.begin(), m_keptNeighbours.end(), iNeighbour) ? 1 : 0;
+		}
+
+		if(numSharedTriangles == 0 || numSharedNeighbours != numSharedTriangles)
+			return false;
+
+		return preserves_orientation(COLLAPSE.removed, COLLAPSE.kept, COLLAPSE.target)
+			&& preserves_orientation(COLLAPSE.kept, COLLAPSE.removed, COLLAPSE.target);
+	}
+
+	bool		MeshSimplifier::preserves_orientation(const uint32_t				VERTEX_ID,
+													const uint32_t					OTHER_ID,
+													const Vec3&						TARGET) const
+	{
+		for(auto& iTriangle : m_vertexTriangles[VERTEX_ID])
+		{
+			if(is_collapsed(iTriangle))
+				continue;
+
+			const uint32_t* TRIANGLE = &m_indices[iTriangle * 3];
+
+			if(TRIANGLE[0] == OTHER_ID || TRIANGLE[1] == OTHER_ID || TRIANGLE[2] == OTHER_ID)
+				continue; // Triangle is removed by the collapse.
+
+			Vec3 moved[3] = {m_vertices[TRIANGLE[0]], m_vertices[TRIANGLE[1]], m_vertices[TRIANGLE[2]]};
+
+			const Vec3 OLD_NORMAL = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+
+			for(uint32_t i = 0; i < 3; ++i)
+			{
+				if(TRIANGLE[i] == VERTEX_ID)
+					moved[i] = TARGET;
+			}
+
+			const Vec3 NEW_NORMAL = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+
+			// Large rotation of the normal means that the triangle flips or becomes a sliver.
+			if(glm::dot(OLD_NORMAL, NEW_NORMAL) <= 0.25f * glm::length(OLD_NORMAL) * glm::length(NEW_NORMAL))
+				return false;
+		}
+
+		return true;
+	}
+
+	void		MeshSimplifier::collapse(			const Collapse&					COLLAPSE)
+	{
+		const uint32_t KEPT		= COLLAPSE.kept;
+		const uint32_t REMOVED	= COLLAPSE.removed;
+
+		m_vertices[KEPT]	= COLLAPSE.target;
+		m_quadrics[KEPT]	+= m_quadrics[REMOVED];
+		m_removed[REMOVED]	= 1;
+		++m_versions[KEPT];
+
+		for(auto& iTriangle : m_vertexTriangles[REMOVED])
+		{
+			if(is_collapsed(iTriangle))
+				continue;
+
+			uint32_t* triangle = &m_indices[iTriangle * 3];
+
+			if(triangle[0] == KEPT || triangle[1] == KEPT || triangle[2] == KEPT)
+			{
+				m_collapsed[iTriangle] = 1;
+				--m_numTriangles;
+				continue;
+			}
+
+			for(uint32_t i = 0; i < 3; ++i)
+			{
+				if(triangle[i] == REMOVED)
+					triangle[i] = KEPT;
+			}
+
+			m_vertexTriangles[KEPT].push_back(iTriangle);
+		}
+
+		std::vector<uint32_t>().swap(m_vertexTriangles[REMOVED]);
+
+		// Error of all edges of the kept vertex has changed.
+		collect_neighbours(KEPT, m_keptNeighbours);
+		m_rejected[KEPT] = 0;
+
+		// Triangles of the neighbours have changed as well, so that their rejected collapses may be possible now.
+		// All edges of such neighbour are pushed again with the new version, which also invalidates the old ones.
+		for(auto& iNeighbour : m_keptNeighbours)
+		{
+			if(m_rejected[iNeighbour])
+				++m_versions[iNeighbour];
+		}
+
+		for(auto& iNeighbour : m_keptNeighbours)
+		{
+			push_collapse(KEPT, iNeighbour);
+		}
+
+		for(auto& iNeighbour : m_keptNeighbours)
+		{
+			if(!m_rejected[iNeighbour])
+				continue;
+
+			collect_neighbours(iNeighbour, m_removedNeighbours);
+
+			for(auto& iOther : m_removedNeighbours)
+			{
+				// Edge of two rejected neighbours is pushed only once.
+				if(iOther == KEPT || (iOther < iNeighbour && m_rejected[iOther] && std::binary_search(m_keptNeighbours.begin(), m_keptNeighbours.end(), iOther)))
+					continue;
+
+				push_collapse(iNeighbour, iOther);
+			}
+		}
+
+		for(auto& iNeighbour : m_keptNeighbours)
+		{
+			m_rejected[iNeighbour] = 0;
+		}
+	}
+}
\ No newline at end of file
@@ -17,6 +17,118 @@ namespace cml
 			 + abs(calculate_dot(axis, mat[2]));
 	}
 
+	// Helpers of the OBB-OBB test, local to this file.
+	namespace
+	{
+		/*
+			Axes, extents and center of the reference OBB used by the separating axis test.
+		*/
+		struct	SeparationFrame
+		{
+			Vec3	axes[3];
+			float	extents[3];
+			Vec3	center;
+
+			CLASS_CTOR		SeparationFrame(	const OBB&				BOX)
+				: axes{BOX.local_X(), BOX.local_Y(), BOX.local_Z()}
+				, extents{BOX.halfWidth(), BOX.halfHeight(), BOX.halfDepth()}
+				, center(BOX.center())
+			{
+
+			}
+		};
+
+		/*
+			Separating axis test between two OBBs expressed through the rotation matrix from A to B(Gottschalk/Ericson).
+			Axes of both OBBs must be orthonormal.
+			Epsilon added to the absolute rotation matrix prevents false negatives on nearly parallel edges,
+			when the cross product of the axes degenerates to the zero vector.
+		*/
+		bool			test_separation(const SeparationFrame&	A,
+										const OBB&				B)
+		{
+			static const float EPSILON = 0.000001f;
+
+			const Vec3	B_AXES[3]		= {B.local_X(), B.local_Y(), B.local_Z()};
+			const float	B_EXTENTS[3]	= {B.halfWidth(), B.halfHeight(), B.halfDepth()};
+
+			// Rotation matrix expressing B in A's coordinate frame.
+			float R[3][3];
+			float AbsR[3][3];
+
+			for(uint32_t i = 0; i < 3; ++i)
+			{
+				for(uint32_t j = 0; j < 3; ++j)
+				{
+					R[i][j]		= calculate_dot(A.axes[i], B_AXES[j]);
+					AbsR[i][j]	= abs(R[i][j]) + EPSILON;
+				}
+			}
+
+			// Translation vector brought into A's coordinate frame.
+			const Vec3	TO_B	= B.center() - A.center;
+			const float t[3]	= {	calculate_dot(TO_B, A.axes[0]), 
+									calculate_dot(TO_B, A.axes[1]), 
+									calculate_dot(TO_B, A.axes[2])};
+
+			const float* a = A.extents;
+			const float* b = B_EXTENTS;
+
+			// Test axes L = A0, L = A1, L = A2.
+			for(uint32_t i = 0; i < 3; ++i)
+			{
+				if(abs(t[i]) > a[i] + b[0] * AbsR[i][0] + b[1] * AbsR[i][1] + b[2] * AbsR[i][2])
+					return false;
+			}
+
+			// Test axes L = B0, L = B1, L = B2.
+			for(uint32_t i = 0; i < 3; ++i)
+			{
+				if(abs(t[0] * R[0][i] + t[1] * R[1][i] + t[2] * R[2][i]) > a[0] * AbsR[0][i] + a[1] * AbsR[1][i] + a[2] * AbsR[2][i] + b[i])
+					return false;
+			}
+
+			// Test axis L = A0 x B0.
+			if(abs(t[2] * R[1][0] - t[1] * R[2][0]) > a[1] * AbsR[2][0] + a[2] * AbsR[1][0] + b[1] * AbsR[0][2] + b[2] * AbsR[0][1])
+				return false;
+
+			// Test axis L = A0 x B1.
+			if(abs(t[2] * R[1][1] - t[1] * R[2][1]) > a[1] * AbsR[2][1] + a[2] * AbsR[1][1] + b[0] * AbsR[0][2] + b[2] * AbsR[0][0])
+				return false;
+
+			// Test axis L = A0 x B2.
+			if(abs(t[2] * R[1][2] - t[1] * R[2][2]) > a[1] * AbsR[2][2] + a[2] * AbsR[1][2] + b[0] * AbsR[0][1] + b[1] * AbsR[0][0])
+				return false;
+
+			// Test axis L = A1 x B0.
+			if(abs(t[0] * R[2][0] - t[2] * R[0][0]) > a[0] * AbsR[2][0] + a[2] * AbsR[0][0] + b[1] * AbsR[1][2] + b[2] * AbsR[1][1])
+				return false;
+
+			// Test axis L = A1 x B1.
+			if(abs(t[0] * R[2][1] - t[2] * R[0][1]) > a[0] * AbsR[2][1] + a[2] * AbsR[0][1] + b[0] * AbsR[1][2] + b[2] * AbsR[1][0])
+				return false;
+
+			// Test axis L = A1 x B2.
+			if(abs(t[0] * R[2][2] - t[2] * R[0][2]) > a[0] * AbsR[2][2] + a[2] * AbsR[0][2] + b[0] * AbsR[1][1] + b[1] * AbsR[1][0])
+				return false;
+
+			// Test axis L = A2 x B0.
+			if(abs(t[1] * R[0][0] - t[0] * R[1][0]) > a[0] * AbsR[1][0] + a[1] * AbsR[0][0] + b[1] * AbsR[2][2] + b[2] * AbsR[2][1])
+				return false;
+
+			// Test axis L = A2 x B1.
+			if(abs(t[1] * R[0][1] - t[0] * R[1][1]) > a[0] * AbsR[1][1] + a[1] * AbsR[0][1] + b[0] * AbsR[2][2] + b[2] * AbsR[2][0])
+				return false;
+
+			// Test axis L = A2 x B2.
+			if(abs(t[1] * R[0][2] - t[0] * R[1][2]) > a[0] * AbsR[1][2] + a[1] * AbsR[0][2] + b[0] * AbsR[2][1] + b[1] * AbsR[2][0])
+				return false;
+
+			// No separating axis exists, so the two OBBs intersect.
+			return true;
+		}
+	}
+
 
 	CLASS_CTOR	OBB::OBB()
 		: Cuboid(0.f, 0.f, 0.f)
@@ -26,7 +138,7 @@ namespace cml
 
 	CLASS_CTOR	OBB::OBB(					const AABB&				aabb)
 		: Cuboid(aabb)
-		, CoordinateSystem(aabb.center, CoordinateSystem::global_X(), CoordinateSystem::global_Y())
+		, CoordinateSystem(aabb.center, CoordinateSystem::global_X(), CoordinateSystem::global_Y(), CoordinateSystem::global_Z())
 	{
 
 	}
@@ -161,141 +273,27 @@ namespace cml
 	{
 		// https://www.geometrictools.com/Documentation/DynamicCollisionDetection.pdf
 		// https://www.randygaul.net/2014/05/22/deriving-obb-to-obb-intersection-sat/
+		return test_separation(SeparationFrame(*this), OTHER);
+	}
 
-		/*
-		// Generate a rotation matrix that transforms from world space to this OBB's coordinate space.
-		Mat3 R;
-		for(int i = 0; i < 3; ++i)
-			for(int j = 0; j < 3; ++j)
-				R[i][j] = calculate_dot(axes()[i], OTHER.axes()[j]);
-
-		Vec3	t = OTHER.origin() - origin();
-				t.x = calculate_dot(t, X());
-				t.y = calculate_dot(t, Y());
-				t.z = calculate_dot(t, Z());
-
-		Mat3 AbsR;
-		for(int i = 0; i < 3; ++i)
-			for(int j = 0; j < 3; ++j)
-				AbsR[i][j] = abs(R[i][j]); // removed + epsilon
-
-		// Test the three major axes of this OBB.
-		for(int i = 0; i < 3; ++i)
-		{
-			float ra = R[i];
-			float rb = DOT3(b.r, AbsR[i]);
-			if (abs(t[i]) > ra + rb)
-				return false;
-		}
-
-		// Test the three major axes of the OBB b.
-		for(int i = 0; i < 3; ++i)
-		{
-			float ra = r[0] * AbsR[0][i] + r[1] * AbsR[1][i] + r[2] * AbsR[2][i];
-			float rb = b.r[i];
-			if (abs(t.x * R[0][i] + t.y * R[1][i] + t.z * R[2][i]) > ra + rb)
-				return false;
-		}
-
-		// Test the 9 different cross-axes.
-
-		// A.x <cross> B.x
-		float ra = r.y * AbsR[2][0] + r.z * AbsR[1][0];
-		float rb = b.r.y * AbsR[0][2] + b.r.z * AbsR[0][1];
-		if (abs(t.z * R[1][0] - t.y * R[2][0]) > ra + rb)
-			return false;
-
-		// A.x < cross> B.y
-		ra = r.y * AbsR[2][1] + r.z * AbsR[1][1];
-		rb = b.r.x * AbsR[0][2] + b.r.z * AbsR[0][0];
-		if (abs(t.z * R[1][1] - t.y * R[2][1]) > ra + rb)
-			return false;
-
-		// A.x <cross> B.z
-		ra = r.y * AbsR[2][2] + r.z * AbsR[1][2];
-		rb = b.r.x * AbsR[0][1] + b.r.y * AbsR[0][0];
-		if (abs(t.z * R[1][2] - t.y * R[2][2]) > ra + rb)
-			return false;
-
-		// A.y <cross> B.x
-		ra = r.x * AbsR[2][0] + r.z * AbsR[0][0];
-		rb = b.r.y * AbsR[1][2] + b.r.z * AbsR[1][1];
-		if (abs(t.x * R[2][0] - t.z * R[0][0]) > ra + rb)
-			return false;
-
-		// A.y <cross> B.y
-		ra = r.x * AbsR[2][1] + r.z * AbsR[0][1];
-		rb = b.r.x * AbsR[1][2] + b.r.z * AbsR[1][0];
-		if (abs(t.x * R[2][1] - t.z * R[0][1]) > ra + rb)
-			return false;
-
-		// A.y <cross> B.z
-		ra = r.x * AbsR[2][2] + r.z * AbsR[0][2];
-		rb = b.r.x * AbsR[1][1] + b.r.y * AbsR[1][0];
-		if (abs(t.x * R[2][2] - t.z * R[0][2]) > ra + rb)
-			return false;
-
-		// A.z <cross> B.x
-		ra = r.x * AbsR[1][0] + r.y * AbsR[0][0];
-		rb = b.r.y * AbsR[2][2] + b.r.z * AbsR[2][1];
-		if (abs(t.y * R[0][0] - t.x * R[1][0]) > ra + rb)
-			return false;
-
-		// A.z <cross> B.y
-		ra = r.x * AbsR[1][1] + r.y * AbsR[0][1];
-		rb = b.r.x * AbsR[2][2] + b.r.z * AbsR[2][0];
-		if (abs(t.y * R[0][1] - t.x * R[1][1]) > ra + rb)
-			return false;
-
-		// A.z <cross> B.z
-		ra = r.x * AbsR[1][2] + r.y * AbsR[0][2];
-		rb = b.r.x * AbsR[2][1] + b.r.y * AbsR[2][0];
-		if (abs(t.y * R[0][2] - t.x * R[1][2]) > ra + rb)
-			return false;
-
-		// No separating axis exists, so the two OBB don't intersect.
-		return true;
-		*/
-
-		/*
-		const Vec3 TO_OTHER = OTHER.center() - this->center();
-
-		for(uint32_t axisID = 0; axisID < 3; ++axisID)
-		{
-			const Vec3& THIS_AXIS		= this->get_axis(axisID);
-			const Vec3& OTHER_AXIS		= OTHER.get_axis(axisID);
-
-			const float THIS_EXTENT		= this->get_extent(axisID);
-			const float OTHER_EXTENT	= OTHER.get_extent(axisID);
-
-			if(abs(glm::dot(THIS_AXIS, TO_OTHER)) > THIS_EXTENT + OTHER.project_size(THIS_AXIS))
-				return false;
-
-			if(abs(glm::dot(OTHER_AXIS, TO_OTHER)) > OTHER_EXTENT + this->project_size(OTHER_AXIS))
-				return false;
-		}
-
-		return true;
-		*/
+	uint32_t	OBB::intersects(			const OBB*				OTHERS,
+											const uint32_t			NUM_OTHERS,
+											uint8_t*				outputMask) const
+	{
+		// Axes and extents of this OBB are loaded once for all neighbours.
+		const SeparationFrame THIS_FRAME(*this);
 
-		const Vec3 TO_OTHER = OTHER.center() - this->center();
+		uint32_t numIntersections = 0;
 
-		for(uint32_t firstID = 0; firstID < 3; ++firstID)
+		for(uint32_t index = 0; index < NUM_OTHERS; ++index)
 		{
-			const Vec3& THIS_AXIS = this->get_axis(firstID);
+			const bool bINTERSECTS = test_separation(THIS_FRAME, OTHERS[index]);
 
-			if(is_separation_axis(OTHER, TO_OTHER, THIS_AXIS)
-			|| is_separation_axis(OTHER, TO_OTHER, OTHER.get_axis(firstID)))
-				return false;
-
-			for(uint32_t secondID = 0; secondID < 3; ++secondID)
-			{
-				if(is_separation_axis(OTHER, TO_OTHER, glm::cross(THIS_AXIS, OTHER.get_axis(secondID))))
-					return false;
-			}
+			outputMask[index]	= static_cast<uint8_t>(bINTERSECTS);
+			numIntersections	+= static_cast<uint32_t>(bINTERSECTS);
 		}
 
-		return true;
+		return numIntersections;
 	}
 
 	bool		OBB::intersects(			const Sphere&			sphere) const
@@ -349,19 +347,4 @@ namespace cml
 					, glm::max(halfHeight(), OTHER.project_size(up()))
 					, glm::max(halfDepth(), OTHER.project_size(right())));
 	}
-
-	bool		OBB::is_separation_axis(	const OBB&				OTHER,
-											const Vec3&				TO_OTHER,
-											const Vec3&				AXIS) const
-	{
-		const float LHV = abs(glm::dot(TO_OTHER, AXIS));
-		const float RHV = abs(glm::dot(this->local_X() * this->halfWidth(),		AXIS))
-						+ abs(glm::dot(this->local_Y() * this->halfHeight(),	AXIS))
-						+ abs(glm::dot(this->local_Z() * this->halfDepth(),		AXIS))
-						+ abs(glm::dot(OTHER.local_X() * OTHER.halfWidth(),		AXIS))
-						+ abs(glm::dot(OTHER.local_Y() * OTHER.halfHeight(),	AXIS))
-						+ abs(glm::dot(OTHER.local_Z() * OTHER.halfDepth(),		AXIS));
-
-		return	LHV > RHV;
-	}
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "../include/cml_QuantizedBVH.h"
+
+
+namespace cml
+{
+//=====> QuantizedBVH -> public functions
+	template<typename QuantT>
+	void		QuantizedBVH<QuantT>::clear()
+	{
+		m_nodes.clear();
+		m_indices.clear();
+		m_rootBounds	= {Vec3(0.f, 0.f, 0.f), Vec3(0.f, 0.f, 0.f)};
+		m_root			= 0;
+	}
+
+	template<typename QuantT>
+	void		QuantizedBVH<QuantT>::build(			const BVH&			BINARY)
+	{
+		clear();
+
+		if(BINARY.empty())
+			return;
+
+		const BVH::Node* BINARY_NODES = BINARY.nodes();
+
+		m_indices.assign(BINARY.indices(), BINARY.indices() + BINARY.get_numPrimitives());
+		m_rootBounds = {BINARY_NODES[0].min, BINARY_NODES[0].max};
+
+		if(BINARY_NODES[0].is_leaf())
+		{
+			m_root = make_leaf_reference(BINARY_NODES[0]);
+			return;
+		}
+
+		// Children are encoded relative to the decoded bounds of the parent, exactly as they are decoded during traversal.
+		struct	Task
+		{
+			uint32_t	binaryNodeID;
+			uint32_t	nodeID;
+			Bounds		bounds;
+		};
+
+		std::vector<Task> tasks;
+		tasks.push_back({0, 0, m_rootBounds});
+
+		m_nodes.reserve(BINARY.get_numNodes() / 2);
+		m_nodes.emplace_back();
+		m_root = 0;
+
+		while(!tasks.empty())
+		{
+			const Task TASK = tasks.back();
+			tasks.pop_back();
+
+			for(uint32_t child = 0; child < 2; ++child)
+			{
+				const uint32_t		BINARY_CHILD_ID = BINARY_NODES[TASK.binaryNodeID].leftFirst + child;
+				const BVH::Node&	BINARY_CHILD	= BINARY_NODES[BINARY_CHILD_ID];
+				const Bounds		DECODED			= encode(m_nodes[TASK.nodeID], child, TASK.bounds, BINARY_CHILD);
+
+				if(BINARY_CHILD.is_leaf())
+				{
+					m_nodes[TASK.nodeID].children[child] = make_leaf_reference(BINARY_CHILD);
+				}
+				else
+				{
+					const uint32_t CHILD_ID = static_cast<uint32_t>(m_nodes.size());
+					m_nodes.emplace_back();
+					m_nodes[TASK.nodeID].children[child] = CHILD_ID;
+					tasks.push_back({BINARY_CHILD_ID, CHILD_ID, DECODED});
+				}
+			}
+		}
+
+		m_nodes.shrink_to_fit();
+	}
+
+//=====> QuantizedBVH -> private functions
+	template<typename QuantT>
+	uint32_t	QuantizedBVH<QuantT>::make_leaf_reference(	const BVH::Node&	BINARY_LEAF) const
+	{
+		if(BINARY_LEAF.count > MAX_LEAF_SIZE)
+			throw dpl::GeneralException(this, __LINE__, "Leaf has too many primitives: " + std::to_string(BINARY_LEAF.count));
+
+		if(BINARY_LEAF.leftFirst > MAX_FIRST)
+			throw dpl::GeneralException(this, __LINE__, "Primitive index can not be encoded: " + std::to_string(BINARY_LEAF.leftFirst));
+
+		return LEAF_FLAG | ((BINARY_LEAF.count - 1) << COUNT_SHIFT) | BINARY_LEAF.leftFirst;
+	}
+
+	template<typename QuantT>
+	typename QuantizedBVH<QuantT>::Bounds QuantizedBVH<QuantT>::encode(	Node&				node,
+																		const uint32_t		CHILD,
+																		const Bounds&		PARENT,
+																		const BVH::Node&	BINARY_CHILD) const
+	{
+		const Vec3 SCALE = calculate_scale(PARENT);
+
+		for(uint32_t axis = 0; axis < 3; ++axis)
+		{
+			if(SCALE[axis] > 0.f)
+			{
+				const float MIN_OFFSET = glm::floor((BINARY_CHILD.min[axis] - PARENT.min[axis]) / SCALE[axis]);
+				const float MAX_OFFSET = glm::ceil((BINARY_CHILD.max[axis] - PARENT.min[axis]) / SCALE[axis]);
+
+				node.childMin[CHILD][axis] = static_cast<QuantT>(glm::clamp(MIN_OFFSET, 0.f, static_cast<float>(MAX_QUANTIZED)));
+				node.childMax[CHILD][axis] = static_cast<QuantT>(glm::clamp(MAX_OFFSET, 0.f, static_cast<float>(MAX_QUANTIZED)));
+			}
+			else
+			{
+				node.childMin[CHILD][axis] = 0;
+				node.childMax[CHILD][axis] = 0;
+			}
+		}
+
+		// Rounding of the division may differ from decoding, so offsets are corrected until decoded box encloses the child.
+		Bounds decoded = decode(node, CHILD, PARENT);
+
+		for(uint32_t axis = 0; axis < 3; ++axis)
+		{
+			while(decoded.min[axis] > BINARY_CHILD.min[axis] && node.childMin[CHILD][axis] > 0)
+			{
+				--node.childMin[CHILD][axis];
+				decoded = decode(node, CHILD, PARENT);
+			}
+
+			while(decoded.max[axis] < BINARY_CHILD.max[axis] && node.childMax[CHILD][axis] < MAX_QUANTIZED)
+			{
+				++node.childMax[CHILD][axis];
+				decoded = decode(node, CHILD, PARENT);
+			}
+
+			if(decoded.min[axis] > BINARY_CHILD.min[axis] || decoded.max[axis] < BINARY_CHILD.max[axis])
+				throw dpl::GeneralException(this, __LINE__, "Child bounds exceed bounds of the parent.");
+		}
+
+		return decoded;
+	}
+
+
+	template class QuantizedBVH<uint8_t>;
+	template class QuantizedBVH<uint16_t>;
+}
\ No newline at end of file
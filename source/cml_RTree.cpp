@@ -0,0 +1,651 @@
+#include "../include/cml_RTree.h"
+#include <algorithm>
+
+
+namespace cml
+{
+	inline float	calculate_area(		const Vec2&			MIN,
+										const Vec2&			MAX)
+	{
+		return (MAX.x - MIN.x) * (MAX.y - MIN.y);
+	}
+
+	/*
+		Half of the perimeter is enough to compare margins.
+	*/
+	inline float	calculate_margin(	const Vec2&			MIN,
+										const Vec2&			MAX)
+	{
+		return (MAX.x - MIN.x) + (MAX.y - MIN.y);
+	}
+
+
+//=====> RTree -> public lifecycle
+	CLASS_CTOR	RTree::RTree()
+		: m_root(NULL_INDEX)
+		, m_freeNodes(NULL_INDEX)
+		, m_freeProxies(NULL_INDEX)
+		, m_numNodes(0)
+		, m_numProxies(0)
+	{
+		clear();
+	}
+
+//=====> RTree -> public functions
+	void		RTree::clear()
+	{
+		m_nodes.clear();
+		m_proxies.clear();
+		m_freeNodes		= NULL_INDEX;
+		m_freeProxies	= NULL_INDEX;
+		m_numNodes		= 0;
+		m_numProxies	= 0;
+		m_root			= allocate_node(0);
+	}
+
+	void		RTree::build(				const AABR*			BOXES,
+											const uint32_t		NUM_BOXES)
+	{
+		clear();
+
+		if(NUM_BOXES == 0)
+			return;
+
+		std::vector<Entry> entries(NUM_BOXES);
+		m_proxies.resize(NUM_BOXES);
+
+		for(uint32_t i = 0; i < NUM_BOXES; ++i)
+		{
+			m_proxies[i].box		= BOXES[i];
+			m_proxies[i].objectID	= i;
+			m_proxies[i].next		= NULL_INDEX;
+			entries[i]				= {BOXES[i].min(), BOXES[i].max(), i};
+		}
+
+		m_numProxies = NUM_BOXES;
+
+		auto compare_x = [](const Entry& A, const Entry& B){ return A.min.x + A.max.x < B.min.x + B.max.x; };
+		auto compare_y = [](const Entry& A, const Entry& B){ return A.min.y + A.max.y < B.min.y + B.max.y; };
+
+		// Each level is sorted into vertical slices by X, which are then sorted by Y and packed into full nodes.
+		std::vector<Entry>	parents;
+		uint32_t			level = 0;
+
+		while(entries.size() > MAX_CHILDREN)
+		{
+			const uint32_t NUM_ENTRIES	= static_cast<uint32_t>(entries.size());
+			const uint32_t NUM_NODES	= (NUM_ENTRIES + MAX_CHILDREN - 1) / MAX_CHILDREN;
+			const uint32_t NUM_SLICES	= static_cast<uint32_t>(glm::ceil(glm::sqrt(static_cast<float>(NUM_NODES))));
+			const uint32_t SLICE_SIZE	= NUM_SLICES * MAX_CHILDREN;
+
+			std::sort(entries.begin(), entries.end(), compare_x);
+			parents.clear();
+
+			for(uint32_t sliceBegin = 0; sliceBegin < NUM_ENTRIES; sliceBegin += SLICE_SIZE)
+			{
+				const uint32_t SLICE_END = glm::min(sliceBegin + SLICE_SIZE, NUM_ENTRIES);
+				std::sort(entries.begin() + sliceBegin, entries.begin() + SLICE_END, compare_y);
+
+				for(uint32_t first = sliceBegin; first < SLICE_END; first += MAX_CHILDREN)
+				{
+					const uint32_t NODE_ID	= allocate_node(level);
+					const uint32_t COUNT	= glm::min(MAX_CHILDREN, SLICE_END - first);
+
+					for(uint32_t lane = 0; lane < COUNT; ++lane)
+					{
+						set_lane(m_nodes[NODE_ID], lane, entries[first + lane]);
+						set_parent(NODE_ID, lane);
+					}
+
+					m_nodes[NODE_ID].count = COUNT;
+					parents.push_back(calculate_entry(NODE_ID));
+				}
+			}
+
+			entries.swap(parents);
+			++level;
+		}
+
+		Node& root	= m_nodes[m_root];
+		root.level	= level;
+		root.count	= static_cast<uint32_t>(entries.size());
+
+		for(uint32_t lane = 0; lane < root.count; ++lane)
+		{
+			set_lane(root, lane, entries[lane]);
+			set_parent(m_root, lane);
+		}
+	}
+
+	uint32_t	RTree::insert(				const AABR&			BOX,
+											const uint32_t		OBJECT_ID)
+	{
+		uint32_t proxyID = m_freeProxies;
+
+		if(proxyID != NULL_INDEX)
+		{
+			m_freeProxies = m_proxies[proxyID].next;
+		}
+		else
+		{
+			proxyID = static_cast<uint32_t>(m_proxies.size());
+			m_proxies.emplace_back();
+		}
+
+		m_proxies[proxyID].box		= BOX;
+		m_proxies[proxyID].objectID	= OBJECT_ID;
+		m_proxies[proxyID].next		= NULL_INDEX;
+
+		insert_proxy(proxyID);
+		++m_numProxies;
+		return proxyID;
+	}
+
+	void		RTree::remove(				const uint32_t		PROXY_ID)
+	{
+		validate_proxy(PROXY_ID);
+
+		const uint32_t LEAF_ID = m_proxies[PROXY_ID].leaf;
+		remove_lane(LEAF_ID, find_lane(LEAF_ID, PROXY_ID));
+
+		m_proxies[PROXY_ID].leaf	= NULL_INDEX;
+		m_proxies[PROXY_ID].next	= m_freeProxies;
+		m_freeProxies				= PROXY_ID;
+		--m_numProxies;
+
+		condense(LEAF_ID);
+	}
+
+	void		RTree::move(				const uint32_t		PROXY_ID,
+											const AABR&			BOX)
+	{
+		validate_proxy(PROXY_ID);
+
+		const uint32_t	LEAF_ID = m_proxies[PROXY_ID].leaf;
+		const Entry		ENTRY	= {BOX.min(), BOX.max(), PROXY_ID};
+
+		m_proxies[PROXY_ID].box = BOX;
+
+		// Bounds of the leaf are not shrunk, so that small movements stay local.
+		if(LEAF_ID == m_root)
+		{
+			set_lane(m_nodes[LEAF_ID], find_lane(LEAF_ID, PROXY_ID), ENTRY);
+			return;
+		}
+
+		const uint32_t	PARENT_ID	= m_nodes[LEAF_ID].parent;
+		const Entry		LEAF		= get_lane(m_nodes[PARENT_ID], find_lane(PARENT_ID, LEAF_ID));
+
+		if(glm::all(glm::lessThanEqual(LEAF.min, ENTRY.min)) && glm::all(glm::lessThanEqual(ENTRY.max, LEAF.max)))
+		{
+			set_lane(m_nodes[LEAF_ID], find_lane(LEAF_ID, PROXY_ID), ENTRY);
+			return;
+		}
+
+		remove_lane(LEAF_ID, find_lane(LEAF_ID, PROXY_ID));
+		condense(LEAF_ID);
+		insert_proxy(PROXY_ID);
+	}
+
+	void		RTree::validate() const
+	{
+		if(m_nodes[m_root].parent != NULL_INDEX)
+			throw dpl::GeneralException(this, __LINE__, "Root node has a parent.");
+
+		const uint32_t NUM_PROXIES = validate_subtree(m_root);
+		if(NUM_PROXIES != m_numProxies)
+			throw dpl::GeneralException(this, __LINE__, "Invalid number of proxies: " + std::to_string(NUM_PROXIES));
+
+		uint32_t numFree = 0;
+
+		for(uint32_t nodeID = m_freeNodes; nodeID != NULL_INDEX; nodeID = m_nodes[nodeID].parent)
+		{
+			if(++numFree > m_nodes.size())
+				throw dpl::GeneralException(this, __LINE__, "Free list is corrupted.");
+		}
+
+		if(m_numNodes + numFree != m_nodes.size())
+			throw dpl::GeneralException(this, __LINE__, "Some nodes are neither used nor free.");
+	}
+
+//=====> RTree -> private functions
+	void		RTree::set_lane(			Node&				node,
+											const uint32_t		LANE,
+											const Entry&		ENTRY)
+	{
+		node.minX[LANE]		= ENTRY.min.x;
+		node.minY[LANE]		= ENTRY.min.y;
+		node.maxX[LANE]		= ENTRY.max.x;
+		node.maxY[LANE]		= ENTRY.max.y;
+		node.children[LANE]	= ENTRY.child;
+	}
+
+	void		RTree::clear_lane(			Node&				node,
+											const uint32_t		LANE)
+	{
+		const float INF = std::numeric_limits<float>::infinity();
+
+		node.minX[LANE]		= INF;
+		node.minY[LANE]		= INF;
+		node.maxX[LANE]		= -INF;
+		node.maxY[LANE]		= -INF;
+		node.children[LANE]	= NULL_INDEX;
+	}
+
+	RTree::Entry	RTree::get_lane(		const Node&			NODE,
+											const uint32_t		LANE)
+	{
+		return {Vec2(NODE.minX[LANE], NODE.minY[LANE]), Vec2(NODE.maxX[LANE], NODE.maxY[LANE]), NODE.children[LANE]};
+	}
+
+	RTree::Entry	RTree::calculate_entry(	const uint32_t		NODE_ID) const
+	{
+		const Node& NODE = m_nodes[NODE_ID];
+
+		Entry output = get_lane(NODE, 0);
+		output.child = NODE_ID;
+
+		for(uint32_t lane = 1; lane < NODE.count; ++lane)
+		{
+			output.min = glm::min(output.min, Vec2(NODE.minX[lane], NODE.minY[lane]));
+			output.max = glm::max(output.max, Vec2(NODE.maxX[lane], NODE.maxY[lane]));
+		}
+
+		return output;
+	}
+
+	uint32_t	RTree::allocate_node(		const uint32_t		LEVEL)
+	{
+		uint32_t nodeID = m_freeNodes;
+
+		if(nodeID != NULL_INDEX)
+		{
+			m_freeNodes = m_nodes[nodeID].parent;
+		}
+		else
+		{
+			nodeID = static_cast<uint32_t>(m_nodes.size());
+			m_nodes.emplace_back();
+		}
+
+		Node& node	= m_nodes[nodeID];
+		node.parent	= NULL_INDEX;
+		node.count	= 0;
+		node.level	= LEVEL;
+
+		for(uint32_t lane = 0; lane < MAX_CHILDREN; ++lane)
+		{
+			clear_lane(node, lane);
+		}
+
+		++m_numNodes;
+		return nodeID;
+	}
+
+	void		RTree::free_node(			const uint32_t		NODE_ID)
+	{
+		m_nodes[NODE_ID].parent	= m_freeNodes;
+		m_freeNodes				= NODE_ID;
+		--m_numNodes;
+	}
+
+	void		RTree::set_parent(			const uint32_t		NODE_ID,
+											const uint32_t		LANE)
+	{
+		const Node&		NODE	= m_nodes[NODE_ID];
+		const uint32_t	CHILD	= NODE.children[LANE];
+
+		if(NODE.is_leaf())
+		{
+			m_proxies[CHILD].leaf = NODE_ID;
+		}
+		else
+		{
+			m_nodes[CHILD].parent = NODE_ID;
+		}
+	}
+
+	uint32_t	RTree::find_lane(			const uint32_t		PARENT_ID,
+											const uint32_t		CHILD_ID) const
+	{
+		const Node& PARENT = m_nodes[PARENT_ID];
+
+		for(uint32_t lane = 0; lane < PARENT.count; ++lane)
+		{
+			if(PARENT.children[lane] == CHILD_ID)
+				return lane;
+		}
+
+		throw dpl::GeneralException(this, __LINE__, "Child is not stored in its parent: " + std::to_string(CHILD_ID));
+	}
+
+	void		RTree::remove_lane(			const uint32_t		NODE_ID,
+											const uint32_t		LANE)
+	{
+		Node&			node = m_nodes[NODE_ID];
+		const uint32_t	LAST = --node.count;
+
+		if(LANE != LAST)
+			set_lane(node, LANE, get_lane(node, LAST));
+
+		clear_lane(node, LAST);
+	}
+
+	uint32_t	RTree::choose_node(			const Entry&		ENTRY,
+											const uint32_t		LEVEL) const
+	{
+		uint32_t nodeID = m_root;
+
+		while(m_nodes[nodeID].level > LEVEL)
+		{
+			const Node& NODE = m_nodes[nodeID];
+
+			uint32_t	bestLane		= 0;
+			float		bestEnlargement	= std::numeric_limits<float>::infinity();
+			float		bestArea		= std::numeric_limits<float>::infinity();
+
+			for(uint32_t lane = 0; lane < NODE.count; ++lane)
+			{
+				const Vec2	MIN				= Vec2(NODE.minX[lane], NODE.minY[lane]);
+				const Vec2	MAX				= Vec2(NODE.maxX[lane], NODE.maxY[lane]);
+				const float	AREA			= calculate_area(MIN, MAX);
+				const float	ENLARGEMENT		= calculate_area(glm::min(MIN, ENTRY.min), glm::max(MAX, ENTRY.max)) - AREA;
+
+				if(ENLARGEMENT < bestEnlargement || (ENLARGEMENT == bestEnlargement && AREA < bestArea))
+				{
+					bestLane		= lane;
+					bestEnlargement	= ENLARGEMENT;
+					bestArea		= AREA;
+				}
+			}
+
+			nodeID = NODE.children[bestLane];
+		}
+
+		return nodeID;
+	}
+
+	void		RTree::add_entry(			const uint32_t		NODE_ID,
+											const Entry&		ENTRY)
+	{
+		Node& node = m_nodes[NODE_ID];
+
+		if(node.count < MAX_CHILDREN)
+		{
+			set_lane(node, node.count, ENTRY);
+			set_parent(NODE_ID, node.count++);
+			refit_ancestors(NODE_ID);
+			return;
+		}
+
+		const uint32_t SIBLING_ID = split(NODE_ID, ENTRY);
+
+		if(NODE_ID == m_root)
+		{
+			const uint32_t ROOT_ID = allocate_node(m_nodes[NODE_ID].level + 1);
+
+			set_lane(m_nodes[ROOT_ID], 0, calculate_entry(NODE_ID));
+			set_lane(m_nodes[ROOT_ID], 1, calculate_entry(SIBLING_ID));
+			m_nodes[ROOT_ID].count = 2;
+			set_parent(ROOT_ID, 0);
+			set_parent(ROOT_ID, 1);
+			m_root = ROOT_ID;
+			return;
+		}
+
+		const uint32_t PARENT_ID = m_nodes[NODE_ID].parent;
+		set_lane(m_nodes[PARENT_ID], find_lane(PARENT_ID, NODE_ID), calculate_entry(NODE_ID));
+		add_entry(PARENT_ID, calculate_entry(SIBLING_ID));
+	}
+
+	uint32_t	RTree::split(				const uint32_t		NODE_ID,
+											const Entry&		ENTRY)
+	{
+		constexpr uint32_t NUM_ENTRIES		= MAX_CHILDREN + 1;
+		constexpr uint32_t NUM_DISTRIBUTIONS	= NUM_ENTRIES - 2 * MIN_CHILDREN + 1;
+
+		Entry entries[NUM_ENTRIES];
+
+		for(uint32_t lane = 0; lane < MAX_CHILDREN; ++lane)
+		{
+			entries[lane] = get_lane(m_nodes[NODE_ID], lane);
+		}
+
+		entries[MAX_CHILDREN] = ENTRY;
+
+		// Groups contain first K and remaining entries sorted along the axis. Bounds of both are accumulated from each side.
+		auto evaluate_axis = [&](const uint32_t AXIS, Vec2* prefixMin, Vec2* prefixMax, Vec2* suffixMin, Vec2* suffixMax)
+		{
+			std::sort(entries, entries + NUM_ENTRIES, [AXIS](const Entry& A, const Entry& B)
+			{
+				return A.min[AXIS] + A.max[AXIS] < B.min[AXIS] + B.max[AXIS];
+			});
+
+			prefixMin[0] = entries[0].min;
+			prefixMax[0] = entries[0].max;
+
+			for(uint32_t i = 1; i < NUM_ENTRIES; ++i)
+			{
+				prefixMin[i] = glm::min(prefixMin[i - 1], entries[i].min);
+				prefixMax[i] = glm::max(prefixMax[i - 1], entries[i].max);
+			}
+
+			suffixMin[NUM_ENTRIES - 1] = entries[NUM_ENTRIES - 1].min;
+			suffixMax[NUM_ENTRIES - 1] = entries[NUM_ENTRIES - 1].max;
+
+			for(uint32_t i = NUM_ENTRIES - 1; i-- > 0;)
+			{
+				suffixMin[i] = glm::min(suffixMin[i + 1], entries[i].min);
+				suffixMax[i] = glm::max(suffixMax[i + 1], entries[i].max);
+			}
+
+			float marginSum = 0.f;
+
+			for(uint32_t k = MIN_CHILDREN; k < MIN_CHILDREN + NUM_DISTRIBUTIONS; ++k)
+			{
+				marginSum += calculate_margin(prefixMin[k - 1], prefixMax[k - 1]) + calculate_margin(suffixMin[k], suffixMax[k]);
+			}
+
+			return marginSum;
+		};
+
+		Vec2 prefixMin[NUM_ENTRIES], prefixMax[NUM_ENTRIES], suffixMin[NUM_ENTRIES], suffixMax[NUM_ENTRIES];
+
+		// Axis with the smallest sum of margins is chosen, entries are left sorted along it.
+		const float MARGIN_X = evaluate_axis(0, prefixMin, prefixMax, suffixMin, suffixMax);
+		const float MARGIN_Y = evaluate_axis(1, prefixMin, prefixMax, suffixMin, suffixMax);
+
+		if(MARGIN_X < MARGIN_Y)
+			evaluate_axis(0, prefixMin, prefixMax, suffixMin, suffixMax);
+
+		// Distribution with the smallest overlap, then the smallest area.
+		uint32_t	bestK		= MIN_CHILDREN;
+		float		bestOverlap	= std::numeric_limits<float>::infinity();
+		float		bestArea	= std::numeric_limits<float>::infinity();
+
+		for(uint32_t k = MIN_CHILDREN; k < MIN_CHILDREN + NUM_DISTRIBUTIONS; ++k)
+		{
+			const Vec2	OVERLAP_MIN = glm::max(prefixMin[k - 1], suffixMin[k]);
+			const Vec2	OVERLAP_MAX = glm::min(prefixMax[k - 1], suffixMax[k]);
+			const float	OVERLAP		= calculate_area(OVERLAP_MIN, glm::max(OVERLAP_MIN, OVERLAP_MAX));
+			const float	AREA		= calculate_area(prefixMin[k - 1], prefixMax[k - 1]) + calculate_area(suffixMin[k], suffixMax[k]);
+
+			if(OVERLAP < bestOverlap || (OVERLAP == bestOverlap && AREA < bestArea))
+			{
+				bestK		= k;
+				bestOverlap	= OVERLAP;
+				bestArea	= AREA;
+			}
+		}
+
+		const uint32_t SIBLING_ID = allocate_node(m_nodes[NODE_ID].level);
+
+		Node& node		= m_nodes[NODE_ID];
+		Node& sibling	= m_nodes[SIBLING_ID];
+
+		for(uint32_t lane = 0; lane < MAX_CHILDREN; ++lane)
+		{
+			clear_lane(node, lane);
+		}
+
+		for(uint32_t i = 0; i < bestK; ++i)
+		{
+			set_lane(node, i, entries[i]);
+		}
+
+		for(uint32_t i = bestK; i < NUM_ENTRIES; ++i)
+		{
+			set_lane(sibling, i - bestK, entries[i]);
+		}
+
+		node.count		= bestK;
+		sibling.count	= NUM_ENTRIES - bestK;
+
+		for(uint32_t lane = 0; lane < node.count; ++lane)
+		{
+			set_parent(NODE_ID, lane);
+		}
+
+		for(uint32_t lane = 0; lane < sibling.count; ++lane)
+		{
+			set_parent(SIBLING_ID, lane);
+		}
+
+		return SIBLING_ID;
+	}
+
+	void		RTree::refit_ancestors(		uint32_t			nodeID)
+	{
+		while(nodeID != m_root)
+		{
+			const uint32_t	PARENT_ID	= m_nodes[nodeID].parent;
+			const uint32_t	LANE		= find_lane(PARENT_ID, nodeID);
+			const Entry		OLD_ENTRY	= get_lane(m_nodes[PARENT_ID], LANE);
+			const Entry		NEW_ENTRY	= calculate_entry(nodeID);
+
+			if(OLD_ENTRY.min == NEW_ENTRY.min && OLD_ENTRY.max == NEW_ENTRY.max)
+				return;
+
+			set_lane(m_nodes[PARENT_ID], LANE, NEW_ENTRY);
+			nodeID = PARENT_ID;
+		}
+	}
+
+	void		RTree::condense(			uint32_t			nodeID)
+	{
+		std::vector<uint32_t> orphans;
+
+		while(nodeID != m_root)
+		{
+			const uint32_t PARENT_ID	= m_nodes[nodeID].parent;
+			const uint32_t LANE			= find_lane(PARENT_ID, nodeID);
+
+			if(m_nodes[nodeID].count < MIN_CHILDREN)
+			{
+				remove_lane(PARENT_ID, LANE);
+				collect_proxies(nodeID, orphans);
+			}
+			else
+			{
+				set_lane(m_nodes[PARENT_ID], LANE, calculate_entry(nodeID));
+			}
+
+			nodeID = PARENT_ID;
+		}
+
+		// Root with a single child is replaced by that child.
+		while(!m_nodes[m_root].is_leaf() && m_nodes[m_root].count == 1)
+		{
+			const uint32_t OLD_ROOT = m_root;
+			m_root = m_nodes[OLD_ROOT].children[0];
+			m_nodes[m_root].parent = NULL_INDEX;
+			free_node(OLD_ROOT);
+		}
+
+		if(m_nodes[m_root].count == 0)
+			m_nodes[m_root].level = 0;
+
+		for(const uint32_t PROXY_ID : orphans)
+		{
+			insert_proxy(PROXY_ID);
+		}
+	}
+
+	void		RTree::collect_proxies(		const uint32_t		NODE_ID,
+											std::vector<uint32_t>& proxies)
+	{
+		const Node& NODE = m_nodes[NODE_ID];
+
+		for(uint32_t lane = 0; lane < NODE.count; ++lane)
+		{
+			if(NODE.is_leaf())
+			{
+				proxies.push_back(NODE.children[lane]);
+			}
+			else
+			{
+				collect_proxies(NODE.children[lane], proxies);
+			}
+		}
+
+		free_node(NODE_ID);
+	}
+
+	void		RTree::insert_proxy(		const uint32_t		PROXY_ID)
+	{
+		const AABR&	BOX		= m_proxies[PROXY_ID].box;
+		const Entry	ENTRY	= {BOX.min(), BOX.max(), PROXY_ID};
+
+		add_entry(choose_node(ENTRY, 0), ENTRY);
+	}
+
+	uint32_t	RTree::validate_subtree(	const uint32_t		NODE_ID) const
+	{
+		const Node& NODE = m_nodes[NODE_ID];
+
+		if(NODE.count > MAX_CHILDREN || (NODE.count == 0 && NODE_ID != m_root))
+			throw dpl::GeneralException(this, __LINE__, "Invalid number of children: " + std::to_string(NODE.count));
+
+		uint32_t numProxies = 0;
+
+		for(uint32_t lane = 0; lane < MAX_CHILDREN; ++lane)
+		{
+			const Entry LANE = get_lane(NODE, lane);
+
+			if(lane >= NODE.count)
+			{
+				if(LANE.child != NULL_INDEX || LANE.min.x <= LANE.max.x)
+					throw dpl::GeneralException(this, __LINE__, "Unused lane is not empty.");
+
+				continue;
+			}
+
+			if(NODE.is_leaf())
+			{
+				const Proxy& PROXY = m_proxies[LANE.child];
+
+				if(PROXY.leaf != NODE_ID)
+					throw dpl::GeneralException(this, __LINE__, "Invalid leaf of the proxy: " + std::to_string(LANE.child));
+
+				if(PROXY.box.min() != LANE.min || PROXY.box.max() != LANE.max)
+					throw dpl::GeneralException(this, __LINE__, "Invalid bounds of the proxy: " + std::to_string(LANE.child));
+
+				++numProxies;
+				continue;
+			}
+
+			const Node&	CHILD		= m_nodes[LANE.child];
+			const Entry	CHILD_ENTRY	= calculate_entry(LANE.child);
+
+			if(CHILD.parent != NODE_ID || CHILD.level + 1 != NODE.level)
+				throw dpl::GeneralException(this, __LINE__, "Invalid parent of the node: " + std::to_string(LANE.child));
+
+			if(glm::any(glm::greaterThan(LANE.min, CHILD_ENTRY.min)) || glm::any(glm::lessThan(LANE.max, CHILD_ENTRY.max)))
+				throw dpl::GeneralException(this, __LINE__, "Node is not enclosed by its parent: " + std::to_string(LANE.child));
+
+			numProxies += validate_subtree(LANE.child);
+		}
+
+		return numProxies;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "../include/cml_SpatialHash.h"
+
+
+namespace cml
+{
+	inline uint32_t	round_up_to_power_of_two(	const uint32_t		VALUE)
+	{
+		uint32_t output = 1;
+
+		while(output < VALUE)
+		{
+			output <<= 1;
+		}
+
+		return output;
+	}
+
+
+//=====> SpatialHash -> public lifecycle
+	CLASS_CTOR	SpatialHash::SpatialHash(		const float			CELL_SIZE,
+												const uint32_t		INITIAL_CAPACITY)
+		: m_freeList(NULL_INDEX)
+		, m_numObjects(0)
+		, m_numCells(0)
+		, m_cellSize(CELL_SIZE)
+		, m_inverseCellSize(1.f / CELL_SIZE)
+		, m_maxRadius(0.f)
+		, m_pairRange(-1)
+	{
+		if(CELL_SIZE <= 0.f)
+			throw dpl::GeneralException(this, __LINE__, "Cell size must be positive: " + std::to_string(CELL_SIZE));
+
+		m_slots.resize(round_up_to_power_of_two(glm::max(INITIAL_CAPACITY, 16u)), Slot{IVec3(0), NULL_INDEX});
+		update_max_radius(0.f);
+	}
+
+//=====> SpatialHash -> public functions
+	void		SpatialHash::clear()
+	{
+		m_objects.clear();
+		std::fill(m_slots.begin(), m_slots.end(), Slot{IVec3(0), NULL_INDEX});
+		m_freeList		= NULL_INDEX;
+		m_numObjects	= 0;
+		m_numCells		= 0;
+	}
+
+	uint32_t	SpatialHash::insert(			const Sphere&		SPHERE,
+												const uint32_t		OBJECT_ID)
+	{
+		uint32_t proxyID = m_freeList;
+
+		if(proxyID != NULL_INDEX)
+		{
+			m_freeList = m_objects[proxyID].next;
+		}
+		else
+		{
+			proxyID = static_cast<uint32_t>(m_objects.size());
+			m_objects.emplace_back();
+		}
+
+		Object& object	= m_objects[proxyID];
+		object.center	= SPHERE.center();
+		object.radius	= SPHERE.radius();
+		object.cell		= calculate_cell(object.center);
+		object.objectID	= OBJECT_ID;
+
+		update_max_radius(object.radius);
+		link(proxyID);
+		++m_numObjects;
+		return proxyID;
+	}
+
+	void		SpatialHash::remove(			const uint32_t		PROXY_ID)
+	{
+		validate_proxy(PROXY_ID);
+		unlink(PROXY_ID);
+
+		Object& object	= m_objects[PROXY_ID];
+		object.radius	= -1.f;
+		object.next		= m_freeList;
+		m_freeList		= PROXY_ID;
+		--m_numObjects;
+	}
+
+	void		SpatialHash::move(				const uint32_t		PROXY_ID,
+												const Sphere&		SPHERE)
+	{
+		validate_proxy(PROXY_ID);
+
+		const IVec3 NEW_CELL = calculate_cell(SPHERE.center());
+
+		if(NEW_CELL != m_objects[PROXY_ID].cell)
+		{
+			unlink(PROXY_ID);
+			m_objects[PROXY_ID].cell = NEW_CELL;
+			link(PROXY_ID);
+		}
+
+		m_objects[PROXY_ID].center = SPHERE.center();
+		m_objects[PROXY_ID].radius = SPHERE.radius();
+		update_max_radius(SPHERE.radius());
+	}
+
+//=====> SpatialHash -> private functions
+	uint32_t	SpatialHash::find_or_add_slot(	const IVec3&		CELL)
+	{
+		// Load factor is kept below 1/2, so that probe sequences stay short.
+		if(2 * (m_numCells + 1) > get_numSlots())
+			rehash(2 * get_numSlots());
+
+		const uint32_t MASK = get_numSlots() - 1;
+
+		for(uint32_t slotID = calculate_hash(CELL) & MASK;; slotID = (slotID + 1) & MASK)
+		{
+			Slot& slot = m_slots[slotID];
+
+			if(slot.head == NULL_INDEX)
+			{
+				slot.cell = CELL;
+				++m_numCells;
+				return slotID;
+			}
+
+			if(slot.cell == CELL)
+				return slotID;
+		}
+	}
+
+	void		SpatialHash::remove_slot(		const uint32_t		SLOT_ID)
+	{
+		// Backward shift deletion moves following entries of the probe sequence into the gap, so no tombstones are needed.
+		const uint32_t MASK = get_numSlots() - 1;
+
+		uint32_t gap = SLOT_ID;
+
+		for(uint32_t slotID = (gap + 1) & MASK; m_slots[slotID].head != NULL_INDEX; slotID = (slotID + 1) & MASK)
+		{
+			const uint32_t HOME = calculate_hash(m_slots[slotID].cell) & MASK;
+
+			// Entry can be moved only if its home slot is not between the gap and its current position.
+			const bool bCAN_MOVE = (gap <= slotID) ? (HOME <= gap || HOME > slotID)
+												   : (HOME <= gap && HOME > slotID);
+
+			if(bCAN_MOVE)
+			{
+				m_slots[gap]	= m_slots[slotID];
+				gap				= slotID;
+			}
+		}
+
+		m_slots[gap].head = NULL_INDEX;
+		--m_numCells;
+	}
+
+	void		SpatialHash::rehash(			const uint32_t		NUM_SLOTS)
+	{
+		std::vector<Slot> oldSlots(NUM_SLOTS, Slot{IVec3(0), NULL_INDEX});
+		m_slots.swap(oldSlots);
+
+		const uint32_t MASK = NUM_SLOTS - 1;
+
+		for(auto& iSlot : oldSlots)
+		{
+			if(iSlot.head == NULL_INDEX)
+				continue;
+
+			uint32_t slotID = calculate_hash(iSlot.cell) & MASK;
+
+			while(m_slots[slotID].head != NULL_INDEX)
+			{
+				slotID = (slotID + 1) & MASK;
+			}
+
+			m_slots[slotID] = iSlot;
+		}
+	}
+
+	void		SpatialHash::link(				const uint32_t		PROXY_ID)
+	{
+		Object&			object	= m_objects[PROXY_ID];
+		const uint32_t	SLOT_ID = find_or_add_slot(object.cell);
+		Slot&			slot	= m_slots[SLOT_ID];
+
+		object.previous	= NULL_INDEX;
+		object.next		= slot.head;
+
+		if(slot.head != NULL_INDEX)
+			m_objects[slot.head].previous = PROXY_ID;
+
+		slot.head = PROXY_ID;
+	}
+
+	void		SpatialHash::unlink(			const uint32_t		PROXY_ID)
+	{
+		const Object& OBJECT = m_objects[PROXY_ID];
+
+		if(OBJECT.next != NULL_INDEX)
+			m_objects[OBJECT.next].previous = OBJECT.previous;
+
+		if(OBJECT.previous != NULL_INDEX)
+		{
+			m_objects[OBJECT.previous].next = OBJECT.next;
+			return;
+		}
+
+		// Object was the head of its cell.
+		const uint32_t SLOT_ID = find_slot(OBJECT.cell);
+		m_slots[SLOT_ID].head = OBJECT.next;
+
+		if(OBJECT.next == NULL_INDEX)
+			remove_slot(SLOT_ID);
+	}
+
+	void		SpatialHash::update_max_radius(	const float			RADIUS)
+	{
+		m_maxRadius = glm::max(m_maxRadius, RADIUS);
+
+		// Centers of intersecting spheres can not be more cells apart than the largest diameter spans.
+		const int32_t RANGE = static_cast<int32_t>(glm::ceil(2.f * m_maxRadius * m_inverseCellSize));
+		if(RANGE == m_pairRange)
+			return;
+
+		m_pairRange = RANGE;
+		m_forwardOffsets.clear();
+
+		for(int32_t z = -RANGE; z <= RANGE; ++z)
+		{
+			for(int32_t y = -RANGE; y <= RANGE; ++y)
+			{
+				for(int32_t x = -RANGE; x <= RANGE; ++x)
+				{
+					const bool bFORWARD = (z > 0) || (z == 0 && y > 0) || (z == 0 && y == 0 && x > 0);
+
+					if(bFORWARD)
+						m_forwardOffsets.push_back(IVec3(x, y, z));
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
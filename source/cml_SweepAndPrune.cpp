@@ -0,0 +1,257 @@
+#include "../include/cml_SweepAndPrune.h"
+#include <algorithm>
+
+
+namespace cml
+{
+//=====> SweepAndPrune -> public lifecycle
+	CLASS_CTOR	SweepAndPrune::SweepAndPrune(		const uint32_t		AXIS)
+		: m_freeList(NULL_INDEX)
+		, m_numProxies(0)
+		, m_numSorted(0)
+		, m_axis(0)
+	{
+		set_axis(AXIS);
+	}
+
+//=====> SweepAndPrune -> public functions
+	void		SweepAndPrune::set_axis(			const uint32_t		AXIS)
+	{
+		if(AXIS > 2)
+			throw dpl::GeneralException(this, __LINE__, "Invalid axis: " + std::to_string(AXIS));
+
+		if(AXIS == m_axis)
+			return;
+
+		// Order along the previous axis does not help, so all endpoints are sorted from scratch.
+		m_axis		= AXIS;
+		m_numSorted	= 0;
+	}
+
+	uint32_t	SweepAndPrune::calculate_best_axis() const
+	{
+		if(m_numProxies < 2)
+			return m_axis;
+
+		Vec3 sum(0.f, 0.f, 0.f);
+		Vec3 squaredSum(0.f, 0.f, 0.f);
+
+		for(auto& iProxy : m_proxies)
+		{
+			if(!iProxy.bUsed)
+				continue;
+
+			const Vec3 CENTER = iProxy.box.center();
+			sum			+= CENTER;
+			squaredSum	+= CENTER * CENTER;
+		}
+
+		const float	INVERSE_COUNT	= 1.f / static_cast<float>(m_numProxies);
+		const Vec3	MEAN			= sum * INVERSE_COUNT;
+		const Vec3	VARIANCE		= squaredSum * INVERSE_COUNT - MEAN * MEAN;
+
+		if(VARIANCE.x >= VARIANCE.y && VARIANCE.x >= VARIANCE.z)
+			return 0;
+
+		return (VARIANCE.y >= VARIANCE.z) ? 1 : 2;
+	}
+
+	void		SweepAndPrune::clear()
+	{
+		m_proxies.clear();
+		m_endpoints.clear();
+		m_pairs.clear();
+		m_activeIndices.clear();
+		m_removed.clear();
+		m_beganPairs.clear();
+		m_endedPairs.clear();
+		m_freeList		= NULL_INDEX;
+		m_numProxies	= 0;
+		m_numSorted		= 0;
+	}
+
+	uint32_t	SweepAndPrune::insert(				const AABB&			BOX,
+													const uint32_t		OBJECT_ID)
+	{
+		uint32_t proxyID = m_freeList;
+
+		if(proxyID != NULL_INDEX)
+		{
+			m_freeList = m_proxies[proxyID].next;
+		}
+		else
+		{
+			proxyID = static_cast<uint32_t>(m_proxies.size());
+			m_proxies.emplace_back();
+		}
+
+		Proxy& proxy	= m_proxies[proxyID];
+		proxy.box		= BOX;
+		proxy.objectID	= OBJECT_ID;
+		proxy.next		= NULL_INDEX;
+		proxy.bUsed		= true;
+
+		m_endpoints.push_back({0.f, proxyID << 1});
+		m_endpoints.push_back({0.f, (proxyID << 1) | 1});
+		++m_numProxies;
+		return proxyID;
+	}
+
+	void		SweepAndPrune::remove(				const uint32_t		PROXY_ID)
+	{
+		validate_proxy(PROXY_ID);
+		m_proxies[PROXY_ID].bUsed = false;
+		m_removed.push_back(PROXY_ID);
+		--m_numProxies;
+	}
+
+	void		SweepAndPrune::move(				const uint32_t		PROXY_ID,
+													const AABB&			BOX)
+	{
+		validate_proxy(PROXY_ID);
+		m_proxies[PROXY_ID].box = BOX;
+	}
+
+	void		SweepAndPrune::update(				const bool			bCHOOSE_AXIS)
+	{
+		if(bCHOOSE_AXIS)
+			set_axis(calculate_best_axis());
+
+		sort_endpoints();
+		sweep();
+		report_changes();
+
+		// Removed proxies can be reused once their pairs were reported as ended.
+		for(const uint32_t PROXY_ID : m_removed)
+		{
+			m_proxies[PROXY_ID].next	= m_freeList;
+			m_freeList					= PROXY_ID;
+		}
+
+		m_removed.clear();
+	}
+
+//=====> SweepAndPrune -> private functions
+	void		SweepAndPrune::sort_endpoints()
+	{
+		// Endpoints of removed proxies are dropped, remaining endpoints keep their order.
+		if(!m_removed.empty())
+		{
+			uint32_t numKept		= 0;
+			uint32_t numSortedKept	= 0;
+
+			for(uint32_t i = 0; i < m_endpoints.size(); ++i)
+			{
+				if(!m_proxies[m_endpoints[i].get_proxyID()].bUsed)
+					continue;
+
+				if(i < m_numSorted)
+					++numSortedKept;
+
+				m_endpoints[numKept++] = m_endpoints[i];
+			}
+
+			m_endpoints.resize(numKept);
+			m_numSorted = numSortedKept;
+		}
+
+		for(auto& iEndpoint : m_endpoints)
+		{
+			iEndpoint.value = get_value(iEndpoint);
+		}
+
+		// Previous order is nearly sorted, so insertion sort needs only few swaps.
+		for(uint32_t i = 1; i < m_numSorted; ++i)
+		{
+			const Endpoint CURRENT = m_endpoints[i];
+
+			uint32_t position = i;
+
+			for(; position > 0 && CURRENT < m_endpoints[position - 1]; --position)
+			{
+				m_endpoints[position] = m_endpoints[position - 1];
+			}
+
+			m_endpoints[position] = CURRENT;
+		}
+
+		// Endpoints added since the previous update are in random order, so they are sorted separately and merged.
+		if(m_numSorted < m_endpoints.size())
+		{
+			std::sort(m_endpoints.begin() + m_numSorted, m_endpoints.end());
+			std::inplace_merge(m_endpoints.begin(), m_endpoints.begin() + m_numSorted, m_endpoints.end());
+		}
+
+		m_numSorted = static_cast<uint32_t>(m_endpoints.size());
+	}
+
+	void		SweepAndPrune::sweep()
+	{
+		m_currentPairs.clear();
+		m_active.clear();
+		m_activeIndices.resize(m_proxies.size());
+
+		for(auto& iEndpoint : m_endpoints)
+		{
+			const uint32_t PROXY_ID = iEndpoint.get_proxyID();
+
+			if(iEndpoint.is_max())
+			{
+				const uint32_t INDEX = m_activeIndices[PROXY_ID];
+
+				m_active[INDEX]					= m_active.back();
+				m_activeIndices[m_active[INDEX]]	= INDEX;
+				m_active.pop_back();
+				continue;
+			}
+
+			// Intervals overlap along the sweep axis, remaining axes are tested by the box.
+			const AABB& BOX = m_proxies[PROXY_ID].box;
+
+			for(const uint32_t OTHER_ID : m_active)
+			{
+				if(BOX.intersects(m_proxies[OTHER_ID].box))
+					m_currentPairs.push_back(make_key(PROXY_ID, OTHER_ID));
+			}
+
+			m_activeIndices[PROXY_ID] = static_cast<uint32_t>(m_active.size());
+			m_active.push_back(PROXY_ID);
+		}
+
+		std::sort(m_currentPairs.begin(), m_currentPairs.end());
+	}
+
+	void		SweepAndPrune::report_changes()
+	{
+		m_beganPairs.clear();
+		m_endedPairs.clear();
+
+		auto make_pair = [&](const uint64_t KEY)
+		{
+			return Pair{m_proxies[get_proxyA(KEY)].objectID, m_proxies[get_proxyB(KEY)].objectID};
+		};
+
+		// Both sets are sorted, so they are compared in a single merge pass.
+		auto iPrevious	= m_pairs.begin();
+		auto iCurrent	= m_currentPairs.begin();
+
+		while(iPrevious != m_pairs.end() || iCurrent != m_currentPairs.end())
+		{
+			if(iCurrent == m_currentPairs.end() || (iPrevious != m_pairs.end() && *iPrevious < *iCurrent))
+			{
+				m_endedPairs.push_back(make_pair(*iPrevious++));
+			}
+			else if(iPrevious == m_pairs.end() || *iCurrent < *iPrevious)
+			{
+				m_beganPairs.push_back(make_pair(*iCurrent++));
+			}
+			else
+			{
+				++iPrevious;
+				++iCurrent;
+			}
+		}
+
+		m_pairs.swap(m_currentPairs);
+	}
+}
\ No newline at end of file
@@ -1,11 +1,12 @@
 #include "..//include/cml_TriangleMesh.h"
-#include <set>
-#include <map>
 #include <unordered_map>
 #include <array>
-#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
 #include <dpl_GeneralException.h>
 #include <poly2tri/poly2tri.h>
+#include "..//include/cml_parallel.h"
 
 #pragma warning (disable: 26451)
 
@@ -43,6 +44,55 @@ namespace cml
 		return NUM_BASE_TRIANGLES + numVertices - numHoleTriangles;
 	}
 
+	/*
+		Hash of the integer cell used for welding vertices.
+	*/
+	struct	WeldCellHash
+	{
+		inline size_t operator()(const IVec3& CELL) const
+		{
+			const uint32_t HASH =	(static_cast<uint32_t>(CELL.x) * 73856093u) ^
+									(static_cast<uint32_t>(CELL.y) * 19349663u) ^
+									(static_cast<uint32_t>(CELL.z) * 83492791u);
+
+			return HASH ^ (HASH >> 16);
+		}
+	};
+
+	/*
+		FIFO vertex cache, vertex is cached when it was one of the last CACHE_SIZE inserted vertices.
+	*/
+	class	FifoCache
+	{
+	private: // data
+		std::vector<uint32_t>	m_insertions;
+		uint32_t				m_size;
+		uint32_t				m_time;
+
+	public: // lifecycle
+		CLASS_CTOR				FifoCache(			const uint32_t		NUM_VERTICES,
+													const uint32_t		CACHE_SIZE)
+			: m_insertions(NUM_VERTICES, 0)
+			, m_size(CACHE_SIZE)
+			, m_time(CACHE_SIZE)
+		{
+
+		}
+
+	public: // functions
+		/*
+			Returns true when vertex was not in the cache.
+		*/
+		inline bool				access(				const uint32_t		VERTEX_ID)
+		{
+			if(m_time - m_insertions[VERTEX_ID] < m_size)
+				return false;
+
+			m_insertions[VERTEX_ID] = m_time++;
+			return true;
+		}
+	};
+
 	Contour				to_contour(				const TriangleMesh::Vertices2D&		VERTICES,
 												const uint64_t						BEGIN,
 												const uint64_t						END)
@@ -65,187 +115,56 @@ namespace cml
 	}
 
 
-	namespace Triangulation
+	/*
+		Sorts indices of the elements from the smallest one, replaces ordered set of unique elements.
+	*/
+	template<typename T>
+	void				sort_unique(			const std::vector<T>&				ELEMENTS,
+												std::vector<uint32_t>&				output)
 	{
-		class	OrientedEdge
-		{
-		public: // data
-			dpl::ReadOnly<uint32_t,		OrientedEdge> beginID;
-			dpl::ReadOnly<uint32_t,		OrientedEdge> endID;
-			dpl::ReadOnly<Orientation,	OrientedEdge> orientation;
-
-		public: // lifecycle
-			CLASS_CTOR			OrientedEdge(	const uint32_t		BEGIN_ID, 
-												const uint32_t		END_ID, 
-												const Orientation 	ORIENTATION)
-				: beginID(BEGIN_ID)
-				, endID(END_ID)
-				, orientation(ORIENTATION)
-			{
-
-			}
+		output.resize(ELEMENTS.size());
 
-		public: // functions
-			inline bool			operator==(		const OrientedEdge&	OTHER) const
-			{
-				return OTHER.beginID == beginID && OTHER.endID == endID;
-			}
+		for(uint32_t index = 0; index < output.size(); ++index)
+		{
+			output[index] = index;
+		}
 
-			inline bool			operator!=(		const OrientedEdge&	OTHER) const
-			{
-				return OTHER.beginID != beginID || OTHER.endID != endID;
-			}
+		std::sort(output.begin(), output.end(), [&](const uint32_t A, const uint32_t B)
+		{
+			return ELEMENTS[A] < ELEMENTS[B];
+		});
 
-			inline const Vec2&	begin(			const Vec2*			VERTEX_BUFFER) const
-			{
-				return VERTEX_BUFFER[beginID];
-			}
+		for(uint64_t index = 1; index < output.size(); ++index)
+		{
+			if(!(ELEMENTS[output[index-1]] < ELEMENTS[output[index]]))
+				throw dpl::GeneralException(__FILE__, __LINE__, "No two, arbitrary vertices of the polygon and its holes can share the same X and Y coordinate.");
+		}
+	}
 
-			inline const Vec2&	end(			const Vec2*			VERTEX_BUFFER) const
-			{
-				return VERTEX_BUFFER[endID];
-			}
+	namespace Triangulation
+	{
+		constexpr uint32_t	NULL_INDEX = 0xFFFFFFFF;
 
-			/*
-			inline void			flip()
-			{
-				std::swap(*beginID, *endID);
-				orientation = (orientation == Orientation::CW) ? Orientation::CCW : Orientation::CW;
-			}
-			*/
-		};
+		using	Triangle		= std::array<uint32_t, 3>;
+		using	Triangles		= std::vector<Triangle>;
 
 		/*
-			This class contains information about edges connected to the vertex.
-
-			There are 3 types of nodes
-
-			Node with both vectors starting on node's position.
-				A
-			   /
-			  T
-			   \
-			    B
-			--------------------------------> +X
-			Node with two vectors ending on node's position. 
-			 A
-			  \
-			   T
-			  /
-			 B
-			--------------------------------> +X
-			Node with one vector starting and second ending on node's position.
-			    A
-			   /
-		      T	
-			 /
-			B
-			--------------------------------> +X
-			where A and B are edges connected to adjacent KNodes
-
-
-			- nodes can be sorted with < operator using pointer to vertex
-			- nodes can generate edges
+			Edge of the polygon that is cut into triangles, edges are linked by their indices.
 		*/
-		class	TNode
-		{
-		public: // data
-			dpl::ReadOnly<Orientation,	TNode>	orientation;
-			dpl::ReadOnly<uint32_t,		TNode>	vertexID;
-			dpl::ReadOnly<uint32_t,		TNode>	prevID;
-			dpl::ReadOnly<uint32_t,		TNode>	nextID;		
-			dpl::ReadOnly<const Vec2*,	TNode>	vertices;
-
-		public: // lifecycle
-			CLASS_CTOR				TNode(			const Orientation	ORIENTATION,
-													const uint32_t		VERTEX_ID,
-													const uint32_t		PREV_ID,
-													const uint32_t		NEXT_ID,
-													const Vec2*			VERTEX_BUFFER)
-				: orientation(ORIENTATION)
-				, vertexID(VERTEX_ID)
-				, prevID(PREV_ID)
-				, nextID(NEXT_ID)
-				, vertices(VERTEX_BUFFER)
-			{
-
-			}
-
-		public: // functions
-			inline const Vec2&		vertex() const
-			{
-				return vertices()[vertexID];
-			}
-
-			inline const Vec2&		previous() const
-			{
-				return vertices()[prevID];
-			}
-
-			inline const Vec2&		next() const
-			{
-				return vertices()[nextID];
-			}
-
-			inline bool				operator<(		const TNode&		OTHER) const
-			{
-				return less(this->vertex(), OTHER.vertex());
-			}
-
-			inline bool				is_IN_end() const
-			{
-				return less(previous(), vertex());
-			}
-
-			inline bool				is_OUT_end() const
-			{
-				return less(next(), vertex());
-			}
-
-			inline OrientedEdge		calculate_IN() const
-			{
-				return OrientedEdge(prevID, vertexID, orientation);
-			}
-
-			inline OrientedEdge		calculate_OUT() const
-			{
-				return OrientedEdge(vertexID, nextID, orientation);
-			}
-
-		private: // functions
-			inline bool less(const Vec2& LHS, const Vec2& RHS) const
-			{
-				if(LHS.x > RHS.x)	return false;
-				if(LHS.x < RHS.x)	return true;
-				return LHS.y < RHS.y;
-			}
-		};
-
-		class	KNode : public Vec2
+		struct	ChainEdge
 		{
-		public: // inherited
-			using Vec2::Vec2;
-
-		public: // functions
-			inline bool		operator<(		const KNode&		OTHER) const
-			{
-				if(this->x > OTHER.x)	return false;
-				if(this->x < OTHER.x)	return true;
-				return this->y < OTHER.y;
-			}
+			uint32_t	beginID;
+			uint32_t	endID;
+			uint32_t	previous;
+			uint32_t	next;
 		};
 
-		
-		using	ContourList		= std::list<Contour>;
-		using	Triangle		= std::array<uint32_t, 3>;
-		using	Triangles		= std::vector<Triangle>;
-		using	SortedNodes		= std::set<TNode>;
-
-		struct	Result
+		/*
+			Buffers reused between triangulations.
+		*/
+		struct	Scratch
 		{
-			SortedNodes		nodes;
-			ContourArray	monotones;
-			Triangles		triangles;
+			std::vector<ChainEdge>	chain;
 		};
 	}
 
@@ -392,50 +311,40 @@ namespace cml
 
 		using	Triangle		= std::array<uint32_t, 3>;
 		using	Triangles		= std::vector<Triangle>;
-		using	SortedEdges		= std::map<OrientedEdge, std::unique_ptr<Contour>>; // Maps edges with potential monotone polygons.
-		using	Intersections	= std::unordered_map<float, std::vector<SortedEdges::iterator>>; // All edges that intersect given X coordinate.
-	}
-}
-
-namespace std
-{
-	template <>
-	struct hash<cml::Triangulation::OrientedEdge>
-	{
-		static size_t	calculate(	const cml::Triangulation::OrientedEdge& EDGE)
-		{
-			if(EDGE.beginID > EDGE.endID)
-				return (hash<uint32_t>()(EDGE.beginID) ^ hash<uint32_t>()(EDGE.endID) << 1);
-
-			return (hash<uint32_t>()(EDGE.endID) ^ hash<uint32_t>()(EDGE.beginID) << 1);
-		}
 
-		size_t			operator()(	const cml::Triangulation::OrientedEdge& link) const
+		/*
+			Vertex of the monotone polygon. Vertices of all polygons are stored in one buffer and linked by their indices.
+		*/
+		struct	MonotoneLink
 		{
-			return calculate(link);
-		}
-	};
+			uint32_t	vertexID;
+			uint32_t	next;
+		};
 
-	template <>
-	struct hash<cml::Triangulation2::OrientedEdge>
-	{
-		static size_t	calculate(	const cml::Triangulation2::OrientedEdge& EDGE)
+		struct	Monotone
 		{
-			if(EDGE.beginID > EDGE.endID)
-				return (hash<uint32_t>()(EDGE.beginID) ^ hash<uint32_t>()(EDGE.endID) << 1);
-
-			return (hash<uint32_t>()(EDGE.endID) ^ hash<uint32_t>()(EDGE.beginID) << 1);
-		}
+			uint32_t	head; // NULL_INDEX if edge has no monotone polygon.
+			uint32_t	tail;
+			uint32_t	size;
+		};
 
-		size_t			operator()(	const cml::Triangulation2::OrientedEdge& link) const
+		/*
+			Buffers reused between triangulations.
+			Edges are referenced by their rank, which is the position of the edge sorted by its begin vertex.
+		*/
+		struct	Scratch
 		{
-			return calculate(link);
-		}
-	};
-}
+			std::vector<OrientedEdge>	edges;		// In the order of contours.
+			std::vector<uint32_t>		sorted;		// Edge indices sorted by begin vertex.
+			std::vector<uint32_t>		entering;	// Ranks sorted by the left end of the edge.
+			std::vector<uint32_t>		active;		// Sorted ranks of the edges that span X coordinate of the current vertex.
+			std::vector<Monotone>		monotones;	// Potential monotone polygon of each rank.
+			std::vector<MonotoneLink>	links;
+			Contour						contour;
+			Triangulation::Scratch		triangulation;
+		};
+	}
 
-namespace cml
-{
 	namespace Triangulation
 	{
 		Orientation			calculate_winding(		const uint32_t*						CONTOUR,
@@ -455,153 +364,13 @@ namespace cml
 			return signedArea < 0.f ? Orientation::CW : Orientation::CCW;
 		}
 
-		void				contour_to_TNodes(		const Contour&						CONTOUR,
-													const Orientation					TARGET_ORIENTATION,
-													const Vec2*							VERTEX_BUFFER,
-													SortedNodes&						output)
-		{
-			validate_contour(CONTOUR);
-
-			const uint32_t		NUM_VERTICES	= static_cast<uint32_t>(CONTOUR.size());
-			const Orientation	ORIENTATION		= calculate_winding(CONTOUR.data(), NUM_VERTICES, VERTEX_BUFFER);
-
-			for (uint32_t i = NUM_VERTICES - 1, j = 0; j < NUM_VERTICES; i = j++)
-			{
-				const uint32_t	CURRENT_ID	= CONTOUR.at(j);
-				uint32_t		prevID		= CONTOUR.at(i);
-				uint32_t		nextID		= CONTOUR.at((j+1)%NUM_VERTICES);
-
-				if(ORIENTATION != TARGET_ORIENTATION) std::swap(prevID, nextID);
-
-				auto result = output.emplace(TARGET_ORIENTATION, CONTOUR.at(j), prevID, nextID, VERTEX_BUFFER);
-				if(result.second == false)
-					throw dpl::GeneralException(__FILE__, __LINE__, "No two, arbitrary vertices of the polygon and its holes can share the same X and Y coordinate.");
-			}
-		}
-
-		ContourList			TNodes_to_monotones(	const SortedNodes&					NODES,
-													const Vec2*							VERTEX_BUFFER)
-		{
-			ContourList output;
-
-			// Pointer to Contour forces output to be a list instead of a vector.
-			std::unordered_map<OrientedEdge, Contour*>	openPolygons;  // open map of edges that are used to generate monotone polygons
-
-			// Triangulation starts here.
-			// We process each T-Node from left to right and try to assign it to the monotone polygon.
-			for(auto& iNode : NODES)
-			{
-				const OrientedEdge IN  = iNode.calculate_IN();
-				const OrientedEdge OUT = iNode.calculate_OUT();
-
-				// Distance to closest edge above the node.
-				const OrientedEdge* edgeAbove		= nullptr;
-				float				aboveDistance	= std::numeric_limits<float>::max();
-
-				// Distance to closest edge below the node.
-				const OrientedEdge* edgeBelow		= nullptr;
-				float				belowDistance	= std::numeric_limits<float>::max();
-
-				// Each edge, no matter if we can add it to the polygon or not, can override edges above or below.
-				// We will check on which side of the edge is the current TNode and based on that we will decide 
-				// whether or not it will be added. 
-				for(auto& iMonotone : openPolygons)
-				{
-					// edge cannot be connected to KNode
-					if(iMonotone.first != IN && iMonotone.first != OUT)
-					{
-						const Vec2& EDGE_START	= iMonotone.first.begin(VERTEX_BUFFER);
-						const Vec2& EDGE_END	= iMonotone.first.end(VERTEX_BUFFER);
-
-						//if(right_side(EDGE_START, EDGE_END, iNode.vertex()))
-						{
-							// This is the distance between edge Y coordinate and the TNode at the TNode.x position
-							// note that if distance is negative edge is above TNode.
-							if(auto SIGNED_DISTANCE = signed_Y_distance(EDGE_START, EDGE_END, iNode.vertex()))
-							{
-								const float DISTANCE = abs(SIGNED_DISTANCE.value());
-								if(SIGNED_DISTANCE < 0.f)
-								{
-									if(DISTANCE < aboveDistance)
-									{
-										aboveDistance	= DISTANCE;
-										edgeAbove		= &iMonotone.first;
-									}
-								}
-								else 
-								{
-									if(DISTANCE < belowDistance)
-									{
-										belowDistance	= DISTANCE;
-										edgeBelow		= &iMonotone.first;
-									}
-								}
-							}
-						}	
-					}
-				}
-
-				if(edgeBelow)
-				{
-					if(right_side(edgeBelow->begin(VERTEX_BUFFER), edgeBelow->end(VERTEX_BUFFER), iNode.vertex()))
-						openPolygons[*edgeBelow]->push_back(iNode.vertexID());
-				}
-				if(edgeAbove && (edgeAbove != edgeBelow || edgeBelow == nullptr))
-				{	
-					if(right_side(edgeAbove->begin(VERTEX_BUFFER), edgeAbove->end(VERTEX_BUFFER), iNode.vertex()))
-						openPolygons[*edgeAbove]->push_back(iNode.vertexID());
-				}
-
-
-				{auto& pIN	= openPolygons[IN];
-
-					if(pIN == nullptr) pIN = &output.emplace_back();
-					pIN->push_back(iNode.vertexID());
-				}
-
-				{auto& pOUT	= openPolygons[OUT];
-
-					if(pOUT == nullptr) pOUT = &output.emplace_back();
-					pOUT->push_back(iNode.vertexID());
-				}
-		
-				// Close the polygon(remove polygon from the open list).
-				if(iNode.is_IN_end())	openPolygons.erase(IN);
-				if(iNode.is_OUT_end())	openPolygons.erase(OUT);
-			}
-
-			if(openPolygons.size() != 0)
-				throw dpl::GeneralException(__FILE__, __LINE__, "Triangulation could not be completed. Number of edges that was not processed: " + std::to_string(openPolygons.size()));
-
-			uint32_t numInvalid = 0;
-
-			// Erase contours with less than 3 vertices.
-			for(auto iContour = output.begin(); iContour != output.end();)
-			{
-				if(iContour->size() < 3)
-				{
-					++numInvalid;
-					iContour = output.erase(iContour);
-				}
-				else
-				{
-					++iContour;
-				}
-			}
-
-			if(numInvalid > 0)
-			{
-				int breakpoint = 0;
-			}
-
-			return output;
-		}
-
-		Triangle			create_triangle(		std::list<OrientedEdge>::iterator	current, 
+		Triangle			create_triangle(		const uint32_t						FIRST_ID,
+													const uint32_t						SECOND_ID,
+													const uint32_t						THIRD_ID,
 													const Orientation					TARGET_ORIENTATION,
 													const Vec2*							VERTEX_BUFFER)
 		{
-			Triangle triangle{current->beginID(), current->endID(), (++current)->endID()};
+			Triangle triangle{FIRST_ID, SECOND_ID, THIRD_ID};
 
 			if(calculate_winding(triangle.data(), 3, VERTEX_BUFFER) != TARGET_ORIENTATION)
 			{
@@ -614,6 +383,7 @@ namespace cml
 		void				perform_triangulation(	const Contour&						MONOTONE,
 													const Orientation					TARGET_ORIENTATION,
 													const Vec2*							VERTEX_BUFFER,
+													std::vector<ChainEdge>&				chain,
 													Triangles&							output)
 		{
 			validate_contour(MONOTONE);
@@ -621,82 +391,76 @@ namespace cml
 			const uint32_t		NUM_VERTICES	= static_cast<uint32_t>(MONOTONE.size());
 			const Orientation	ORIENTATION		= calculate_winding(MONOTONE.data(), NUM_VERTICES, VERTEX_BUFFER);
 
-			std::list<OrientedEdge> openList; // list of edges to process
+			// List of edges to process, first edge is never removed.
+			chain.resize(NUM_VERTICES);
 
 			for(uint32_t index = 0; index < NUM_VERTICES; ++index)
 			{
-				openList.emplace_back(MONOTONE[index], MONOTONE[(index+1)%NUM_VERTICES], ORIENTATION);
+				chain[index] = {MONOTONE[index], MONOTONE[(index+1)%NUM_VERTICES], index - 1, index + 1};
 			}
 
-			auto current = openList.begin();
-			
-			while(openList.size() > 3)
+			chain.front().previous	= NULL_INDEX;
+			chain.back().next		= NULL_INDEX;
+
+			uint32_t current	= 0;
+			uint32_t numEdges	= NUM_VERTICES;
+
+			while(numEdges > 3)
 			{
-				auto next = std::next(current);
+				uint32_t next = chain[current].next;
 
 				while(1)
 				{
-					const bool bRIGHT = right_side(	current->begin(VERTEX_BUFFER), 
-													current->end(VERTEX_BUFFER), 
-													next->end(VERTEX_BUFFER));
+					if(next == NULL_INDEX)
+						throw dpl::GeneralException(__FILE__, __LINE__, "Invalid monotone polygon.");
+
+					const bool bRIGHT = right_side(	VERTEX_BUFFER[chain[current].beginID],
+													VERTEX_BUFFER[chain[current].endID],
+													VERTEX_BUFFER[chain[next].endID]);
 
 					if(ORIENTATION == Orientation::CW ? !bRIGHT : bRIGHT)
-						current = next++; // based on how monotone polygon was created we will never go out of bounds
+					{
+						current	= next;
+						next	= chain[next].next;
+					}
 					else
 						break;
 				}
 
-				output.emplace_back(create_triangle(current, TARGET_ORIENTATION, VERTEX_BUFFER));
+				output.emplace_back(create_triangle(chain[current].beginID, chain[current].endID, chain[next].endID, TARGET_ORIENTATION, VERTEX_BUFFER));
 
 				/*
-					-> [newCurrent] -> [oldCurrent] -> [oldNext] ->
-							(insert)       (erase[1])     (erase[2])
+					-> [current] -> [next] ->		becomes		-> [current(begin of current, end of next)] ->
 				*/
-				current = openList.insert(current, OrientedEdge(current->beginID(), next->endID(), ORIENTATION));
-				openList.erase(openList.erase(std::next(current)));
+				chain[current].endID	= chain[next].endID;
+				chain[current].next		= chain[next].next;
+
+				if(chain[next].next != NULL_INDEX)
+					chain[chain[next].next].previous = current;
+
+				--numEdges;
 
 				// now is an interesting part, if we skip this step, we may generate invalid polygon,
 				// we must try to decrement current iterator in order to combine some previous edge with newly generated one
 				// otherwise we will reach the point in which we have to loop whole triangulation process ...
-				if(current != openList.begin())
-					--current;
+				if(current != 0)
+					current = chain[current].previous;
 			}
 
 			// Generate last triangle from remaining 3 edges.
-			output.emplace_back(create_triangle(openList.begin(), TARGET_ORIENTATION, VERTEX_BUFFER));
+			output.emplace_back(create_triangle(chain[0].beginID, chain[0].endID, chain[chain[0].next].endID, TARGET_ORIENTATION, VERTEX_BUFFER));
 		}
+	}
 
-		Result				execute(				const Contour&						BORDER,
-													const ContourArray&					HOLES,
-													const Orientation					TARGET_ORIENTATION,
+	namespace Triangulation2
+	{
+		using	Triangulation::NULL_INDEX;
+
+		Orientation			calculate_winding(		const uint32_t*						CONTOUR,
+													const uint64_t						CONTOUR_SIZE,
 													const Vec2*							VERTEX_BUFFER)
 		{
-			Result	result;
-					result.triangles.reserve(estimate_numTriangles(BORDER, HOLES));
-					
-			contour_to_TNodes(BORDER, Orientation::CW, VERTEX_BUFFER, result.nodes);
-			for (auto& iHole : HOLES)
-			{
-				contour_to_TNodes(iHole, Orientation::CCW, VERTEX_BUFFER, result.nodes);
-			}
-
-			auto monotones = TNodes_to_monotones(result.nodes, VERTEX_BUFFER);
-			for(auto& iMonotone : monotones)
-			{
-				perform_triangulation(iMonotone, TARGET_ORIENTATION, VERTEX_BUFFER, result.triangles);
-			}
-
-			return result;
-		}
-	}
-
-	namespace Triangulation2
-	{
-		Orientation			calculate_winding(		const uint32_t*						CONTOUR,
-													const uint64_t						CONTOUR_SIZE,
-													const Vec2*							VERTEX_BUFFER)
-		{
-			float signedArea = 0.f;
+			float signedArea = 0.f;
 
 			for(uint64_t i = CONTOUR_SIZE -1, j = 0; j < CONTOUR_SIZE; i = j++)
 			{
@@ -712,7 +476,7 @@ namespace cml
 		void				contour_to_edges(		const Contour&						CONTOUR,
 													const Orientation					TARGET_ORIENTATION,
 													const Vec2*							VERTEX_BUFFER,
-													SortedEdges&						edges)
+													std::vector<OrientedEdge>&			edges)
 		{
 			validate_contour(CONTOUR);
 
@@ -720,151 +484,135 @@ namespace cml
 			const Orientation	ORIENTATION		= calculate_winding(CONTOUR.data(), NUM_VERTICES, VERTEX_BUFFER);
 
 			for (uint32_t i = NUM_VERTICES - 1, j = 0; j < NUM_VERTICES; i = j++)
-			{			
+			{
 				uint32_t	beginID	= CONTOUR.at(i);
 				uint32_t	endID	= CONTOUR.at(j);
 
 				if(ORIENTATION != TARGET_ORIENTATION) std::swap(beginID, endID);
 
-				auto result = edges.emplace(OrientedEdge(beginID, endID, TARGET_ORIENTATION, VERTEX_BUFFER), nullptr);
-				if(result.second == false)
-					throw dpl::GeneralException(__FILE__, __LINE__, "No two, arbitrary vertices of the polygon and its holes can share the same X and Y coordinate.");
+				edges.emplace_back(beginID, endID, TARGET_ORIENTATION, VERTEX_BUFFER);
 			}
 		}
 
-		Triangle			create_triangle(		std::list<OrientedEdge>::iterator	current, 
+		/*
+			Sweeps vertices from left to right. Edges that span X coordinate of the vertex are kept in the sorted list of active edges,
+			which replaces the quadratic map of intersections. Output is the same as with ordered containers, because candidates
+			are still visited in the order of edges.
+		*/
+		void				execute(				const Contour&						BORDER,
+													const ContourArray&					HOLES,
 													const Orientation					TARGET_ORIENTATION,
-													const Vec2*							VERTEX_BUFFER)
+													const Vec2*							VERTEX_BUFFER,
+													Scratch&							scratch,
+													Triangles&							output)
 		{
-			Triangle triangle{current->beginID(), current->endID(), (++current)->endID()};
+			output.reserve(output.size() + estimate_numTriangles(BORDER, HOLES));
 
-			if(calculate_winding(triangle.data(), 3, VERTEX_BUFFER) != TARGET_ORIENTATION)
+			auto& edges		= scratch.edges;
+			auto& sorted	= scratch.sorted;
+			auto& entering	= scratch.entering;
+			auto& active	= scratch.active;
+			auto& monotones	= scratch.monotones;
+			auto& links		= scratch.links;
+
+			edges.clear();
+			contour_to_edges(BORDER, Orientation::CW, VERTEX_BUFFER, edges);
+			for (auto& iHole : HOLES)
 			{
-				std::swap(triangle[1], triangle[2]);
+				contour_to_edges(iHole, Orientation::CCW, VERTEX_BUFFER, edges);
 			}
 
-			return triangle;
-		}
-
-		void				perform_triangulation(	const Contour&						MONOTONE,
-													const Orientation					TARGET_ORIENTATION,
-													const Vec2*							VERTEX_BUFFER,
-													Triangles&							output)
-		{
-			validate_contour(MONOTONE);
-
-			const uint32_t		NUM_VERTICES	= static_cast<uint32_t>(MONOTONE.size());
-			const Orientation	ORIENTATION		= calculate_winding(MONOTONE.data(), NUM_VERTICES, VERTEX_BUFFER);
+			sort_unique(edges, sorted);
 
-			std::list<OrientedEdge> openList; // list of edges to process
+			const uint32_t NUM_EDGES = static_cast<uint32_t>(sorted.size());
 
-			for(uint32_t index = 0; index < NUM_VERTICES; ++index)
+			auto get_edge = [&](const uint32_t RANK) -> const OrientedEdge&
 			{
-				openList.emplace_back(MONOTONE[index], MONOTONE[(index+1)%NUM_VERTICES], ORIENTATION, VERTEX_BUFFER);
-			}
+				return edges[sorted[RANK]];
+			};
 
-			auto current = openList.begin();
-			
-			while(openList.size() > 3)
+			auto get_left = [&](const uint32_t RANK)
 			{
-				auto next = std::next(current);
+				return glm::min(get_edge(RANK).begin().x, get_edge(RANK).end().x);
+			};
 
-				while(1)
-				{
-					const bool bRIGHT = right_side(	current->begin(), 
-													current->end(), 
-													next->end());
+			auto get_right = [&](const uint32_t RANK)
+			{
+				return glm::max(get_edge(RANK).begin().x, get_edge(RANK).end().x);
+			};
 
-					if(ORIENTATION == Orientation::CW ? !bRIGHT : bRIGHT)
-						current = next++; // based on how monotone polygon was created we will never go out of bounds
-					else
-						break;
-				}
+			entering.resize(NUM_EDGES);
+			for(uint32_t rank = 0; rank < NUM_EDGES; ++rank)
+			{
+				entering[rank] = rank;
+			}
 
-				output.emplace_back(create_triangle(current, TARGET_ORIENTATION, VERTEX_BUFFER));
+			std::sort(entering.begin(), entering.end(), [&](const uint32_t A, const uint32_t B)
+			{
+				return get_left(A) < get_left(B);
+			});
 
-				/*
-					-> [newCurrent] -> [oldCurrent] -> [oldNext] ->
-							(insert)       (erase[1])     (erase[2])
-				*/
-				current = openList.insert(current, OrientedEdge(current->beginID(), next->endID(), ORIENTATION, VERTEX_BUFFER));
-				openList.erase(openList.erase(std::next(current)));
+			active.clear();
+			links.clear();
+			monotones.assign(NUM_EDGES, {NULL_INDEX, NULL_INDEX, 0});
 
-				// now is an interesting part, if we skip this step, we may generate invalid polygon,
-				// we must try to decrement current iterator in order to combine some previous edge with newly generated one
-				// otherwise we will reach the point in which we have to loop whole triangulation process ...
-				if(current != openList.begin())
-					--current;
-			}
+			auto add_vertex = [&](Monotone& monotone, const uint32_t VERTEX_ID)
+			{
+				const uint32_t LINK_ID = static_cast<uint32_t>(links.size());
+				links.push_back({VERTEX_ID, NULL_INDEX});
 
-			// Generate last triangle from remaining 3 edges.
-			output.emplace_back(create_triangle(openList.begin(), TARGET_ORIENTATION, VERTEX_BUFFER));
-		}
+				if(monotone.head == NULL_INDEX)
+					monotone.head = LINK_ID;
+				else
+					links[monotone.tail].next = LINK_ID;
 
-		Triangles			execute(				const Contour&						BORDER,
-													const ContourArray&					HOLES,
-													const Orientation					TARGET_ORIENTATION,
-													const Vec2*							VERTEX_BUFFER)
-		{
-			Triangles	triangles;
-						triangles.reserve(estimate_numTriangles(BORDER, HOLES));
+				monotone.tail = LINK_ID;
+				++monotone.size;
+			};
 
-			SortedEdges	edges;
-					
-			contour_to_edges(BORDER, Orientation::CW, VERTEX_BUFFER, edges);
-			for (auto& iHole : HOLES)
+			auto add_to_monotone = [&](const uint32_t RANK, const uint32_t VERTEX_ID)
 			{
-				contour_to_edges(iHole, Orientation::CCW, VERTEX_BUFFER, edges);
-			}
+				auto& monotone = monotones[RANK];
+				if(monotone.head == NULL_INDEX)
+					add_vertex(monotone, get_edge(RANK).get_monotone_beginID());
 
-			Intersections	intersections;
-							intersections.reserve(edges.size());
+				add_vertex(monotone, VERTEX_ID);
+			};
 
-			// Find all unique X coordinates.
-			for(auto& iEdge : edges) intersections[iEdge.first.begin().x];
+			uint32_t numEntered = 0;
 
-			// Find all intersections(O(n^2), very slow).
-			for(auto iEdge = edges.begin(); iEdge != edges.end(); ++iEdge)
+			for(uint32_t rank = 0; rank < NUM_EDGES; ++rank)
 			{
-				const Vec2& BEGIN	= iEdge->first.begin();
-				const Vec2& END		= iEdge->first.end();
+				const uint32_t	VERTEX_ID	= get_edge(rank).beginID();
+				const Vec2&		VERTEX		= get_edge(rank).begin();
 
-				const float MIN = glm::min(BEGIN.x, END.x);
-				const float MAX = glm::max(BEGIN.x, END.x);
+				// Vertices are visited from left to right, so edges that end before the vertex never become active again.
+				active.erase(std::remove_if(active.begin(), active.end(), [&](const uint32_t RANK){ return get_right(RANK) < VERTEX.x; }), active.end());
 
-				for(auto& iIntersection : intersections)
+				for(; numEntered < NUM_EDGES && get_left(entering[numEntered]) <= VERTEX.x; ++numEntered)
 				{
-					if(MIN <= iIntersection.first 
-					&& MAX >= iIntersection.first)
-					{
-						iIntersection.second.push_back(iEdge);
-					}
+					const uint32_t RANK = entering[numEntered];
+					active.insert(std::lower_bound(active.begin(), active.end(), RANK), RANK);
 				}
-			}
-
-			for(auto it = edges.begin(); it != edges.end(); ++it)
-			{
-				const uint32_t	VERTEX_ID	= it->first.beginID();
-				const Vec2&		VERTEX		= it->first.begin();
 
 				// Distance to closest edge above the node.
-				SortedEdges::iterator	edgeAbove		= edges.end();
-				float					distanceAbove	= std::numeric_limits<float>::max();
-				float					dotAbove		= -1.f;
+				uint32_t	edgeAbove		= NULL_INDEX;
+				float		distanceAbove	= std::numeric_limits<float>::max();
 
 				// Distance to closest edge below the node.
-				SortedEdges::iterator	edgeBelow		= edges.end();
-				float					distanceBelow	= std::numeric_limits<float>::max();
-				float					dotBelow		= -1.f;
+				uint32_t	edgeBelow		= NULL_INDEX;
+				float		distanceBelow	= std::numeric_limits<float>::max();
+				float		dotBelow		= -1.f;
 
 				// Find closest edges.
-				const auto& POTENTIAL_MONOTONES = intersections[VERTEX.x];
-				for(auto& iBASE : POTENTIAL_MONOTONES)
+				for(const uint32_t BASE : active)
 				{
-					if(iBASE->first.point_between(VERTEX))
+					const OrientedEdge& BASE_EDGE = get_edge(BASE);
+
+					if(BASE_EDGE.point_between(VERTEX))
 					{
-						const Vec2& EDGE_START	= iBASE->first.begin();
-						const Vec2& EDGE_END	= iBASE->first.end();
+						const Vec2& EDGE_START	= BASE_EDGE.begin();
+						const Vec2& EDGE_END	= BASE_EDGE.end();
 
 						if(auto SIGNED_DISTANCE = signed_Y_distance(EDGE_START, EDGE_END, VERTEX))
 						{
@@ -872,25 +620,10 @@ namespace cml
 
 							if(SIGNED_DISTANCE < 0.f && DISTANCE < distanceAbove)
 							{
-								const float DOT = glm::dot(Vec2(0.f, -1.f), EDGE_START-EDGE_END);
-
-								if(DISTANCE < distanceAbove)
-								{
-									distanceAbove	= DISTANCE;
-									dotAbove		= DOT;
-									edgeAbove		= iBASE;
-								}
-								else if(DISTANCE == distanceAbove)
-								{
-									if(DOT > dotAbove)
-									{
-										distanceAbove	= DISTANCE;
-										dotAbove		= DOT;
-										edgeAbove		= iBASE;
-									}
-								}
+								distanceAbove	= DISTANCE;
+								edgeAbove		= BASE;
 							}
-							else if(SIGNED_DISTANCE >= 0.f) 
+							else if(SIGNED_DISTANCE >= 0.f)
 							{
 								const float DOT = glm::dot(Vec2(0.f, 1.f), EDGE_START-EDGE_END);
 
@@ -898,7 +631,7 @@ namespace cml
 								{
 									distanceBelow	= DISTANCE;
 									dotBelow		= DOT;
-									edgeBelow		= iBASE;
+									edgeBelow		= BASE;
 								}
 								if(DISTANCE == distanceBelow)
 								{
@@ -906,7 +639,7 @@ namespace cml
 									{
 										distanceBelow	= DISTANCE;
 										dotBelow		= DOT;
-										edgeBelow		= iBASE;
+										edgeBelow		= BASE;
 									}
 								}
 							}
@@ -914,61 +647,49 @@ namespace cml
 					}
 				}
 
-				if(edgeBelow != edges.end())
+				if(edgeBelow != NULL_INDEX)
 				{
-					const Vec2& EDGE_START	= edgeBelow->first.begin();
-					const Vec2& EDGE_END	= edgeBelow->first.end();
-
-					if(right_side(EDGE_START, EDGE_END, VERTEX))
-					{
-						auto& monotone = edgeBelow->second;
-						if(!monotone)
-						{
-							monotone = std::make_unique<Contour>();
-							monotone->push_back(edgeBelow->first.get_monotone_beginID());
-						}
-
-						monotone->push_back(VERTEX_ID);
-					}
+					if(right_side(get_edge(edgeBelow).begin(), get_edge(edgeBelow).end(), VERTEX))
+						add_to_monotone(edgeBelow, VERTEX_ID);
+				}
+				if(edgeAbove != NULL_INDEX && (edgeAbove != edgeBelow || edgeBelow == NULL_INDEX))
+				{
+					if(right_side(get_edge(edgeAbove).begin(), get_edge(edgeAbove).end(), VERTEX))
+						add_to_monotone(edgeAbove, VERTEX_ID);
 				}
-				if((edgeAbove != edges.end()) && (edgeAbove != edgeBelow || edgeBelow == edges.end()))
-				{	
-					const Vec2& EDGE_START	= edgeAbove->first.begin();
-					const Vec2& EDGE_END	= edgeAbove->first.end();
-
-					if(right_side(EDGE_START, EDGE_END, VERTEX))
-					{
-						auto& monotone = edgeAbove->second;
-						if(!monotone)
-						{
-							monotone = std::make_unique<Contour>();
-							monotone->push_back(edgeAbove->first.get_monotone_beginID());
-						}
-
-						monotone->push_back(VERTEX_ID);
-					}
-				}			
 			}
 
-			// Erase contours with less than 3 vertices.
-			for(auto& it : edges)
+			// Skip contours with less than 3 vertices.
+			for(uint32_t rank = 0; rank < NUM_EDGES; ++rank)
 			{
-				if(it.second)
-				{
-					if(it.second->size() < 2)
-					{
-						it.second.reset();
-					}
-					else // Close monotone and go to the next.
-					{
-						const auto& EDGE = it.first;
-						it.second->push_back(EDGE.get_monotone_endID());
+				const auto& MONOTONE = monotones[rank];
+				if(MONOTONE.head == NULL_INDEX || MONOTONE.size < 2)
+					continue;
 
-						perform_triangulation(*it.second, TARGET_ORIENTATION, VERTEX_BUFFER, triangles);
-					}
+				// Close monotone and go to the next.
+				auto& contour = scratch.contour;
+				contour.clear();
+
+				for(uint32_t linkID = MONOTONE.head; linkID != NULL_INDEX; linkID = links[linkID].next)
+				{
+					contour.push_back(links[linkID].vertexID);
 				}
+
+				contour.push_back(get_edge(rank).get_monotone_endID());
+
+				Triangulation::perform_triangulation(contour, TARGET_ORIENTATION, VERTEX_BUFFER, scratch.triangulation.chain, output);
 			}
+		}
+
+		Triangles			execute(				const Contour&						BORDER,
+													const ContourArray&					HOLES,
+													const Orientation					TARGET_ORIENTATION,
+													const Vec2*							VERTEX_BUFFER)
+		{
+			Scratch		scratch;
+			Triangles	triangles;
 
+			execute(BORDER, HOLES, TARGET_ORIENTATION, VERTEX_BUFFER, scratch, triangles);
 			return triangles;
 		}
 	}
@@ -1014,151 +735,1216 @@ namespace cml
 		return contour;
 	}
 
-//=====> TriangleMesh -> public functions
-	void		TriangleMesh::triangulate(		const CoordinateSystem& RPS,
-												const uint32_t			X_2D_INDEX,
-												const uint32_t			Y_2D_INDEX,
-												const Vertices2D&		BORDER_POLYGON,
-												const Vertices2DArray&	HOLE_POLYGONS,
-												const Orientation		TARGET_ORIENTATION)
+	struct	TriangleMesh::TriangulationScratch::Buffers
 	{
-		std::vector<p2t::Point>	vertices2D;
-		
-		fill(vertices2D, BORDER_POLYGON, Orientation::CW);
+		std::vector<p2t::Point>		points;
+		p2t::Arena					arena;
+
+		std::vector<Vec2>			vertices2D;
+		Contour						border;
+		ContourArray				holes;
+		Triangulation2::Scratch		monotone;
+		Triangulation2::Triangles	triangles;
+	};
 
-		for(auto& iHole : HOLE_POLYGONS)
+	/*
+		Returns true when every corner of the polygon turns in the direction of its WINDING(1 = counter-clockwise, -1 = clockwise)
+		and its edges go around only once.
+	*/
+	bool						is_convex_polygon(const Vec2*								POINTS,
+												const uint32_t								NUM_POINTS,
+												const float									WINDING)
+	{
+		uint32_t	numFlipsX	= 0;
+		uint32_t	numFlipsY	= 0;
+		Vec2		lastSign	= Vec2(0.f, 0.f);
+
+		for(uint32_t index = 0; index < NUM_POINTS; ++index)
 		{
-			fill(vertices2D, *iHole, Orientation::CW);
+			const Vec2 EDGE = POINTS[(index + 1) % NUM_POINTS] - POINTS[index];
+			const Vec2 NEXT = POINTS[(index + 2) % NUM_POINTS] - POINTS[(index + 1) % NUM_POINTS];
+
+			if(WINDING * calculate_det(EDGE, NEXT) <= 0.f)
+				return false;
+
+			// Edges of the polygon that winds more than once change direction more than twice along each axis.
+			const Vec2 SIGN = glm::sign(EDGE);
+
+			if(SIGN.x != 0.f)
+			{
+				numFlipsX += (SIGN.x != lastSign.x && lastSign.x != 0.f);
+				lastSign.x = SIGN.x;
+			}
+
+			if(SIGN.y != 0.f)
+			{
+				numFlipsY += (SIGN.y != lastSign.y && lastSign.y != 0.f);
+				lastSign.y = SIGN.y;
+			}
 		}
 
-		p2t::CDT cdt(to_contour(vertices2D, 0, BORDER_POLYGON.size()));
+		return numFlipsX <= 2 && numFlipsY <= 2;
+	}
+
+	/*
+		Cuts convex corners of the polygon that do not contain any other vertex.
+		Only reflex vertices can lie inside the ear of a simple polygon, so the others are not tested. Ear status is evaluated once
+		when the search reaches the vertex. Clipping invalidates it for the two neighbours of the ear, and when one of them stops being reflex
+		all saved negative results are dropped as well, since it could have been their only blocker.
+		O(n^2) plus O(n) ear tests for each reflex vertex that becomes convex.
+		Triangles have the same winding as the polygon. Returns false when no ear was found(e.g. polygon intersects itself).
+	*/
+	bool						clip_ears(		const Vec2*									POINTS,
+												const uint32_t								NUM_POINTS,
+												const float									WINDING,
+												uint32_t									(*triangles)[3])
+	{
+		uint32_t	previous[TriangleMesh::MAX_SMALL_POLYGON_VERTICES]	= {};
+		uint32_t	next[TriangleMesh::MAX_SMALL_POLYGON_VERTICES]		= {};
+		bool		bReflex[TriangleMesh::MAX_SMALL_POLYGON_VERTICES]	= {};
+		bool		bEar[TriangleMesh::MAX_SMALL_POLYGON_VERTICES]		= {};
+		bool		bChecked[TriangleMesh::MAX_SMALL_POLYGON_VERTICES]	= {};
 
-		uint64_t offset = BORDER_POLYGON.size();
-		for(auto& iHole : HOLE_POLYGONS)
+		for(uint32_t index = 0; index < NUM_POINTS; ++index)
 		{
-			cdt.AddHole(to_contour(vertices2D, offset, offset + iHole->size()));
-			offset += iHole->size();
+			previous[index]	= (index + NUM_POINTS - 1) % NUM_POINTS;
+			next[index]		= (index + 1) % NUM_POINTS;
 		}
 
-		cdt.Triangulate();
-		
-		// Transform 2D vertices into 3D RPS space.
-		vertices = Vertices(vertices2D.size());
-		for(uint64_t vertexID = 0; vertexID < vertices2D.size(); ++vertexID)
+		// Collinear corners are treated as reflex, so that they block ears that touch them.
+		auto is_reflex = [&](const uint32_t B)
 		{
-			const auto& p2tPoint = vertices2D[vertexID];
-			const Vec2 VERTEX_2D(p2tPoint.x, p2tPoint.y);
-			(*vertices)[vertexID] = RPS.unproject_point(VERTEX_2D, X_2D_INDEX, Y_2D_INDEX);;
-		}
+			const uint32_t A = previous[B];
+			const uint32_t C = next[B];
 
-		const auto TRIANGLES = cdt.GetTriangles();
+			return WINDING * calculate_det(POINTS[B] - POINTS[A], POINTS[C] - POINTS[B]) <= 0.f;
+		};
+
+		auto is_ear = [&](const uint32_t B)
+		{
+			if(bReflex[B])
+				return false;
+
+			const uint32_t A = previous[B];
+			const uint32_t C = next[B];
+
+			// Points on the boundary of the triangle also block the ear.
+			for(uint32_t pointID = next[C]; pointID != A; pointID = next[pointID])
+			{
+				if(!bReflex[pointID])
+					continue;
+
+				const Vec2& POINT = POINTS[pointID];
+
+				if(WINDING * calculate_det(POINTS[B] - POINTS[A], POINT - POINTS[A]) >= 0.f
+				&& WINDING * calculate_det(POINTS[C] - POINTS[B], POINT - POINTS[B]) >= 0.f
+				&& WINDING * calculate_det(POINTS[A] - POINTS[C], POINT - POINTS[C]) >= 0.f)
+					return false;
+			}
+
+			return true;
+		};
 
-		indices->clear();
-		indices->reserve(TRIANGLES.size() * 3);
+		for(uint32_t index = 0; index < NUM_POINTS; ++index)
+		{
+			bReflex[index] = is_reflex(index);
+		}
 
-		const auto* ARRAY_START = reinterpret_cast<const p2t::Point*>(vertices2D.data());
+		uint32_t numRemaining	= NUM_POINTS;
+		uint32_t numTriangles	= 0;
+		uint32_t numSkipped		= 0;
+		uint32_t current		= 0;
 
-		for(uint64_t triangleID = 0; triangleID < TRIANGLES.size(); ++triangleID)
+		while(numRemaining > 3)
 		{
-			const auto&	TRIANGLE = TRIANGLES[triangleID];
+			if(!bChecked[current])
+			{
+				bEar[current]		= is_ear(current);
+				bChecked[current]	= true;
+			}
 
-			if(TRIANGLE->IsInterior())
+			if(!bEar[current])
 			{
-				const uint64_t OFFSET = triangleID * 3;
+				if(++numSkipped == numRemaining)
+					return false;
 
-				indices->push_back(static_cast<uint32_t>(TRIANGLE->GetPoint(0) - ARRAY_START));
-				indices->push_back(static_cast<uint32_t>(TRIANGLE->GetPoint(1) - ARRAY_START));
-				indices->push_back(static_cast<uint32_t>(TRIANGLE->GetPoint(2) - ARRAY_START));
+				current = next[current];
+				continue;
 			}
-			else
+
+			const uint32_t A = previous[current];
+			const uint32_t C = next[current];
+
+			triangles[numTriangles][0] = A;
+			triangles[numTriangles][1] = current;
+			triangles[numTriangles][2] = C;
+			++numTriangles;
+
+			next[A]		= C;
+			previous[C]	= A;
+			--numRemaining;
+			numSkipped	= 0;
+
+			const bool bA_WAS_REFLEX = bReflex[A];
+			const bool bC_WAS_REFLEX = bReflex[C];
+
+			bReflex[A]	= is_reflex(A);
+			bReflex[C]	= is_reflex(C);
+			bChecked[A]	= false;
+			bChecked[C]	= false;
+
+			if((bA_WAS_REFLEX && !bReflex[A]) || (bC_WAS_REFLEX && !bReflex[C]))
 			{
-				int breakpoint = 0;
+				for(uint32_t pointID = next[C]; pointID != A; pointID = next[pointID])
+				{
+					if(!bEar[pointID])
+						bChecked[pointID] = false;
+				}
 			}
+
+			current = C;
 		}
-	}
 
-	void		TriangleMesh::validate_index_count() const
-	{
-		if(get_numIndices() % 3 != 0)
-			throw dpl::GeneralException(this, __LINE__, "Number of indices must be divisible by 3.");
+		triangles[numTriangles][0] = previous[current];
+		triangles[numTriangles][1] = current;
+		triangles[numTriangles][2] = next[current];
+		return true;
 	}
 
-	void		TriangleMesh::validate_indices() const
+	/*
+		Triangulates polygon without holes with a fan when it is convex or with ear clipping and appends the result to the output.
+		Vertices and triangles have the same order and winding as the ones produced by the constrained Delaunay triangulation.
+		Returns false without changing the output when polygon is too large for the settings or ear clipping fails.
+		INDEX_OFFSET is added to all indices.
+	*/
+	bool						triangulate_small_polygon(const CoordinateSystem&			RPS,
+												const uint32_t								X_2D_INDEX,
+												const uint32_t								Y_2D_INDEX,
+												const TriangleMesh::Vertices2D&				POLYGON,
+												const TriangleMesh::TriangulationSettings&	SETTINGS,
+												const uint32_t								INDEX_OFFSET,
+												TriangleMesh::Vertices&						outputVertices,
+												TriangleMesh::Indices&						outputIndices)
 	{
-		validate_index_count();
+		const uint32_t NUM_POINTS		= static_cast<uint32_t>(POLYGON.size());
+		const uint32_t MAX_FAN			= glm::min(SETTINGS.maxFanVertices,			TriangleMesh::MAX_SMALL_POLYGON_VERTICES);
+		const uint32_t MAX_EAR_CLIPPING	= glm::min(SETTINGS.maxEarClippingVertices,	TriangleMesh::MAX_SMALL_POLYGON_VERTICES);
 
-		const uint32_t NUM_VERTICES = get_numVertices();
-		for(auto& index : indices())
+		if(NUM_POINTS < 3 || NUM_POINTS > glm::max(MAX_FAN, MAX_EAR_CLIPPING))
+			return false;
+
+		Vec2		points[TriangleMesh::MAX_SMALL_POLYGON_VERTICES]; // Same order as in fill.
+		uint32_t	triangles[TriangleMesh::MAX_SMALL_POLYGON_VERTICES - 2][3];
+		float		doubleArea = 0.f;
+
+		const bool REVERSE = calculate_polygon_orientation(POLYGON.data(), NUM_POINTS) != Orientation::CW;
+
+		for(uint32_t index = 0; index < NUM_POINTS; ++index)
 		{
-			if(index >= NUM_VERTICES)
-				throw dpl::GeneralException(this, __LINE__, "TriangleMesh contains at least one invalid index.");
+			points[index] = POLYGON[REVERSE ? NUM_POINTS - 1 - index : index];
 		}
-	}
 
-	void		TriangleMesh::extend(			const TriangleMesh&		OTHER,
-												const Mat4&				OTHER_TRANSFORMATION)
-	{
-		vertices->reserve(get_numVertices() + OTHER.get_numVertices());
-		indices->reserve(get_numIndices() + OTHER.get_numIndices());
+		for(uint32_t index = 0; index < NUM_POINTS; ++index)
+		{
+			doubleArea += calculate_det(points[index], points[(index + 1) % NUM_POINTS]);
+		}
+
+		if(doubleArea == 0.f)
+			return false;
+
+		const float WINDING = doubleArea > 0.f ? 1.f : -1.f;
 
-		const uint32_t VERTEX_OFFSET = get_numVertices();
+		if(NUM_POINTS <= MAX_FAN && is_convex_polygon(points, NUM_POINTS, WINDING))
+		{
+			for(uint32_t index = 1; index < NUM_POINTS - 1; ++index)
+			{
+				triangles[index - 1][0] = 0;
+				triangles[index - 1][1] = index;
+				triangles[index - 1][2] = index + 1;
+			}
+		}
+		else if(NUM_POINTS > MAX_EAR_CLIPPING || !clip_ears(points, NUM_POINTS, WINDING, triangles))
+		{
+			return false;
+		}
 
-		for(auto& OTHER_VERTEX : OTHER.vertices())
+		for(uint32_t index = 0; index < NUM_POINTS; ++index)
 		{
-			vertices->push_back(OTHER_TRANSFORMATION * Vec4(OTHER_VERTEX, 1.f));
+			outputVertices.push_back(RPS.unproject_point(points[index], X_2D_INDEX, Y_2D_INDEX));
 		}
 
-		for(auto& OTHER_INDEX : OTHER.indices())
+		// Output triangles are counter-clockwise, same as the ones of poly2tri.
+		for(uint32_t triangleID = 0; triangleID < NUM_POINTS - 2; ++triangleID)
 		{
-			indices->push_back(OTHER_INDEX + VERTEX_OFFSET);
+			const uint32_t* TRIANGLE = triangles[triangleID];
+
+			outputIndices.push_back(INDEX_OFFSET + TRIANGLE[0]);
+			outputIndices.push_back(INDEX_OFFSET + (WINDING > 0.f ? TRIANGLE[1] : TRIANGLE[2]));
+			outputIndices.push_back(INDEX_OFFSET + (WINDING > 0.f ? TRIANGLE[2] : TRIANGLE[1]));
 		}
+
+		return true;
 	}
 
-	void		TriangleMesh::flip()
+	/*
+		Triangulates polygon with holes with poly2tri and appends the result to the output, INDEX_OFFSET is added to the indices relative to the first added vertex.
+		Arena is reset before the triangulation.
+	*/
+	void						triangulate_with_CDT(const CoordinateSystem&				RPS,
+												const uint32_t								X_2D_INDEX,
+												const uint32_t								Y_2D_INDEX,
+												const TriangleMesh::Vertices2D&				BORDER_POLYGON,
+												const TriangleMesh::Vertices2DArray&		HOLE_POLYGONS,
+												const uint32_t								INDEX_OFFSET,
+												TriangleMesh::TriangulationScratch::Buffers& scratch,
+												TriangleMesh::Vertices&						outputVertices,
+												TriangleMesh::Indices&						outputIndices)
 	{
-		validate_index_count();
+		auto& points = scratch.points;
 
-		const uint32_t NUM_TRIANGLES = get_numIndices() / 3;
+		points.clear();
+		scratch.arena.Reset();
+		
+		fill(points, BORDER_POLYGON, Orientation::CW);
 
-		// Swap second and third vertex index of each triangle.
-		for(uint32_t triangleID = 0; triangleID < NUM_TRIANGLES; ++triangleID)
+		for(auto& iHole : HOLE_POLYGONS)
 		{
-			const uint32_t OFFSET = triangleID * 3;
-			std::swap((*indices)[OFFSET+1], (*indices)[OFFSET+2]);
+			fill(points, *iHole, Orientation::CW);
 		}
-	}
 
-	void		TriangleMesh::generate_normals(	Vec3*					output) const
-	{
-		validate_indices();
+		p2t::CDT cdt(to_contour(points, 0, BORDER_POLYGON.size()), &scratch.arena);
 
-		const uint32_t NUM_VERTICES		= get_numVertices();
-		const uint32_t NUM_TRIANGLES	= get_numIndices() / 3;
+		uint64_t offset = BORDER_POLYGON.size();
+		for(auto& iHole : HOLE_POLYGONS)
+		{
+			cdt.AddHole(to_contour(points, offset, offset + iHole->size()));
+			offset += iHole->size();
+		}
 
-		for(uint32_t triangleID = 0; triangleID < NUM_TRIANGLES; ++triangleID)
+		cdt.Triangulate();
+		
+		// Transform 2D vertices into 3D RPS space. Buffers are not reserved, so that appending many polygons grows them geometrically.
+		for(auto& iPoint : points)
 		{
-			const uint32_t OFFSET = triangleID * 3;
-			const uint32_t AID = indices()[OFFSET+0];
-			const uint32_t BID = indices()[OFFSET+1];
-			const uint32_t CID = indices()[OFFSET+2];
+			outputVertices.push_back(RPS.unproject_point(Vec2(iPoint.x, iPoint.y), X_2D_INDEX, Y_2D_INDEX));
+		}
 
-			auto& A = vertices()[AID];
-			auto& B = vertices()[BID];
-			auto& C = vertices()[CID];
+		const auto& TRIANGLES = cdt.GetTriangles();
 
-			const Vec3 AB	= glm::normalize(B-A);
-			const Vec3 AC	= glm::normalize(C-A);
-			const Vec3 N	= glm::normalize(glm::cross(AB, AC));
+		const auto* ARRAY_START = points.data();
 
-			output[AID] += N;
-			output[BID] += N;
-			output[CID] += N;
+		for(auto& iTriangle : TRIANGLES)
+		{
+			if(!iTriangle->IsInterior())
+				continue;
+
+			outputIndices.push_back(INDEX_OFFSET + static_cast<uint32_t>(iTriangle->GetPoint(0) - ARRAY_START));
+			outputIndices.push_back(INDEX_OFFSET + static_cast<uint32_t>(iTriangle->GetPoint(1) - ARRAY_START));
+			outputIndices.push_back(INDEX_OFFSET + static_cast<uint32_t>(iTriangle->GetPoint(2) - ARRAY_START));
 		}
+	}
 
-		for(uint32_t vertexID = 0; vertexID < NUM_VERTICES; ++vertexID)
+	/*
+		Area of the contour, doubled.
+	*/
+	double						calculate_doubled_area(const uint32_t*					CONTOUR,
+												const uint64_t								CONTOUR_SIZE,
+												const Vec2*									VERTEX_BUFFER)
+	{
+		double signedArea = 0.0;
+
+		for(uint64_t i = CONTOUR_SIZE - 1, j = 0; j < CONTOUR_SIZE; i = j++)
 		{
-			auto&	normal = output[vertexID];
-					normal = glm::normalize(normal);
+			const Vec2& FIRST	= VERTEX_BUFFER[CONTOUR[i]];
+			const Vec2& SECOND	= VERTEX_BUFFER[CONTOUR[j]];
+
+			signedArea += static_cast<double>(FIRST.x) * SECOND.y - static_cast<double>(SECOND.x) * FIRST.y;
+		}
+
+		return std::abs(signedArea);
+	}
+
+	/*
+		Monotone sweep does not split every polygon correctly(e.g. when vertices share X coordinate), so its triangles are accepted
+		only when their number is N-2 + 2*H(N vertices of the polygon and its holes, H holes) and they cover exactly the area of the polygon without holes.
+	*/
+	void						validate_monotone_triangulation(const Contour&				BORDER,
+												const ContourArray&							HOLES,
+												const Vec2*									VERTEX_BUFFER,
+												const Triangulation2::Triangles&			TRIANGLES)
+	{
+		uint64_t numTriangles = BORDER.size() - 2;
+
+		for(auto& iHole : HOLES)
+		{
+			numTriangles += iHole.size() + 2;
 		}
+
+		if(TRIANGLES.size() != numTriangles)
+			throw dpl::GeneralException(__FILE__, __LINE__, "Monotone triangulation failed. Invalid number of triangles: " + std::to_string(TRIANGLES.size()));
+
+		double polygonArea = calculate_doubled_area(BORDER.data(), BORDER.size(), VERTEX_BUFFER);
+
+		for(auto& iHole : HOLES)
+		{
+			polygonArea -= calculate_doubled_area(iHole.data(), iHole.size(), VERTEX_BUFFER);
+		}
+
+		double trianglesArea = 0.0;
+
+		for(auto& iTriangle : TRIANGLES)
+		{
+			trianglesArea += calculate_doubled_area(iTriangle.data(), iTriangle.size(), VERTEX_BUFFER);
+		}
+
+		if(std::abs(trianglesArea - polygonArea) > polygonArea * 1e-5)
+			throw dpl::GeneralException(__FILE__, __LINE__, "Monotone triangulation failed. Triangles do not cover the polygon.");
+	}
+
+	/*
+		Triangulates polygon with holes with the monotone sweep and appends the result to the output, INDEX_OFFSET is added to the indices relative to the first added vertex.
+		Vertices keep the order of the polygons.
+	*/
+	void						triangulate_with_monotones(const CoordinateSystem&			RPS,
+												const uint32_t								X_2D_INDEX,
+												const uint32_t								Y_2D_INDEX,
+												const TriangleMesh::Vertices2D&				BORDER_POLYGON,
+												const TriangleMesh::Vertices2DArray&		HOLE_POLYGONS,
+												const uint32_t								INDEX_OFFSET,
+												TriangleMesh::TriangulationScratch::Buffers& scratch,
+												TriangleMesh::Vertices&						outputVertices,
+												TriangleMesh::Indices&						outputIndices)
+	{
+		auto& vertices2D	= scratch.vertices2D;
+		auto& holes			= scratch.holes;
+
+		vertices2D.assign(BORDER_POLYGON.begin(), BORDER_POLYGON.end());
+		holes.resize(HOLE_POLYGONS.size());
+
+		for(uint64_t holeID = 0; holeID < HOLE_POLYGONS.size(); ++holeID)
+		{
+			const auto& HOLE = *HOLE_POLYGONS[holeID];
+
+			holes[holeID].clear();
+
+			for(auto& iVertex : HOLE)
+			{
+				holes[holeID].push_back(static_cast<uint32_t>(vertices2D.size()));
+				vertices2D.push_back(iVertex);
+			}
+		}
+
+		scratch.border.clear();
+		for(uint32_t vertexID = 0; vertexID < BORDER_POLYGON.size(); ++vertexID)
+		{
+			scratch.border.push_back(vertexID);
+		}
+
+		// Winding of the sweep is measured with the opposite sign than in calculate_polygon_orientation,
+		// so its counter-clockwise triangles are the same as the ones of poly2tri.
+		scratch.triangles.clear();
+		Triangulation2::execute(scratch.border, holes, Orientation::CCW, vertices2D.data(), scratch.monotone, scratch.triangles);
+		validate_monotone_triangulation(scratch.border, holes, vertices2D.data(), scratch.triangles);
+
+		for(auto& iVertex : vertices2D)
+		{
+			outputVertices.push_back(RPS.unproject_point(iVertex, X_2D_INDEX, Y_2D_INDEX));
+		}
+
+		for(auto& iTriangle : scratch.triangles)
+		{
+			outputIndices.push_back(INDEX_OFFSET + iTriangle[0]);
+			outputIndices.push_back(INDEX_OFFSET + iTriangle[1]);
+			outputIndices.push_back(INDEX_OFFSET + iTriangle[2]);
+		}
+	}
+
+	/*
+		Triangulates polygon with holes and appends the result to the output, INDEX_OFFSET is added to the indices relative to the first added vertex.
+		Small polygons without holes are triangulated without the backend(see TriangulationSettings).
+		All algorithms produce triangles with the orientation of the polygons passed to poly2tri(Orientation::CW, see fill),
+		so they are flipped when the other one is requested.
+	*/
+	void						triangulate_polygon(const CoordinateSystem&					RPS,
+												const uint32_t								X_2D_INDEX,
+												const uint32_t								Y_2D_INDEX,
+												const TriangleMesh::Vertices2D&				BORDER_POLYGON,
+												const TriangleMesh::Vertices2DArray&		HOLE_POLYGONS,
+												const Orientation							TARGET_ORIENTATION,
+												const TriangleMesh::TriangulationSettings&	SETTINGS,
+												const uint32_t								INDEX_OFFSET,
+												TriangleMesh::TriangulationScratch::Buffers& scratch,
+												TriangleMesh::Vertices&						outputVertices,
+												TriangleMesh::Indices&						outputIndices)
+	{
+		const uint64_t FIRST_INDEX = outputIndices.size();
+
+		if(!HOLE_POLYGONS.empty() || !triangulate_small_polygon(RPS, X_2D_INDEX, Y_2D_INDEX, BORDER_POLYGON, SETTINGS, INDEX_OFFSET, outputVertices, outputIndices))
+		{
+			if(SETTINGS.backend == TriangleMesh::TriangulationBackend::MONOTONE)
+				triangulate_with_monotones(RPS, X_2D_INDEX, Y_2D_INDEX, BORDER_POLYGON, HOLE_POLYGONS, INDEX_OFFSET, scratch, outputVertices, outputIndices);
+			else
+				triangulate_with_CDT(RPS, X_2D_INDEX, Y_2D_INDEX, BORDER_POLYGON, HOLE_POLYGONS, INDEX_OFFSET, scratch, outputVertices, outputIndices);
+		}
+
+		if(TARGET_ORIENTATION != Orientation::CCW)
+			return;
+
+		for(uint64_t index = FIRST_INDEX; index < outputIndices.size(); index += 3)
+		{
+			std::swap(outputIndices[index + 1], outputIndices[index + 2]);
+		}
+	}
+
+//=====> TriangleMesh::TriangulationScratch -> public lifecycle
+	TriangleMesh::TriangulationScratch::TriangulationScratch()
+		: m_buffers(std::make_unique<Buffers>())
+	{
+
+	}
+
+	TriangleMesh::TriangulationScratch::~TriangulationScratch()
+	{
+
+	}
+
+//=====> TriangleMesh -> public functions
+	void		TriangleMesh::triangulate(		const CoordinateSystem& RPS,
+												const uint32_t			X_2D_INDEX,
+												const uint32_t			Y_2D_INDEX,
+												const Vertices2D&		BORDER_POLYGON,
+												const Vertices2DArray&	HOLE_POLYGONS,
+												const Orientation		TARGET_ORIENTATION,
+												const TriangulationSettings& SETTINGS)
+	{
+		TriangulationScratch	scratch;
+		Vertices				newVertices;
+		Indices					newIndices;
+
+		triangulate_polygon(RPS, X_2D_INDEX, Y_2D_INDEX, BORDER_POLYGON, HOLE_POLYGONS, TARGET_ORIENTATION, SETTINGS, 0, scratch.buffers(), newVertices, newIndices);
+
+		// Content is replaced only when triangulation succeeded.
+		*vertices	= std::move(newVertices);
+		*indices	= std::move(newIndices);
+	}
+
+	void		TriangleMesh::append_triangulation(const CoordinateSystem& RPS,
+												const uint32_t			X_2D_INDEX,
+												const uint32_t			Y_2D_INDEX,
+												const Vertices2D&		BORDER_POLYGON,
+												const Vertices2DArray&	HOLE_POLYGONS,
+												const Orientation		TARGET_ORIENTATION,
+												const TriangulationSettings& SETTINGS,
+												TriangulationScratch&	scratch)
+	{
+		const uint32_t NUM_VERTICES	= get_numVertices();
+		const uint32_t NUM_INDICES	= get_numIndices();
+
+		try
+		{
+			triangulate_polygon(RPS, X_2D_INDEX, Y_2D_INDEX, BORDER_POLYGON, HOLE_POLYGONS, TARGET_ORIENTATION, SETTINGS, NUM_VERTICES, scratch.buffers(), *vertices, *indices);
+		}
+		catch(...)
+		{
+			// Partially appended polygon is removed, capacity is kept.
+			vertices->resize(NUM_VERTICES);
+			indices->resize(NUM_INDICES);
+			throw;
+		}
+	}
+
+	std::vector<TriangleMesh::TriangulationRange> TriangleMesh::triangulate(const TriangulationJob* JOBS,
+												const uint32_t			NUM_JOBS,
+												const TriangulationSettings& SETTINGS)
+	{
+		// Results of the jobs are first written to the buffers of the worker that processed them.
+		struct	WorkerOutput
+		{
+			Vertices				vertices;
+			Indices					indices;
+			TriangulationScratch	scratch; // Reused by all jobs of the worker.
+		};
+
+		struct	JobOutput
+		{
+			uint32_t	workerID;
+			uint32_t	firstVertex;
+			uint32_t	firstIndex;
+		};
+
+		constexpr uint32_t GROUP_SIZE = 16;
+
+		const Vertices2DArray			NO_HOLES;
+		std::vector<WorkerOutput>		workerOutputs(get_numWorkers());
+		std::vector<JobOutput>			jobOutputs(NUM_JOBS);
+		std::vector<TriangulationRange>	ranges(NUM_JOBS);
+		std::atomic<uint32_t>			nextJob(0);
+
+		// Small groups of jobs are taken dynamically, because polygons differ in size.
+		parallel_for(0, get_numWorkers(), 1, [&](const uint32_t, const uint32_t, const uint32_t WORKER_ID)
+		{
+			auto& output = workerOutputs[WORKER_ID];
+
+			for(uint32_t first = nextJob.fetch_add(GROUP_SIZE); first < NUM_JOBS; first = nextJob.fetch_add(GROUP_SIZE))
+			{
+				for(uint32_t jobID = first; jobID < std::min(first + GROUP_SIZE, NUM_JOBS); ++jobID)
+				{
+					const auto& JOB = JOBS[jobID];
+					auto&		jobOutput = jobOutputs[jobID];
+
+					jobOutput.workerID		= WORKER_ID;
+					jobOutput.firstVertex	= static_cast<uint32_t>(output.vertices.size());
+					jobOutput.firstIndex	= static_cast<uint32_t>(output.indices.size());
+
+					triangulate_polygon(*JOB.rps, JOB.x2DIndex, JOB.y2DIndex, *JOB.border, JOB.holes ? *JOB.holes : NO_HOLES, JOB.targetOrientation, SETTINGS, 0, output.scratch.buffers(), output.vertices, output.indices);
+
+					ranges[jobID].numVertices	= static_cast<uint32_t>(output.vertices.size()) - jobOutput.firstVertex;
+					ranges[jobID].numIndices	= static_cast<uint32_t>(output.indices.size()) - jobOutput.firstIndex;
+				}
+			}
+		});
+
+		uint32_t numVertices	= 0;
+		uint32_t numIndices		= 0;
+
+		for(auto& iRange : ranges)
+		{
+			iRange.firstVertex	= numVertices;
+			iRange.firstIndex	= numIndices;
+			numVertices			+= iRange.numVertices;
+			numIndices			+= iRange.numIndices;
+		}
+
+		vertices->resize(numVertices);
+		indices->resize(numIndices);
+
+		// Results are gathered in the order of jobs.
+		parallel_for(0, NUM_JOBS, 256, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t)
+		{
+			for(uint32_t jobID = BEGIN; jobID < END; ++jobID)
+			{
+				const auto& RANGE		= ranges[jobID];
+				const auto& JOB_OUTPUT	= jobOutputs[jobID];
+				const auto& WORKER		= workerOutputs[JOB_OUTPUT.workerID];
+
+				std::copy_n(WORKER.vertices.begin() + JOB_OUTPUT.firstVertex, RANGE.numVertices, vertices->begin() + RANGE.firstVertex);
+
+				for(uint32_t i = 0; i < RANGE.numIndices; ++i)
+				{
+					(*indices)[RANGE.firstIndex + i] = WORKER.indices[JOB_OUTPUT.firstIndex + i] + RANGE.firstVertex;
+				}
+			}
+		});
+
+		return ranges;
+	}
+
+	void		TriangleMesh::validate_index_count() const
+	{
+		if(get_numIndices() % 3 != 0)
+			throw dpl::GeneralException(this, __LINE__, "Number of indices must be divisible by 3.");
+	}
+
+	void		TriangleMesh::validate_indices() const
+	{
+		validate_index_count();
+
+		const uint32_t NUM_VERTICES = get_numVertices();
+		for(auto& index : indices())
+		{
+			if(index >= NUM_VERTICES)
+				throw dpl::GeneralException(this, __LINE__, "TriangleMesh contains at least one invalid index.");
+		}
+	}
+
+	void		TriangleMesh::assign(			Vertices&&				newVertices,
+												Indices&&				newIndices)
+	{
+		if(newIndices.size() % 3 != 0)
+			throw dpl::GeneralException(this, __LINE__, "Number of indices must be divisible by 3.");
+
+		vertices	= std::move(newVertices);
+		indices		= std::move(newIndices);
+	}
+
+	void		TriangleMesh::extend(			const TriangleMesh&		OTHER,
+												const Mat4&				OTHER_TRANSFORMATION)
+	{
+		const Instance INSTANCE = {&OTHER, OTHER_TRANSFORMATION};
+		extend(&INSTANCE, 1);
+	}
+
+	void		TriangleMesh::extend(			const Instance*			INSTANCES,
+												const uint32_t			NUM_INSTANCES)
+	{
+		// Offsets of the instances in the output, sizes are read before resizing in case this mesh is one of the instances.
+		std::vector<uint32_t> vertexOffsets(NUM_INSTANCES + 1);
+		std::vector<uint32_t> indexOffsets(NUM_INSTANCES + 1);
+
+		vertexOffsets[0]	= get_numVertices();
+		indexOffsets[0]		= get_numIndices();
+
+		for(uint32_t instanceID = 0; instanceID < NUM_INSTANCES; ++instanceID)
+		{
+			vertexOffsets[instanceID + 1]	= vertexOffsets[instanceID] + INSTANCES[instanceID].mesh->get_numVertices();
+			indexOffsets[instanceID + 1]	= indexOffsets[instanceID] + INSTANCES[instanceID].mesh->get_numIndices();
+		}
+
+		vertices->resize(vertexOffsets[NUM_INSTANCES]);
+		indices->resize(indexOffsets[NUM_INSTANCES]);
+
+		// Batches can cover parts of many instances, so that large and small meshes are balanced.
+		auto process_range = [&](const std::vector<uint32_t>& OFFSETS, const uint32_t BEGIN, const uint32_t END, auto&& process_instance)
+		{
+			uint32_t instanceID = static_cast<uint32_t>(std::upper_bound(OFFSETS.begin(), OFFSETS.end(), BEGIN) - OFFSETS.begin()) - 1;
+
+			for(uint32_t first = BEGIN; first < END; ++instanceID)
+			{
+				const uint32_t LAST = std::min(OFFSETS[instanceID + 1], END);
+				process_instance(INSTANCES[instanceID], instanceID, first - OFFSETS[instanceID], first, LAST - first);
+				first = LAST;
+			}
+		};
+
+		Vec3* outputVertices = vertices->data();
+
+		parallel_for(vertexOffsets[0], vertexOffsets[NUM_INSTANCES], 16384, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t)
+		{
+			process_range(vertexOffsets, BEGIN, END, [&](const Instance& INSTANCE, const uint32_t, const uint32_t SOURCE, const uint32_t TARGET, const uint32_t COUNT)
+			{
+				const Mat4&	M		= INSTANCE.transformation;
+				const Vec3	X_AXIS	= Vec3(M[0]);
+				const Vec3	Y_AXIS	= Vec3(M[1]);
+				const Vec3	Z_AXIS	= Vec3(M[2]);
+				const Vec3	ORIGIN	= Vec3(M[3]);
+				const Vec3*	INPUT	= INSTANCE.mesh->vertices().data() + SOURCE;
+				Vec3*		output	= outputVertices + TARGET;
+
+				for(uint32_t i = 0; i < COUNT; ++i)
+				{
+					output[i] = ORIGIN + X_AXIS * INPUT[i].x + Y_AXIS * INPUT[i].y + Z_AXIS * INPUT[i].z;
+				}
+			});
+		});
+
+		uint32_t* outputIndices = indices->data();
+
+		parallel_for(indexOffsets[0], indexOffsets[NUM_INSTANCES], 16384, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t)
+		{
+			process_range(indexOffsets, BEGIN, END, [&](const Instance& INSTANCE, const uint32_t INSTANCE_ID, const uint32_t SOURCE, const uint32_t TARGET, const uint32_t COUNT)
+			{
+				const uint32_t	VERTEX_OFFSET	= vertexOffsets[INSTANCE_ID];
+				const uint32_t*	INPUT			= INSTANCE.mesh->indices().data() + SOURCE;
+				uint32_t*		output			= outputIndices + TARGET;
+
+				for(uint32_t i = 0; i < COUNT; ++i)
+				{
+					output[i] = INPUT[i] + VERTEX_OFFSET;
+				}
+			});
+		});
+	}
+
+	void		TriangleMesh::flip()
+	{
+		validate_index_count();
+
+		const uint32_t NUM_TRIANGLES = get_numIndices() / 3;
+
+		// Swap second and third vertex index of each triangle.
+		for(uint32_t triangleID = 0; triangleID < NUM_TRIANGLES; ++triangleID)
+		{
+			const uint32_t OFFSET = triangleID * 3;
+			std::swap((*indices)[OFFSET+1], (*indices)[OFFSET+2]);
+		}
+	}
+
+	uint32_t	TriangleMesh::weld(				const float				EPSILON)
+	{
+		validate_indices();
+
+		constexpr uint32_t NULL_INDEX = 0xFFFFFFFF;
+
+		const uint32_t	NUM_VERTICES	= get_numVertices();
+		const bool		EXACT			= EPSILON <= 0.f;
+		const float		INVERSE_SIZE	= EXACT ? 0.f : 1.f / EPSILON;
+		const float		SQUARED_EPSILON	= EXACT ? 0.f : EPSILON * EPSILON;
+		const int32_t	RANGE			= EXACT ? 0 : 1;
+
+		// Equal vertices share their bit pattern(negative zero is replaced with positive one),
+		// otherwise vertices are quantized into cells of EPSILON size and neighbouring cells are searched as well.
+		auto calculate_cell = [&](const Vec3& VERTEX)
+		{
+			if(!EXACT)
+				return IVec3(glm::floor(VERTEX * INVERSE_SIZE));
+
+			const Vec3	POSITIVE = VERTEX + Vec3(0.f, 0.f, 0.f);
+			IVec3		cell;
+			std::memcpy(&cell, &POSITIVE, sizeof(IVec3));
+			return cell;
+		};
+
+		// Kept vertices of each cell form singly linked list.
+		std::unordered_map<IVec3, uint32_t, WeldCellHash> heads;
+		heads.reserve(NUM_VERTICES);
+
+		std::vector<uint32_t> next(NUM_VERTICES, NULL_INDEX);
+		std::vector<uint32_t> remap(NUM_VERTICES);
+
+		auto find_representative = [&](const Vec3& VERTEX, const IVec3& CELL)
+		{
+			for(int32_t z = -RANGE; z <= RANGE; ++z)
+			{
+				for(int32_t y = -RANGE; y <= RANGE; ++y)
+				{
+					for(int32_t x = -RANGE; x <= RANGE; ++x)
+					{
+						auto it = heads.find(CELL + IVec3(x, y, z));
+						if(it == heads.end())
+							continue;
+
+						for(uint32_t other = it->second; other != NULL_INDEX; other = next[other])
+						{
+							const Vec3 TO_OTHER = vertices()[other] - VERTEX;
+							if(glm::dot(TO_OTHER, TO_OTHER) <= SQUARED_EPSILON)
+								return other;
+						}
+					}
+				}
+			}
+
+			return NULL_INDEX;
+		};
+
+		for(uint32_t vertexID = 0; vertexID < NUM_VERTICES; ++vertexID)
+		{
+			const Vec3&		VERTEX			= vertices()[vertexID];
+			const IVec3		CELL			= calculate_cell(VERTEX);
+			const uint32_t	REPRESENTATIVE	= find_representative(VERTEX, CELL);
+
+			if(REPRESENTATIVE != NULL_INDEX)
+			{
+				remap[vertexID] = REPRESENTATIVE;
+				continue;
+			}
+
+			auto& head			= heads.try_emplace(CELL, NULL_INDEX).first->second;
+			next[vertexID]		= head;
+			head				= vertexID;
+			remap[vertexID]		= vertexID;
+		}
+
+		// Triangles with repeated vertices are removed.
+		uint32_t numIndices = 0;
+
+		for(uint32_t offset = 0; offset < get_numIndices(); offset += 3)
+		{
+			const uint32_t AID = remap[indices()[offset+0]];
+			const uint32_t BID = remap[indices()[offset+1]];
+			const uint32_t CID = remap[indices()[offset+2]];
+
+			if(AID == BID || BID == CID || CID == AID)
+				continue;
+
+			(*indices)[numIndices++] = AID;
+			(*indices)[numIndices++] = BID;
+			(*indices)[numIndices++] = CID;
+		}
+
+		indices->resize(numIndices);
+
+		// Used vertices are moved to the front, new index is never greater than the old one.
+		std::vector<uint32_t>& compacted = next;
+		std::fill(compacted.begin(), compacted.end(), NULL_INDEX);
+
+		for(auto& index : indices())
+		{
+			compacted[index] = 0;
+		}
+
+		uint32_t numVertices = 0;
+
+		for(uint32_t vertexID = 0; vertexID < NUM_VERTICES; ++vertexID)
+		{
+			if(compacted[vertexID] == NULL_INDEX)
+				continue;
+
+			compacted[vertexID]				= numVertices;
+			(*vertices)[numVertices++]		= vertices()[vertexID];
+		}
+
+		vertices->resize(numVertices);
+
+		for(auto& index : *indices)
+		{
+			index = compacted[index];
+		}
+
+		return NUM_VERTICES - numVertices;
+	}
+
+	TriangleMesh::CacheStatistics	TriangleMesh::calculate_cacheStatistics(const uint32_t CACHE_SIZE) const
+	{
+		validate_indices();
+
+		const uint32_t NUM_VERTICES		= get_numVertices();
+		const uint32_t NUM_TRIANGLES	= get_numIndices() / 3;
+
+		FifoCache				cache(NUM_VERTICES, CACHE_SIZE);
+		std::vector<uint8_t>	used(NUM_VERTICES, 0);
+		uint32_t				numMisses		= 0;
+		uint32_t				numUsedVertices	= 0;
+
+		for(auto& index : indices())
+		{
+			numMisses		+= cache.access(index) ? 1 : 0;
+			numUsedVertices	+= used[index] ? 0 : 1;
+			used[index]		= 1;
+		}
+
+		CacheStatistics output;
+		output.acmr = (NUM_TRIANGLES > 0)	? static_cast<float>(numMisses) / NUM_TRIANGLES		: 0.f;
+		output.atvr = (numUsedVertices > 0)	? static_cast<float>(numMisses) / numUsedVertices	: 0.f;
+		return output;
+	}
+
+	void		TriangleMesh::optimize_vertexCache(const uint32_t			CACHE_SIZE)
+	{
+		const VertexAdjacency ADJACENCY = build_vertexAdjacency();
+
+		constexpr uint32_t NULL_INDEX = 0xFFFFFFFF;
+
+		const uint32_t NUM_VERTICES		= get_numVertices();
+		const uint32_t NUM_TRIANGLES	= get_numIndices() / 3;
+
+		// Number of triangles of each vertex that were not emitted yet.
+		std::vector<uint32_t> live(NUM_VERTICES);
+		for(uint32_t vertexID = 0; vertexID < NUM_VERTICES; ++vertexID)
+		{
+			live[vertexID] = ADJACENCY.offsets[vertexID + 1] - ADJACENCY.offsets[vertexID];
+		}
+
+		std::vector<uint32_t>	cacheTimes(NUM_VERTICES, 0);
+		std::vector<uint8_t>	emitted(NUM_TRIANGLES, 0);
+		std::vector<uint32_t>	deadEnd;
+		std::vector<uint32_t>	candidates;
+		Indices					output;
+
+		deadEnd.reserve(get_numIndices());
+		output.reserve(get_numIndices());
+
+		uint32_t time	= CACHE_SIZE + 1;
+		uint32_t cursor	= 0;
+
+		// Recently used vertex with remaining triangles or the next such vertex in the input order.
+		auto skip_dead_end = [&]()
+		{
+			while(!deadEnd.empty())
+			{
+				const uint32_t VERTEX_ID = deadEnd.back();
+				deadEnd.pop_back();
+
+				if(live[VERTEX_ID] > 0)
+					return VERTEX_ID;
+			}
+
+			for(; cursor < NUM_VERTICES; ++cursor)
+			{
+				if(live[cursor] > 0)
+					return cursor;
+			}
+
+			return NULL_INDEX;
+		};
+
+		for(uint32_t fan = skip_dead_end(); fan != NULL_INDEX;)
+		{
+			candidates.clear();
+
+			for(uint32_t i = ADJACENCY.offsets[fan]; i < ADJACENCY.offsets[fan + 1]; ++i)
+			{
+				const uint32_t TRIANGLE_ID = ADJACENCY.corners[i] / 3;
+				if(emitted[TRIANGLE_ID])
+					continue;
+
+				for(uint32_t offset = TRIANGLE_ID * 3; offset < TRIANGLE_ID * 3 + 3; ++offset)
+				{
+					const uint32_t VERTEX_ID = indices()[offset];
+
+					output.push_back(VERTEX_ID);
+					deadEnd.push_back(VERTEX_ID);
+					candidates.push_back(VERTEX_ID);
+					--live[VERTEX_ID];
+
+					if(time - cacheTimes[VERTEX_ID] > CACHE_SIZE)
+						cacheTimes[VERTEX_ID] = time++;
+				}
+
+				emitted[TRIANGLE_ID] = 1;
+			}
+
+			// Oldest candidate that will still be in the cache after emitting all its remaining triangles,
+			// candidates without positive priority are left for the dead-end stack.
+			uint32_t nextFan		= NULL_INDEX;
+			int64_t	 bestPriority	= 0;
+
+			for(auto& iCandidate : candidates)
+			{
+				if(live[iCandidate] == 0)
+					continue;
+
+				const uint32_t	AGE			= time - cacheTimes[iCandidate];
+				const int64_t	PRIORITY	= (AGE + 2 * live[iCandidate] <= CACHE_SIZE) ? AGE : 0;
+
+				if(PRIORITY > bestPriority)
+				{
+					bestPriority	= PRIORITY;
+					nextFan			= iCandidate;
+				}
+			}
+
+			fan = (nextFan != NULL_INDEX) ? nextFan : skip_dead_end();
+		}
+
+		indices->swap(output);
+	}
+
+	void		TriangleMesh::optimize_overdraw(const uint32_t			CACHE_SIZE)
+	{
+		validate_indices();
+
+		const uint32_t NUM_TRIANGLES = get_numIndices() / 3;
+		if(NUM_TRIANGLES == 0)
+			return;
+
+		// Cluster starts with the triangle whose vertices are all missing from the cache.
+		FifoCache				cache(get_numVertices(), CACHE_SIZE);
+		std::vector<uint32_t>	clusters;
+
+		for(uint32_t triangleID = 0; triangleID < NUM_TRIANGLES; ++triangleID)
+		{
+			uint32_t numMisses = 0;
+
+			for(uint32_t offset = triangleID * 3; offset < triangleID * 3 + 3; ++offset)
+			{
+				numMisses += cache.access(indices()[offset]) ? 1 : 0;
+			}
+
+			if(numMisses == 3)
+				clusters.push_back(triangleID);
+		}
+
+		clusters.push_back(NUM_TRIANGLES);
+
+		const uint32_t NUM_CLUSTERS = static_cast<uint32_t>(clusters.size()) - 1;
+
+		// Area weighted centroids and normals, length of the cross product is twice the area of the triangle.
+		std::vector<Vec3>	centroids(NUM_CLUSTERS, Vec3(0.f, 0.f, 0.f));
+		std::vector<Vec3>	normals(NUM_CLUSTERS, Vec3(0.f, 0.f, 0.f));
+		std::vector<float>	areas(NUM_CLUSTERS, 0.f);
+		Vec3				meshCentroid(0.f, 0.f, 0.f);
+		float				meshArea = 0.f;
+
+		for(uint32_t clusterID = 0; clusterID < NUM_CLUSTERS; ++clusterID)
+		{
+			for(uint32_t triangleID = clusters[clusterID]; triangleID < clusters[clusterID + 1]; ++triangleID)
+			{
+				const Vec3& A = vertices()[indices()[triangleID * 3 + 0]];
+				const Vec3& B = vertices()[indices()[triangleID * 3 + 1]];
+				const Vec3& C = vertices()[indices()[triangleID * 3 + 2]];
+
+				const Vec3	CROSS	= glm::cross(B - A, C - A);
+				const float AREA	= glm::length(CROSS);
+
+				centroids[clusterID]	+= (A + B + C) * (AREA / 3.f);
+				normals[clusterID]		+= CROSS;
+				areas[clusterID]		+= AREA;
+			}
+
+			meshCentroid	+= centroids[clusterID];
+			meshArea		+= areas[clusterID];
+		}
+
+		if(meshArea > 0.f)
+			meshCentroid /= meshArea;
+
+		// Clusters facing away from the center of the mesh are drawn first.
+		std::vector<float> sortKeys(NUM_CLUSTERS, 0.f);
+
+		for(uint32_t clusterID = 0; clusterID < NUM_CLUSTERS; ++clusterID)
+		{
+			const float NORMAL_LENGTH = glm::length(normals[clusterID]);
+			if(areas[clusterID] <= 0.f || NORMAL_LENGTH <= 0.f)
+				continue;
+
+			const Vec3 CENTROID = centroids[clusterID] / areas[clusterID];
+			sortKeys[clusterID] = glm::dot(CENTROID - meshCentroid, normals[clusterID]) / NORMAL_LENGTH;
+		}
+
+		std::vector<uint32_t> order(NUM_CLUSTERS);
+		for(uint32_t clusterID = 0; clusterID < NUM_CLUSTERS; ++clusterID)
+		{
+			order[clusterID] = clusterID;
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&](const uint32_t A, const uint32_t B)
+		{
+			return sortKeys[A] > sortKeys[B];
+		});
+
+		Indices output;
+		output.reserve(get_numIndices());
+
+		for(auto& iCluster : order)
+		{
+			output.insert(output.end(), indices().begin() + clusters[iCluster] * 3, indices().begin() + clusters[iCluster + 1] * 3);
+		}
+
+		indices->swap(output);
+	}
+
+	std::vector<uint32_t> TriangleMesh::optimize_vertexFetch()
+	{
+		validate_indices();
+
+		constexpr uint32_t NULL_INDEX = 0xFFFFFFFF;
+
+		const uint32_t NUM_VERTICES = get_numVertices();
+
+		std::vector<uint32_t>	remap(NUM_VERTICES, NULL_INDEX);
+		uint32_t				numVertices = 0;
+
+		for(auto& index : *indices)
+		{
+			if(remap[index] == NULL_INDEX)
+				remap[index] = numVertices++;
+
+			index = remap[index];
+		}
+
+		for(auto& iNewIndex : remap)
+		{
+			if(iNewIndex == NULL_INDEX)
+				iNewIndex = numVertices++;
+		}
+
+		Vertices output(NUM_VERTICES);
+		for(uint32_t vertexID = 0; vertexID < NUM_VERTICES; ++vertexID)
+		{
+			output[remap[vertexID]] = vertices()[vertexID];
+		}
+
+		vertices->swap(output);
+		return remap;
+	}
+
+	void		TriangleMesh::generate_normals(	Vec3*					output) const
+	{
+		validate_indices();
+
+		const uint32_t NUM_VERTICES		= get_numVertices();
+		const uint32_t NUM_TRIANGLES	= get_numIndices() / 3;
+
+		for(uint32_t triangleID = 0; triangleID < NUM_TRIANGLES; ++triangleID)
+		{
+			const uint32_t OFFSET = triangleID * 3;
+			const uint32_t AID = indices()[OFFSET+0];
+			const uint32_t BID = indices()[OFFSET+1];
+			const uint32_t CID = indices()[OFFSET+2];
+
+			auto& A = vertices()[AID];
+			auto& B = vertices()[BID];
+			auto& C = vertices()[CID];
+
+			const Vec3 AB	= glm::normalize(B-A);
+			const Vec3 AC	= glm::normalize(C-A);
+			const Vec3 N	= glm::normalize(glm::cross(AB, AC));
+
+			output[AID] += N;
+			output[BID] += N;
+			output[CID] += N;
+		}
+
+		for(uint32_t vertexID = 0; vertexID < NUM_VERTICES; ++vertexID)
+		{
+			auto&	normal = output[vertexID];
+					normal = glm::normalize(normal);
+		}
+	}
+
+	TriangleMesh::VertexAdjacency	TriangleMesh::build_vertexAdjacency() const
+	{
+		validate_indices();
+
+		const uint32_t NUM_VERTICES = get_numVertices();
+		const uint32_t NUM_INDICES	= get_numIndices();
+
+		VertexAdjacency output;
+		output.offsets.assign(NUM_VERTICES + 1, 0);
+		output.corners.resize(NUM_INDICES);
+
+		// Counting sort of corners by their vertex.
+		for(auto& index : indices())
+		{
+			++output.offsets[index + 1];
+		}
+
+		for(uint32_t vertexID = 0; vertexID < NUM_VERTICES; ++vertexID)
+		{
+			output.offsets[vertexID + 1] += output.offsets[vertexID];
+		}
+
+		std::vector<uint32_t> cursors(output.offsets.begin(), output.offsets.end() - 1);
+
+		for(uint32_t corner = 0; corner < NUM_INDICES; ++corner)
+		{
+			output.corners[cursors[indices()[corner]]++] = corner;
+		}
+
+		return output;
+	}
+
+	void		TriangleMesh::generate_normals(	const VertexAdjacency&	ADJACENCY,
+												const NormalWeighting	WEIGHTING,
+												Vec3*					output) const
+	{
+		if(ADJACENCY.offsets.size() != get_numVertices() + 1 || ADJACENCY.corners.size() != get_numIndices())
+			throw dpl::GeneralException(this, __LINE__, "Adjacency does not match the mesh.");
+
+		const Vec3*		VERTICES	= vertices().data();
+		const uint32_t*	INDICES		= indices().data();
+
+		parallel_for(0, get_numVertices(), 4096, [&](const uint32_t BEGIN, const uint32_t END, const uint32_t)
+		{
+			for(uint32_t vertexID = BEGIN; vertexID < END; ++vertexID)
+			{
+				Vec3 normal(0.f, 0.f, 0.f);
+
+				for(uint32_t i = ADJACENCY.offsets[vertexID]; i < ADJACENCY.offsets[vertexID + 1]; ++i)
+				{
+					// Edges leaving the vertex in the winding order of its triangle.
+					const uint32_t	CORNER		= ADJACENCY.corners[i];
+					const uint32_t	FIRST		= CORNER - CORNER % 3;
+					const Vec3&		A			= VERTICES[INDICES[CORNER]];
+					const Vec3		AB			= VERTICES[INDICES[FIRST + (CORNER + 1) % 3]] - A;
+					const Vec3		AC			= VERTICES[INDICES[FIRST + (CORNER + 2) % 3]] - A;
+					const Vec3		CROSS		= glm::cross(AB, AC); // Length is twice the area of the triangle.
+					const float		LENGTH		= glm::length(CROSS);
+
+					if(LENGTH <= 0.f)
+						continue; // Degenerated triangle.
+
+					switch(WEIGHTING)
+					{
+					case NormalWeighting::UNIFORM:	normal += CROSS / LENGTH; break;
+					case NormalWeighting::AREA:		normal += CROSS; break;
+					case NormalWeighting::ANGLE:	normal += CROSS * (glm::atan(LENGTH, glm::dot(AB, AC)) / LENGTH); break;
+					}
+				}
+
+				const float LENGTH = glm::length(normal);
+				output[vertexID] = (LENGTH > 0.f) ? normal / LENGTH : Vec3(0.f, 0.f, 0.f);
+			}
+		});
 	}
 }
\ No newline at end of file
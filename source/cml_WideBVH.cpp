@@ -0,0 +1,144 @@
+#include "../include/cml_WideBVH.h"
+
+
+namespace cml
+{
+	inline float	calculate_node_area(	const BVH::Node&	NODE)
+	{
+		const Vec3 SIZE = NODE.max - NODE.min;
+		return SIZE.x * SIZE.y + SIZE.y * SIZE.z + SIZE.z * SIZE.x;
+	}
+
+
+//=====> WideBVH -> public functions
+	template<uint32_t WIDTH>
+	void		WideBVH<WIDTH>::clear()
+	{
+		m_nodes.clear();
+		m_indices.clear();
+	}
+
+	template<uint32_t WIDTH>
+	void		WideBVH<WIDTH>::build(			const BVH&			BINARY)
+	{
+		clear();
+
+		if(BINARY.empty())
+			return;
+
+		m_indices.assign(BINARY.indices(), BINARY.indices() + BINARY.get_numPrimitives());
+
+		// Every wide node replaces at least one internal binary node.
+		m_nodes.reserve(BINARY.get_numNodes() / 2 + 1);
+
+		const BVH::Node& ROOT = BINARY.nodes()[0];
+
+		if(ROOT.is_leaf())
+		{
+			Node& root = m_nodes.emplace_back();
+			set_lane(root, 0, ROOT, ROOT.leftFirst);
+
+			for(uint32_t lane = 1; lane < WIDTH; ++lane)
+			{
+				clear_lane(root, lane);
+			}
+		}
+		else
+		{
+			collapse(BINARY, 0);
+		}
+	}
+
+//=====> WideBVH -> private functions
+	template<uint32_t WIDTH>
+	uint32_t	WideBVH<WIDTH>::collapse(		const BVH&			BINARY,
+												const uint32_t		BINARY_NODE_ID)
+	{
+		const BVH::Node*	BINARY_NODES	= BINARY.nodes();
+		const uint32_t		NODE_ID			= static_cast<uint32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+
+		uint32_t candidates[WIDTH];
+		uint32_t numCandidates = 2;
+		candidates[0] = BINARY_NODES[BINARY_NODE_ID].leftFirst;
+		candidates[1] = BINARY_NODES[BINARY_NODE_ID].leftFirst + 1;
+
+		// Open the largest child node until all lanes are used.
+		while(numCandidates < WIDTH)
+		{
+			uint32_t	largest		= WIDTH;
+			float		largestArea	= -1.f;
+
+			for(uint32_t i = 0; i < numCandidates; ++i)
+			{
+				const BVH::Node& CANDIDATE = BINARY_NODES[candidates[i]];
+
+				if(!CANDIDATE.is_leaf() && calculate_node_area(CANDIDATE) > largestArea)
+				{
+					largest		= i;
+					largestArea	= calculate_node_area(CANDIDATE);
+				}
+			}
+
+			if(largest == WIDTH)
+				break; // Only leaves left.
+
+			const uint32_t LEFT_ID = BINARY_NODES[candidates[largest]].leftFirst;
+			candidates[largest]				= LEFT_ID;
+			candidates[numCandidates++]		= LEFT_ID + 1;
+		}
+
+		for(uint32_t lane = 0; lane < numCandidates; ++lane)
+		{
+			const BVH::Node&	CHILD	= BINARY_NODES[candidates[lane]];
+			const uint32_t		TARGET	= CHILD.is_leaf() ? CHILD.leftFirst : collapse(BINARY, candidates[lane]);
+
+			// Recursion may reallocate the nodes, so node is accessed by index.
+			set_lane(m_nodes[NODE_ID], lane, CHILD, TARGET);
+		}
+
+		for(uint32_t lane = numCandidates; lane < WIDTH; ++lane)
+		{
+			clear_lane(m_nodes[NODE_ID], lane);
+		}
+
+		return NODE_ID;
+	}
+
+	template<uint32_t WIDTH>
+	void		WideBVH<WIDTH>::set_lane(		Node&				node,
+												const uint32_t		LANE,
+												const BVH::Node&	BINARY_NODE,
+												const uint32_t		CHILD)
+	{
+		node.minX[LANE]		= BINARY_NODE.min.x;
+		node.minY[LANE]		= BINARY_NODE.min.y;
+		node.minZ[LANE]		= BINARY_NODE.min.z;
+		node.maxX[LANE]		= BINARY_NODE.max.x;
+		node.maxY[LANE]		= BINARY_NODE.max.y;
+		node.maxZ[LANE]		= BINARY_NODE.max.z;
+		node.children[LANE]	= CHILD;
+		node.counts[LANE]	= BINARY_NODE.count;
+	}
+
+	template<uint32_t WIDTH>
+	void		WideBVH<WIDTH>::clear_lane(		Node&				node,
+												const uint32_t		LANE)
+	{
+		// Both bounds at positive infinity, so that slab distances of the lane never overlap and sphere distance is infinite.
+		const float INF = std::numeric_limits<float>::infinity();
+
+		node.minX[LANE]		= INF;
+		node.minY[LANE]		= INF;
+		node.minZ[LANE]		= INF;
+		node.maxX[LANE]		= INF;
+		node.maxY[LANE]		= INF;
+		node.maxZ[LANE]		= INF;
+		node.children[LANE]	= EMPTY_LANE;
+		node.counts[LANE]	= 0;
+	}
+
+
+	template class WideBVH<4>;
+	template class WideBVH<8>;
+}
\ No newline at end of file